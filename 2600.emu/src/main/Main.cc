@@ -223,6 +223,36 @@ void EmuSystem::loadState(IG::CStringView path)
 	updateSwitchValues();
 }
 
+size_t EmuSystem::stateSize()
+{
+	Serializer state;
+	if(!osystem->state().saveState(state))
+	{
+		throwFileWriteError();
+	}
+	return state.size();
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	Serializer state{buff, Serializer::Mode::ReadWrite};
+	if(!osystem->state().saveState(state))
+	{
+		throwFileWriteError();
+	}
+	return state.writePosition();
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	Serializer state{{const_cast<uint8_t*>(buff.data()), buff.size()}, Serializer::Mode::ReadOnly};
+	if(!osystem->state().loadState(state))
+	{
+		throwFileReadError();
+	}
+	updateSwitchValues();
+}
+
 void EmuApp::onCustomizeNavView(EmuApp::NavView &view)
 {
 	const Gfx::LGradientStopDesc navViewGrad[] =
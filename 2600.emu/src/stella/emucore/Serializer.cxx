@@ -20,6 +20,7 @@
 #include <imagine/base/ApplicationContext.hh>
 #include <imagine/io/IOStream.hh>
 #include <imagine/io/FileIO.hh>
+#include <imagine/io/MapIO.hh>
 
 using std::ios;
 using std::ios_base;
@@ -87,6 +88,14 @@ Serializer::Serializer()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Serializer::Serializer(std::span<uint8_t> buff, Mode m)
+  : myStream{make_unique<IG::IOStream<IG::MapIO>>(IG::MapIO{IG::ByteBuffer{buff}},
+      m == Mode::ReadOnly ? ios::in : ios::out)}
+{
+  myStream->exceptions( ios_base::failbit | ios_base::badbit | ios_base::eofbit );
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::setPosition(size_t pos)
 {
@@ -115,6 +124,12 @@ size_t Serializer::size()
   return s;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t Serializer::writePosition()
+{
+  return myStream->tellp();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 Serializer::getByte() const
 {
@@ -26,6 +26,9 @@
 #include <imagine/fs/FS.hh>
 #include <imagine/util/format.hh>
 #include <imagine/util/string.h>
+#include <imagine/io/MapIO.hh>
+#include <imagine/io/FileStream.hh>
+#include <emuframework/StateWriteIO.hh>
 #include <sys/time.h>
 
 extern "C"
@@ -83,6 +86,7 @@ IG::PixelFormat pixFmt{};
 
 bool EmuSystem::hasPALVideoSystem = true;
 bool EmuSystem::hasResetModes = true;
+bool EmuSystem::hasSeamlessMemoryStates = false;
 bool EmuSystem::handlesGenericIO = false;
 
 static void execC64Frame();
@@ -264,27 +268,36 @@ FS::FileString EmuSystem::stateFilename(int slot, std::string_view name)
 struct SnapshotTrapData
 {
 	const char *pathStr{};
+	FILE *stream{}; // used instead of pathStr for in-memory states
 	bool hasError = true;
 };
 
 static void loadSnapshotTrap(uint16_t, void *data)
 {
 	auto snapData = (SnapshotTrapData*)data;
-	logMsg("loading state: %s", snapData->pathStr);
+	if(!snapData->stream)
+		logMsg("loading state: %s", snapData->pathStr);
+	plugin.snapshot_set_stream(snapData->stream);
 	if(plugin.machine_read_snapshot(snapData->pathStr, 0) < 0)
 		snapData->hasError = true;
 	else
 		snapData->hasError = false;
+	plugin.snapshot_set_stream(nullptr);
 }
 
 static void saveSnapshotTrap(uint16_t, void *data)
 {
 	auto snapData = (SnapshotTrapData*)data;
-	logMsg("saving state: %s", snapData->pathStr);
-	if(plugin.machine_write_snapshot(snapData->pathStr, 1, 1, 0) < 0)
+	if(!snapData->stream)
+		logMsg("saving state: %s", snapData->pathStr);
+	plugin.snapshot_set_stream(snapData->stream);
+	// ROMs don't change during a session so in-memory states skip them
+	bool saveRoms = !snapData->stream;
+	if(plugin.machine_write_snapshot(snapData->pathStr, saveRoms, 1, 0) < 0)
 		snapData->hasError = true;
 	else
 		snapData->hasError = false;
+	plugin.snapshot_set_stream(nullptr);
 }
 
 void EmuSystem::saveState(IG::CStringView path)
@@ -312,6 +325,56 @@ void EmuSystem::loadState(IG::CStringView path)
 		return throwFileReadError();
 }
 
+// In-memory states also go through a CPU trap, so the state is captured/restored at
+// the start of the next frame and that frame is executed with video & audio skipped.
+// Since that advances the machine, hasSeamlessMemoryStates is false.
+static size_t lastSnapshotSize{};
+
+static bool writeSnapshotStream(std::span<uint8_t> buff, size_t &size)
+{
+	lastSnapshotSize = 0;
+	IG::FileStream<StateWriteIO> stream{StateWriteIO{buff}, "wb"};
+	SnapshotTrapData data{.pathStr{""}, .stream{stream.filePtr()}};
+	plugin.interrupt_maincpu_trigger_trap(saveSnapshotTrap, (void*)&data);
+	setCanvasSkipFrame(true);
+	execC64Frame(); // execute cpu trap
+	if(data.hasError || fflush(stream.filePtr()) != 0 || ferror(stream.filePtr()))
+		return false;
+	size = static_cast<StateWriteIO&>(stream).size();
+	lastSnapshotSize = size;
+	return true;
+}
+
+size_t EmuSystem::stateSize()
+{
+	// measuring runs a frame, so reuse the size of the last saved state if there is one
+	if(lastSnapshotSize)
+		return lastSnapshotSize;
+	size_t size{};
+	if(!writeSnapshotStream({}, size))
+		throwFileWriteError();
+	return size;
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	size_t size{};
+	if(!writeSnapshotStream(buff, size))
+		throwFileWriteError();
+	return size;
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	IG::FileStream<IG::MapIO> stream{IG::MapIO{IG::ByteBuffer{{const_cast<uint8_t*>(buff.data()), buff.size()}}}, "rb"};
+	SnapshotTrapData data{.pathStr{""}, .stream{stream.filePtr()}};
+	plugin.interrupt_maincpu_trigger_trap(loadSnapshotTrap, (void*)&data);
+	setCanvasSkipFrame(true);
+	execC64Frame(); // execute cpu trap
+	if(data.hasError)
+		throwFileReadError();
+}
+
 void EmuSystem::saveBackupMem(IG::ApplicationContext)
 {
 	if(gameIsRunning())
@@ -329,6 +392,7 @@ void EmuSystem::closeSystem(IG::ApplicationContext ctx)
 		return;
 	}
 	saveBackupMem(ctx);
+	lastSnapshotSize = 0;
 	plugin.vsync_set_warp_mode(0);
 	if(intResource("REU"))
 	{
@@ -583,7 +647,8 @@ bool EmuSystem::onVideoRenderFormatChange(EmuVideo &, IG::PixelFormat fmt)
 
 void EmuSystem::onInit(IG::ApplicationContext ctx)
 {
-	IG::makeDetachedThread(
+	// VICE runs its own main loop on this thread instead of EmuSystemTask's
+	IG::makeDetachedThread(EmuApp::emuThreadAttributes(),
 		[]()
 		{
 			execSem.acquire();
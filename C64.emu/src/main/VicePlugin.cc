@@ -177,6 +177,12 @@ int VicePlugin::machine_read_snapshot(const char *name, int event_mode)
 	return -1;
 }
 
+void VicePlugin::snapshot_set_stream(FILE *f)
+{
+	if(snapshot_set_stream_)
+		snapshot_set_stream_(f);
+}
+
 void VicePlugin::machine_set_restore_key(int v)
 {
 	if(machine_set_restore_key_)
@@ -403,6 +409,7 @@ VicePlugin commonVicePlugin(void *lib, ViceSystem system)
 	loadSymbolCheck(plugin.resources_get_default_value_, lib, "resources_get_default_value");
 	loadSymbolCheck(plugin.machine_write_snapshot_, lib, "machine_write_snapshot");
 	loadSymbolCheck(plugin.machine_read_snapshot_, lib, "machine_read_snapshot");
+	loadSymbolCheck(plugin.snapshot_set_stream_, lib, "snapshot_set_stream");
 	loadSymbolCheck(plugin.machine_set_restore_key_, lib, "machine_set_restore_key");
 	loadSymbolCheck(plugin.machine_trigger_reset_, lib, "machine_trigger_reset");
 	loadSymbolCheck(plugin.interrupt_maincpu_trigger_trap_, lib, "interrupt_maincpu_trigger_trap");
@@ -60,6 +60,10 @@ static char *current_machine_name = NULL;
 static char *current_filename = NULL;
 static size_t current_fpos = 0;
 
+/* When set, snapshot_create() and snapshot_open() use this stream instead of
+   opening the given filename, and snapshot_close() leaves it open.  */
+static FILE *snapshot_stream = NULL;
+
 static const char snapshot_magic_string[] = "VICE Snapshot File\032";
 static const char snapshot_version_magic_string[] = "VICE Version\032";
 
@@ -805,7 +809,7 @@ snapshot_t *snapshot_create(const char *filename, uint8_t major_version, uint8_t
 
     current_filename = (char *)filename;
 
-    f = fopen(filename, MODE_WRITE);
+    f = snapshot_stream ? snapshot_stream : fopen(filename, MODE_WRITE);
     if (f == NULL) {
         snapshot_error = SNAPSHOT_CANNOT_CREATE_SNAPSHOT_ERROR;
         return NULL;
@@ -857,8 +861,10 @@ snapshot_t *snapshot_create(const char *filename, uint8_t major_version, uint8_t
     return s;
 
 fail:
-    fclose(f);
-    ioutil_remove(filename);
+    if (f != snapshot_stream) {
+        fclose(f);
+        ioutil_remove(filename);
+    }
     return NULL;
 }
 
@@ -878,7 +884,7 @@ snapshot_t *snapshot_open(const char *filename, uint8_t *major_version_return, u
     current_filename = (char *)filename;
     current_module = NULL;
 
-    f = zfile_fopen(filename, MODE_READ);
+    f = snapshot_stream ? snapshot_stream : zfile_fopen(filename, MODE_READ);
     if (f == NULL) {
         snapshot_error = SNAPSHOT_CANNOT_OPEN_FOR_READ_ERROR;
         return NULL;
@@ -944,7 +950,9 @@ snapshot_t *snapshot_open(const char *filename, uint8_t *major_version_return, u
     return s;
 
 fail:
-    fclose(f);
+    if (f != snapshot_stream) {
+        fclose(f);
+    }
     return NULL;
 }
 
@@ -952,7 +960,14 @@ int snapshot_close(snapshot_t *s)
 {
     int retval;
 
-    if (!s->write_mode) {
+    if (s->file == snapshot_stream) {
+        if (s->write_mode && (fflush(s->file) == EOF || ferror(s->file))) {
+            snapshot_error = SNAPSHOT_WRITE_CLOSE_EOF_ERROR;
+            retval = -1;
+        } else {
+            retval = 0;
+        }
+    } else if (!s->write_mode) {
         if (zfile_fclose(s->file) == EOF) {
             snapshot_error = SNAPSHOT_READ_CLOSE_EOF_ERROR;
             retval = -1;
@@ -972,6 +987,11 @@ int snapshot_close(snapshot_t *s)
     return retval;
 }
 
+void snapshot_set_stream(FILE *f)
+{
+    snapshot_stream = f;
+}
+
 static void display_error_with_vice_version(char *text, char *filename)
 {
     char *vmessage = lib_malloc(0x100);
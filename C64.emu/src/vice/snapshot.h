@@ -29,6 +29,7 @@
 #define SNAPSHOT_H
 
 #include "types.h"
+#include <stdio.h>
 
 #define SNAPSHOT_MACHINE_NAME_LEN       16
 #define SNAPSHOT_MODULE_NAME_LEN        16
@@ -163,6 +164,7 @@ extern snapshot_t *snapshot_open(const char *filename,
                                  uint8_t *minor_version_return,
                                  const char *snapshot_machine_name);
 extern int snapshot_close(snapshot_t *s);
+extern void snapshot_set_stream(FILE *f);
 
 extern void snapshot_set_error(int error);
 extern int snapshot_get_error(void);
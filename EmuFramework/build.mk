@@ -12,11 +12,17 @@ ConfigFile.cc \
 CreditsView.cc \
 EmuApp.cc \
 EmuAudio.cc \
+EmuBenchmark.cc \
+EmuContentCache.cc \
+EmuFrameTimingStats.cc \
 EmuInput.cc \
+EmuInputQueue.cc \
 EmuInputView.cc \
 EmuLoadProgressView.cc \
 EmuMainMenuView.cc \
 EmuOptions.cc \
+EmuRewinder.cc \
+EmuScreenshotWriter.cc \
 EmuSystemActionsView.cc \
 EmuSystem.cc \
 EmuSystemTask.cc \
@@ -21,6 +21,10 @@
 #include <emuframework/EmuAudio.hh>
 #include <emuframework/EmuVideo.hh>
 #include <emuframework/EmuVideoLayer.hh>
+#include <emuframework/EmuRewinder.hh>
+#include <emuframework/EmuScreenshotWriter.hh>
+#include <emuframework/EmuFrameTimingStats.hh>
+#include <emuframework/EmuInputQueue.hh>
 #include <emuframework/EmuViewController.hh>
 #include <emuframework/EmuInput.hh>
 #include <emuframework/VController.hh>
@@ -177,8 +181,14 @@ public:
 	static std::unique_ptr<View> makeView(ViewAttachParams, ViewID);
 	void applyOSNavStyle(IG::ApplicationContext, bool inGame);
 	void setCPUNeedsLowLatency(IG::ApplicationContext, bool needed);
+	static IG::ThreadAttributes emuThreadAttributes();
+	static IG::ThreadAttributes renderThreadAttributes();
+	// updates the running emulation & render threads from their options
+	void applyThreadAttributes();
 	void runFrames(EmuSystemTaskContext, EmuVideo *, EmuAudio *, int frames, bool skipForward);
 	void skipFrames(EmuSystemTaskContext, uint32_t frames, EmuAudio *);
+	void runFrameWithRunAhead(EmuSystemTaskContext, EmuVideo &, EmuAudio *, int aheadFrames);
+	void disableRunAhead();
 	bool skipForwardFrames(EmuSystemTaskContext, uint32_t frames);
 	IG::Audio::Manager &audioManager();
 	bool setWindowDrawableConfig(Gfx::DrawableConfig);
@@ -192,8 +202,12 @@ public:
 	void setViewportZoom(uint8_t val);
 	void setOverlayEffectLevel(EmuVideoLayer &, uint8_t val);
 	void setVideoAspectRatio(double val);
-	bool writeScreenshot(IG::Pixmap, IG::CStringView path);
-	std::pair<int, FS::PathString> makeNextScreenshotFilename();
+	EmuScreenshotWriter &screenshotWriter() { return screenshotWriter_; }
+	EmuFrameTimingStats &frameTimingStats() { return frameTimingStats_; }
+	// maps device key events on the main loop & queues them for the emulation thread,
+	// bypassing view dispatch, only supported with evdev devices
+	void setDirectKeyInput(bool on);
+	EmuInputQueue &directInputQueue() { return directInputQueue_; }
 	bool mogaManagerIsActive() const;
 	void setMogaManagerActive(bool on, bool notify);
 	constexpr IG::VibrationManager &vibrationManager() { return vibrationManager_; }
@@ -221,6 +235,12 @@ public:
 	Byte1Option &confirmAutoLoadStateOption() { return optionConfirmAutoLoadState; }
 	Byte1Option &confirmOverwriteStateOption() { return optionConfirmOverwriteState; }
 	Byte1Option &fastForwardSpeedOption() { return optionFastForwardSpeed; }
+	Byte1Option &rewindBufferSizeOption() { return optionRewindBufferSize; }
+	Byte1Option &rewindFrameIntervalOption() { return optionRewindFrameInterval; }
+	Byte1Option &runAheadFramesOption() { return optionRunAheadFrames; }
+	EmuRewinder &rewinder() { return emuRewinder; }
+	void configRewinder();
+	void clearRunAheadState() { runAheadState = {}; }
 	IG::ApplicationContext appContext() const;
 	static EmuApp &get(IG::ApplicationContext);
 
@@ -323,6 +343,7 @@ protected:
 	EmuVideo emuVideo{};
 	EmuVideoLayer emuVideoLayer;
 	EmuSystemTask emuSystemTask;
+	EmuRewinder emuRewinder;
 	mutable Gfx::PixmapTexture assetBuffImg[(unsigned)AssetID::END]{};
 	#ifdef CONFIG_EMUFRAMEWORK_VCONTROLS
 	VController vController;
@@ -337,6 +358,9 @@ protected:
 	FS::PathString contentSearchPath_{};
 	[[no_unique_address]] IG::Data::PixmapReader pixmapReader;
 	[[no_unique_address]] IG::Data::PixmapWriter pixmapWriter;
+	EmuScreenshotWriter screenshotWriter_;
+	EmuFrameTimingStats frameTimingStats_;
+	EmuInputQueue directInputQueue_;
 	[[no_unique_address]] IG::VibrationManager vibrationManager_;
 	#ifdef CONFIG_BLUETOOTH
 	BluetoothAdapter *bta{};
@@ -349,6 +373,10 @@ protected:
 	Byte1Option optionConfirmAutoLoadState;
 	Byte1Option optionConfirmOverwriteState;
 	Byte1Option optionFastForwardSpeed;
+	Byte1Option optionRewindBufferSize;
+	Byte1Option optionRewindFrameInterval;
+	Byte1Option optionRunAheadFrames;
+	std::vector<uint8_t> runAheadState{};
 	Gfx::DrawableConfig windowDrawableConf{};
 	IG::PixelFormat renderPixelFmt{};
 	bool showHiddenFilesInPicker_{};
@@ -16,6 +16,7 @@
 	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
 
 #include <imagine/audio/OutputStream.hh>
+#include <imagine/audio/Resampler.hh>
 #include <imagine/time/Time.hh>
 #include <imagine/vmem/RingBuffer.hh>
 #include <memory>
@@ -37,9 +38,17 @@ public:
 		BUFFER,
 		ACTIVE,
 		UNDERRUN,
-		MULTI_UNDERRUN
 	};
 
+	struct Stats
+	{
+		unsigned underruns{};
+		unsigned overruns{};
+	};
+
+	// largest fraction the written frame count is scaled by to correct the buffer fill
+	static constexpr double MAX_RATE_ADJUSTMENT = 0.005;
+
 	constexpr EmuAudio(const IG::Audio::Manager &audioManager):
 		audioManagerPtr{&audioManager}
 	{}
@@ -52,30 +61,38 @@ public:
 	void setRate(uint32_t rate);
 	void setStereo(bool on);
 	void setSpeedMultiplier(uint8_t speed);
-	void setAddSoundBuffersOnUnderrun(bool on);
+	void setRateControl(bool on);
+	void setResamplerQuality(IG::Audio::ResamplerQuality);
 	void setVolume(uint8_t vol);
 	IG::Audio::Format format() const;
+	uint32_t framesWritten() const;
+	Stats stats() const;
+	void resetStats();
 	explicit operator bool() const;
 
 protected:
 	std::unique_ptr<IG::Audio::OutputStream> audioStream{};
 	const IG::Audio::Manager *audioManagerPtr{};
 	IG::RingBuffer rBuff{};
-	IG::Time lastUnderrunTime{};
+	IG::Audio::Resampler resampler{};
 	uint32_t targetBufferFillBytes = 0;
 	uint32_t bufferIncrementBytes = 0;
 	uint32_t rate{};
 	float volume = 1.0;
+	float avgFillError{};
+	double framesRemainder{};
+	std::atomic_uint underruns{};
+	std::atomic_uint overruns{};
 	std::atomic<AudioWriteState> audioWriteState = AudioWriteState::BUFFER;
-	bool addSoundBuffersOnUnderrun = false;
+	bool rateControl = true;
 	uint8_t speedMultiplier = 1;
 	uint8_t channels = 2;
 
 	uint32_t framesFree() const;
-	uint32_t framesWritten() const;
 	uint32_t framesCapacity() const;
 	bool shouldStartAudioWrites(uint32_t bytesToWrite = 0) const;
 	void resizeAudioBuffer(uint32_t targetBufferFillBytes);
+	double rateControlFactor();
 	const IG::Audio::Manager &audioManager() const;
 };
 
@@ -0,0 +1,62 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuSystem.hh>
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/fs/FSDefs.hh>
+#include <string_view>
+#include <utility>
+
+namespace IG
+{
+class ArchiveIO;
+}
+
+namespace EmuEx
+{
+
+using namespace IG;
+
+// Keeps decompressed archive entries in the app's cache directory so relaunching
+// recent content skips decompression. Files are named by a hash of the archive's
+// location, size & modification time plus the entry's name, size & CRC32, keeping
+// the entry's extension, and the least recently used are removed once the total
+// size passes the limit.
+class EmuContentCache
+{
+public:
+	EmuContentCache(IG::ApplicationContext, uint64_t maxBytes);
+	// Returns the cached copy of the archive entry & its path, memory mapped when
+	// possible, decompressing it into the cache first on a miss while reporting
+	// progress. Returns an empty FileIO without reading any data if the entry can't
+	// be cached. If writing the cache fails, io is re-opened at the start of the
+	// entry before returning.
+	std::pair<FileIO, FS::PathString> open(ArchiveIO &io, IG::CStringView archivePath, size_t archiveSize,
+		EmuSystem::OnLoadProgressDelegate onLoadProgress = {});
+	// removes the least recently used files until under the size limit
+	void trim(std::string_view keepName = {});
+
+protected:
+	IG::ApplicationContext ctx;
+	FS::PathString dir;
+	uint64_t maxBytes;
+
+	FS::FileString entryName(ArchiveIO &, IG::CStringView archivePath, size_t archiveSize) const;
+};
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/time/Time.hh>
+#include <imagine/util/string/CStringView.hh>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace IG
+{
+class ApplicationContext;
+}
+
+namespace EmuEx
+{
+
+// Records when each stage of a displayed frame happens, from the frame callback on
+// the main thread through emulation on EmuSystemTask to presentation, along with the
+// audio buffer fill. Each mark is a relaxed store into a ring holding the most recent
+// frames, and returns immediately while disabled.
+class EmuFrameTimingStats
+{
+public:
+	enum class Event : uint8_t
+	{
+		FRAME_START,  // main thread frame callback, pending input events already handled
+		INPUT_POLL,   // emulation thread, turbo & input state applied for the shown frame
+		RUN_START,
+		RUN_END,
+		FINISH_FRAME, // core handed the frame to EmuVideo
+		UPLOAD_END,   // texture write submitted
+		PRESENT,      // main window draw submitted
+	};
+
+	// durations derived from the events
+	enum class Stage : uint8_t
+	{
+		FRAME_INTERVAL, // FRAME_START to the next FRAME_START
+		EMULATION,      // RUN_START to RUN_END
+		UPLOAD,         // FINISH_FRAME to UPLOAD_END
+		LATENCY,        // FRAME_START to PRESENT
+		INPUT_LATENCY,  // earliest directly queued input event to RUN_END
+	};
+
+	static constexpr size_t EVENTS = 7;
+	static constexpr size_t HISTORY_FRAMES = 1024;
+	static constexpr size_t HISTOGRAM_BUCKETS = 34; // 1ms each, the last also counts longer times
+	using Histogram = std::array<uint32_t, HISTOGRAM_BUCKETS>;
+
+	void setEnabled(bool on);
+	bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+	// begins a new record, called from the main thread before dispatching emulation
+	void startFrame(IG::FrameTime vsyncTime);
+	void mark(Event e)
+	{
+		if(!isEnabled())
+			return;
+		markTime(e, IG::steadyClockTimestamp());
+	}
+	void markAudioFill(uint32_t frames);
+	// device time of the earliest input event applied to the current emulated frame
+	void markInputTime(IG::Time);
+	// bytes sent to the video texture this frame & the size of the whole frame
+	void markUploadBytes(uint32_t bytes, uint32_t frameBytes);
+	Histogram histogram(Stage, size_t frames = HISTORY_FRAMES) const;
+	// one line per stage with average & maximum times
+	std::string summary(size_t frames = HISTORY_FRAMES) const;
+	// writes all recorded frames with times in microseconds relative to the first, throws on error
+	void writeCSV(IG::ApplicationContext, IG::CStringView path) const;
+
+protected:
+	struct Record
+	{
+		std::array<std::atomic<int64_t>, EVENTS> times{};
+		std::atomic<int64_t> vsyncTime{};
+		std::atomic<int64_t> inputTime{};
+		std::atomic_uint32_t audioFillFrames{};
+		std::atomic_uint32_t uploadBytes{};
+		std::atomic_uint32_t frameBytes{};
+
+		void clear()
+		{
+			for(auto &t : times)
+			{
+				t.store(0, std::memory_order_relaxed);
+			}
+			vsyncTime.store(0, std::memory_order_relaxed);
+			inputTime.store(0, std::memory_order_relaxed);
+			audioFillFrames.store(0, std::memory_order_relaxed);
+			uploadBytes.store(0, std::memory_order_relaxed);
+			frameBytes.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	std::unique_ptr<Record[]> records{};
+	std::atomic_uint32_t frameCount{}; // records started so far
+	std::atomic_uint32_t emuFrameIdx{}; // record used by events after INPUT_POLL
+	std::atomic_bool enabled{};
+
+	void markTime(Event, IG::Time);
+	const Record &record(uint32_t frameIdx) const { return records[frameIdx % HISTORY_FRAMES]; }
+	Record &record(uint32_t frameIdx) { return records[frameIdx % HISTORY_FRAMES]; }
+	int64_t stageTime(Stage, uint32_t frameIdx) const;
+	void forEachStageTime(Stage, size_t frames, auto &&func) const;
+};
+
+}
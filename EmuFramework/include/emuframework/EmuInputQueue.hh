@@ -0,0 +1,58 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/input/Input.hh>
+#include <imagine/time/Time.hh>
+#include <array>
+#include <atomic>
+#include <span>
+
+namespace EmuEx
+{
+
+class EmuApp;
+
+// Emulated key events already mapped from device keys, pushed by the main thread and
+// applied by the emulation thread right before it runs the next frame
+class EmuInputQueue
+{
+public:
+	struct Event
+	{
+		IG::Time time{}; // when the device reported the key
+		uint32_t metaState{};
+		unsigned emuKey{};
+		IG::Input::Action action{};
+	};
+
+	static constexpr size_t capacity = 64;
+
+	// adds all events or none if there's no room
+	bool push(std::span<const Event>);
+	// returns the time of the earliest applied event or zero if the queue was empty
+	IG::Time apply(EmuApp &);
+	// drops all queued events, only call while the emulation thread isn't applying them
+	void clear();
+	bool empty() const;
+
+private:
+	std::array<Event, capacity> events{};
+	alignas(64) std::atomic_uint32_t writeIdx{};
+	alignas(64) std::atomic_uint32_t readIdx{};
+};
+
+}
@@ -18,6 +18,11 @@
 #include <emuframework/EmuAppHelper.hh>
 #include <imagine/gui/View.hh>
 
+namespace IG::Input
+{
+class KeyEvent;
+}
+
 namespace EmuEx
 {
 
@@ -26,6 +31,7 @@ class VController;
 class EmuApp;
 class EmuVideoLayer;
 class EmuViewController;
+class EmuInputQueue;
 
 class EmuInputView : public View, public EmuAppHelper<EmuInputView>
 {
@@ -35,6 +41,8 @@ public:
 	void place() final;
 	void draw(Gfx::RendererCommands &cmds) final;
 	bool inputEvent(const Input::Event &) final;
+	// queues the emulated keys mapped to the event, returns false if it needs normal dispatch
+	bool queueDirectKeyInput(const Input::KeyEvent &, EmuInputQueue &);
 	void resetInput();
 	VController *activeVController() const { return vController; }
 
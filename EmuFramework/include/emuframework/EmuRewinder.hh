@@ -0,0 +1,77 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace EmuEx
+{
+
+// Keeps a history of save states for rewinding. A snapshot is captured every
+// frameInterval frames, XOR'd against the previous one, run-length encoded,
+// and stored in a fixed-size byte ring that drops the oldest snapshots when full.
+// Only the newest snapshot is kept uncompressed, older ones are rebuilt by
+// applying their deltas in reverse.
+class EmuRewinder
+{
+public:
+	static constexpr unsigned MIN_FRAME_INTERVAL = 1;
+	static constexpr unsigned MAX_FRAME_INTERVAL = 30;
+
+	void setMemoryLimit(size_t bytes);
+	size_t memoryLimit() const { return ringCapacity; }
+	void setFrameInterval(unsigned frames);
+	unsigned frameInterval() const { return frameInterval_; }
+	bool isEnabled() const { return ringCapacity; }
+	void setActive(bool on) { active = on; }
+	bool isActive() const { return active && isEnabled(); }
+	// call after each emulated frame, captures a snapshot when the interval elapses
+	void addFrames(unsigned frames);
+	// restores the next oldest snapshot, or the oldest one again once the history is
+	// exhausted, returns false if no snapshot exists
+	bool rewind();
+	// drops the history and frees all buffers
+	void reset();
+	size_t snapshots() const { return packets.size() + (currStateSize ? 1 : 0); }
+	size_t usedBytes() const;
+
+private:
+	struct Packet
+	{
+		uint32_t offset;
+		uint32_t size;
+		uint32_t stateSize; // size of the older state this delta restores
+	};
+
+	std::vector<uint8_t> ring{};
+	std::deque<Packet> packets{};
+	std::vector<uint8_t> currState{}, scratchState{}, deltaBuff{};
+	size_t ringCapacity{};
+	size_t ringWritePos{};
+	size_t currStateSize{};
+	unsigned frameInterval_{4};
+	unsigned framesSinceCapture{};
+	bool active{};
+
+	void capture();
+	bool allocStateBuffers(size_t size);
+	void pushPacket(size_t size, size_t olderStateSize);
+};
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/pixmap/Pixmap.hh>
+#include <imagine/fs/FSDefs.hh>
+#include <bitset>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace IG::Data
+{
+class PixmapWriter;
+}
+
+namespace EmuEx
+{
+
+using namespace IG;
+class EmuSystemTask;
+
+// Writes screenshots on a worker thread so the emulation thread only pays for
+// copying the frame into a pooled buffer. The next free screenshot number comes
+// from a scan of the save directory done once per content, then tracked in memory.
+// Results are reported with EmuSystemTask::sendScreenshotReply().
+class EmuScreenshotWriter
+{
+public:
+	static constexpr int MAX_SCREENSHOTS = 999;
+
+	EmuScreenshotWriter(IG::ApplicationContext, const IG::Data::PixmapWriter &, EmuSystemTask &);
+	~EmuScreenshotWriter();
+	// saves as "<dir>/<name>.NNN.png" using the lowest unused number
+	void write(IG::Pixmap, FS::PathString dir, FS::FileString name);
+
+protected:
+	struct Job
+	{
+		std::vector<char> pixData;
+		IG::PixmapDesc desc;
+		FS::PathString dir;
+		FS::FileString name;
+	};
+
+	static constexpr size_t MAX_POOLED_BUFFERS = 2;
+	IG::ApplicationContext ctx;
+	const IG::Data::PixmapWriter &pixmapWriter;
+	EmuSystemTask &systemTask;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable jobsCond;
+	std::deque<Job> jobs;
+	std::vector<std::vector<char>> freeBuffers;
+	bool exiting{};
+	// only accessed by the worker thread
+	FS::PathString scannedBasePath{};
+	std::bitset<MAX_SCREENSHOTS> usedNumbers{};
+
+	void run();
+	void writeJob(const Job &);
+	int nextFreeNumber(const Job &);
+	void scanUsedNumbers(const Job &);
+};
+
+}
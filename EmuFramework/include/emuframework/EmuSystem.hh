@@ -22,6 +22,7 @@
 #include <imagine/util/rectangle2.h>
 #include <emuframework/config.hh>
 #include <optional>
+#include <span>
 #include <string>
 
 namespace IG
@@ -141,6 +142,7 @@ public:
 	static bool handlesArchiveFiles;
 	static bool handlesGenericIO;
 	static bool hasCheats;
+	static bool hasSeamlessMemoryStates; // in-memory states don't run extra frames, so they can be used every frame
 	static bool hasSound;
 	static int forcedSoundRate;
 	static IG::Audio::SampleFormat audioSampleFormat;
@@ -161,6 +163,9 @@ public:
 	static void loadState(IG::CStringView path);
 	static void saveState(IG::ApplicationContext, IG::CStringView uri);
 	static void saveState(IG::CStringView path);
+	static size_t stateSize(); // upper bound of bytes needed by saveState(std::span) for the running content
+	static size_t saveState(std::span<uint8_t> buff); // returns bytes written
+	static void loadState(std::span<const uint8_t> buff);
 	static bool stateExists(IG::ApplicationContext, int slot);
 	static const char *systemName();
 	static const char *shortSystemName();
@@ -169,6 +174,7 @@ public:
 	static FS::PathString contentDirectory(IG::ApplicationContext, std::string_view name);
 	static auto contentLocation() { return contentLocation_; }
 	static const char *contentLocationPtr() { return contentLocation_.data(); }
+	static FS::PathString contentFileLocation();
 	static FS::FileString contentName() { return contentName_; }
 	static FS::FileString contentFileName();
 	static std::string contentDisplayName();
@@ -266,6 +272,7 @@ protected:
 	static FS::PathString contentDirectory_; // full directory path of content on disk, if any
 	static FS::PathString contentLocation_; // full path or URI to content
 	static FS::FileString contentFileName_; // name + extension of content, inside archive if any
+	static FS::PathString contentCachePath_; // decompressed copy of archived content in the content cache, if any
 	static FS::FileString contentName_; // name of content from the original location without extension
 	static std::string contentDisplayName_; // more descriptive content name set by system
 	static FS::PathString contentSaveDirectory_;
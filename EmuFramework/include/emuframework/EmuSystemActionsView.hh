@@ -36,7 +36,7 @@ public:
 	void onShow() override;
 	void loadStandardItems();
 
-	static constexpr unsigned STANDARD_ITEMS = 9;
+	static constexpr unsigned STANDARD_ITEMS = 10;
 	static constexpr unsigned MAX_SYSTEM_ITEMS = 6;
 
 protected:
@@ -49,6 +49,7 @@ protected:
 	TextMenuItem addLauncherIcon;
 	#endif
 	TextMenuItem screenshot;
+	TextMenuItem frameTimingLog;
 	TextMenuItem resetSessionOptions;
 	TextMenuItem close;
 	StaticArrayList<MenuItem*, STANDARD_ITEMS + MAX_SYSTEM_ITEMS> item{};
@@ -15,8 +15,11 @@
 	You should have received a copy of the GNU General Public License
 	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
 
-#include <imagine/base/MessagePort.hh>
+#include <imagine/thread/SPSCMessagePort.hh>
+#include <imagine/thread/Thread.hh>
+#include <cassert>
 #include <thread>
+#include <utility>
 
 namespace EmuEx
 {
@@ -68,13 +71,15 @@ public:
 	void sendVideoFormatChangedReply(EmuVideo &video, std::binary_semaphore *frameFinishedSemPtr);
 	void sendFrameFinishedReply(EmuVideo &video, std::binary_semaphore *frameFinishedSemPtr);
 	void sendScreenshotReply(int num, bool success);
+	void setThreadAttributes(IG::ThreadAttributes);
 	EmuApp &app() const;
 	bool resetVideoFormatChanged() { return std::exchange(videoFormatChanged, false); }
 
 private:
 	EmuApp *appPtr{};
-	IG::MessagePort<CommandMessage> commandPort{"EmuSystemTask Command"};
+	IG::SPSCMessagePort<CommandMessage> commandPort;
 	std::thread taskThread{};
+	IG::ThreadId threadId{};
 	bool videoFormatChanged{};
 };
 
@@ -21,6 +21,8 @@
 #include <imagine/gfx/PixmapBufferTexture.hh>
 #include <imagine/gfx/SyncFence.hh>
 #include <optional>
+#include <atomic>
+#include <vector>
 
 namespace IG
 {
@@ -69,6 +71,9 @@ public:
 	void startUnchangedFrame(EmuSystemTaskContext);
 	void finishFrame(EmuSystemTaskContext, Gfx::LockedTextureBuffer texBuff);
 	void finishFrame(EmuSystemTaskContext, IG::Pixmap pix);
+	// limits the upload of the next frame passed as a pixmap to rows [start, end),
+	// for cores that track changed lines themselves instead of relying on row hashing
+	void setDirtyRows(int start, int end);
 	void dispatchFrameFinished();
 	bool addFence(Gfx::RendererCommands &cmds);
 	void clear();
@@ -103,8 +108,16 @@ protected:
 	bool singleBuffer{};
 	bool needsFence{};
 	Gfx::ColorSpace colSpace{};
+	std::atomic_bool rowHashesInvalid{};
+	uint8_t fullyDirtyFrames{};
+	uint8_t skipRowHashFrames{};
+	int coreDirtyStart{-1};
+	int coreDirtyEnd{};
+	std::vector<uint64_t> rowHashes;
 
-	void doScreenshot(EmuSystemTaskContext, IG::Pixmap pix);
+	void doScreenshot(IG::Pixmap pix);
+	std::pair<int, int> dirtyRows(IG::Pixmap pix);
+	void invalidateRowHashes();
 	void postFrameFinished(EmuSystemTaskContext);
 	void syncImageAccess();
 	void updateNeedsFence();
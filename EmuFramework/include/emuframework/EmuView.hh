@@ -15,10 +15,9 @@
 	You should have received a copy of the GNU General Public License
 	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
 
+#include <emuframework/EmuFrameTimingStats.hh>
 #include <imagine/gui/View.hh>
-#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
 #include <imagine/gfx/GfxText.hh>
-#endif
 
 namespace EmuEx
 {
@@ -38,17 +37,20 @@ public:
 	bool inputEvent(const Input::Event &) final;
 	bool hasLayer() const { return layer; }
 	void setLayoutInputView(EmuInputView *view);
-	void updateAudioStats(unsigned underruns, unsigned overruns, unsigned callbacks, double avgCallbackFrames, unsigned frames);
-	void clearAudioStats();
+	void updateStats(std::string_view text, const EmuFrameTimingStats::Histogram &intervalHist,
+		const EmuFrameTimingStats::Histogram &latencyHist);
+	void clearStats();
 	EmuVideoLayer *videoLayer() const { return layer; }
 
 private:
 	EmuVideoLayer *layer{};
 	EmuInputView *inputView{};
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	Gfx::Text audioStatsText{};
-	Gfx::GCRect audioStatsRect{};
-	#endif
+	Gfx::Text statsText{};
+	Gfx::GCRect statsRect{};
+	Gfx::GCRect histRect{};
+	std::array<EmuFrameTimingStats::Histogram, 2> statsHist{};
+
+	void drawHistogram(Gfx::RendererCommands &, const EmuFrameTimingStats::Histogram &, Gfx::GCRect) const;
 };
 
 }
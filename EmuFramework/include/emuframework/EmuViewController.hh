@@ -20,6 +20,7 @@
 #include <emuframework/EmuAppHelper.hh>
 #include <imagine/gui/ViewStack.hh>
 #include <imagine/gui/ToastView.hh>
+#include <imagine/base/Timer.hh>
 
 namespace IG
 {
@@ -77,8 +78,6 @@ public:
 	void placeElements();
 	void setEmuViewOnExtraWindow(bool on, IG::Screen &screen);
 	void startMainViewportAnimation();
-	void updateEmuAudioStats(unsigned underruns, unsigned overruns, unsigned callbacks, double avgCallbackFrames, unsigned frames);
-	void clearEmuAudioStats();
 	void closeSystem(bool allowAutosaveState = true);
 	void popToSystemActionsMenu();
 	void postDrawToEmuWindows();
@@ -103,6 +102,7 @@ public:
 	void handleOpenFileCommand(IG::CStringView path);
 	void setFastForwardSpeed(int speed);
 	bool isMenuDismissKey(const Input::KeyEvent &);
+	bool isShowingEmulation() const { return showingEmulation; }
 	void setUsePresentationTime(bool on) { usePresentationTime_ = on; }
 	bool usePresentationTime() const { return usePresentationTime_; }
 	void writeConfig(IO &io);
@@ -122,6 +122,7 @@ protected:
 	EmuAudio *emuAudioPtr{};
 	EmuApp *appPtr{};
 	IG::OnExit onExit{};
+	IG::Timer frameTimingStatsTimer{"EmuViewController::frameTimingStatsTimer"};
 	bool showingEmulation{};
 	IG::WindowFrameTimeSource winFrameTimeSrc{};
 	uint8_t targetFastForwardSpeed{};
@@ -151,6 +152,9 @@ protected:
 	void setWindowFrameClockSource(IG::WindowFrameTimeSource);
 	bool useRendererTime() const;
 	void configureSecondaryScreens();
+	void startFrameTimingStats();
+	void stopFrameTimingStats();
+	void updateFrameTimingStats();
 };
 
 }
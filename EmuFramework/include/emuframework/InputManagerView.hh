@@ -99,7 +99,10 @@ private:
 	BoolMenuItem btScanCache{};
 	#endif
 	BoolMenuItem altGamepadConfirm{};
-	StaticArrayList<MenuItem*, 10> item{};
+	#ifdef CONFIG_INPUT_EVDEV
+	BoolMenuItem directKeyInput{};
+	#endif
+	StaticArrayList<MenuItem*, 11> item{};
 	EmuInputView *emuInputView{};
 };
 
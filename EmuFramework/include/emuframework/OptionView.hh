@@ -20,6 +20,7 @@
 #include <imagine/gui/TableView.hh>
 #include <imagine/gui/MenuItem.hh>
 #include <imagine/audio/Manager.hh>
+#include <imagine/audio/Resampler.hh>
 #include <imagine/util/container/ArrayList.hh>
 #include <memory>
 
@@ -98,11 +99,12 @@ protected:
 	TextMenuItem renderPixelFormatItem[3];
 	MultiChoiceMenuItem renderPixelFormat;
 	IG_UseMemberIf(Config::envIsAndroid, BoolMenuItem, presentationTime);
+	BoolMenuItem frameTimingStats;
 	TextHeadingMenuItem visualsHeading;
 	TextHeadingMenuItem screenShapeHeading;
 	TextHeadingMenuItem advancedHeading;
 	TextHeadingMenuItem systemSpecificHeading;
-	StaticArrayList<MenuItem*, 31> item{};
+	StaticArrayList<MenuItem*, 32> item{};
 
 	void pushAndShowFrameRateSelectMenu(EmuSystem::VideoSystem, const Input::Event &);
 	bool onFrameTimeChange(EmuSystem::VideoSystem vidSys, IG::FloatSeconds time);
@@ -135,7 +137,9 @@ protected:
 	MultiChoiceMenuItem soundVolume;
 	TextMenuItem soundBuffersItem[7];
 	MultiChoiceMenuItem soundBuffers;
-	BoolMenuItem addSoundBuffersOnUnderrun;
+	BoolMenuItem rateControl;
+	TextMenuItem resamplerItem[3];
+	MultiChoiceMenuItem resampler;
 	StaticArrayList<TextMenuItem, 5> audioRateItem{};
 	MultiChoiceMenuItem audioRate;
 	IG_UseMemberIf(IG::Audio::Manager::HAS_SOLO_MIX, BoolMenuItem, audioSoloMix){};
@@ -150,6 +154,7 @@ protected:
 	TextMenuItem::SelectDelegate setRateDel(uint32_t val);
 	TextMenuItem::SelectDelegate setBuffersDel(int val);
 	TextMenuItem::SelectDelegate setVolumeDel(uint8_t val);
+	TextMenuItem::SelectDelegate setResamplerDel(IG::Audio::ResamplerQuality);
 };
 
 class SystemOptionView : public TableView, public EmuAppHelper<SystemOptionView>
@@ -167,6 +172,20 @@ protected:
 	static constexpr unsigned MIN_FAST_FORWARD_SPEED = 2;
 	TextMenuItem fastForwardSpeedItem[6];
 	MultiChoiceMenuItem fastForwardSpeed;
+	TextMenuItem rewindBufferSizeItem[6];
+	MultiChoiceMenuItem rewindBufferSize;
+	TextMenuItem rewindFrameIntervalItem[6];
+	MultiChoiceMenuItem rewindFrameInterval;
+	TextMenuItem runAheadFramesItem[5];
+	MultiChoiceMenuItem runAheadFrames;
+	TextMenuItem contentCacheSizeItem[6];
+	MultiChoiceMenuItem contentCacheSize;
+	TextMenuItem emuThreadCPUAffinityItem[3];
+	MultiChoiceMenuItem emuThreadCPUAffinity;
+	TextMenuItem renderThreadCPUAffinityItem[3];
+	MultiChoiceMenuItem renderThreadCPUAffinity;
+	TextMenuItem emuThreadPriorityItem[3];
+	MultiChoiceMenuItem emuThreadPriority;
 	#if defined __ANDROID__
 	BoolMenuItem performanceMode;
 	#endif
@@ -179,6 +198,13 @@ protected:
 	void pushAndShowFirmwareFilePathMenu(IG::utf16String name, const Input::Event &);
 	TextMenuItem::SelectDelegate setAutoSaveStateDel(int val);
 	TextMenuItem::SelectDelegate setFastForwardSpeedDel(int val);
+	TextMenuItem::SelectDelegate setRewindBufferSizeDel(int val);
+	TextMenuItem::SelectDelegate setRewindFrameIntervalDel(int val);
+	TextMenuItem::SelectDelegate setRunAheadFramesDel(int val);
+	TextMenuItem::SelectDelegate setContentCacheSizeDel(int val);
+	TextMenuItem::SelectDelegate setEmuThreadCPUAffinityDel(int val);
+	TextMenuItem::SelectDelegate setRenderThreadCPUAffinityDel(int val);
+	TextMenuItem::SelectDelegate setEmuThreadPriorityDel(int val);
 };
 
 class GUIOptionView : public TableView, public EmuAppHelper<GUIOptionView>
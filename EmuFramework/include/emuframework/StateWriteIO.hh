@@ -0,0 +1,71 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/io/IO.hh>
+#include <algorithm>
+#include <cstring>
+#include <span>
+
+namespace EmuEx
+{
+
+// Write-only IO over a fixed buffer for use with IG::FileStream by cores that
+// save states through a FILE*. The end position tracks the bytes written so far
+// instead of the buffer size, and with an empty buffer it only counts bytes.
+class StateWriteIO
+{
+public:
+	constexpr StateWriteIO() = default;
+	constexpr StateWriteIO(std::span<uint8_t> buff): buff{buff} {}
+
+	ssize_t read(void *, size_t) { return -1; }
+
+	ssize_t write(const void *data, size_t bytes)
+	{
+		if(buff.data())
+		{
+			if(bytes > buff.size() - std::min(pos, buff.size()))
+				return -1;
+			std::memcpy(&buff[pos], data, bytes);
+		}
+		pos += bytes;
+		end = std::max(end, pos);
+		return bytes;
+	}
+
+	off_t seek(off_t offset, IG::IO::SeekMode mode)
+	{
+		off_t newPos = offset;
+		if(mode == IG::IO::SeekMode::CUR)
+			newPos += pos;
+		else if(mode == IG::IO::SeekMode::END)
+			newPos += end;
+		if(newPos < 0)
+			return -1;
+		pos = newPos;
+		return newPos;
+	}
+
+	size_t size() const { return end; }
+
+private:
+	std::span<uint8_t> buff{};
+	size_t pos{};
+	size_t end{};
+};
+
+}
@@ -37,6 +37,15 @@ TextMenuItem::SelectDelegate AudioOptionView::setVolumeDel(uint8_t val)
 	return [this, val]() { app().setSoundVolume(val); };
 }
 
+TextMenuItem::SelectDelegate AudioOptionView::setResamplerDel(IG::Audio::ResamplerQuality quality)
+{
+	return [this, quality]()
+	{
+		optionAudioResampler = (uint8_t)quality;
+		audio->setResamplerQuality(quality);
+	};
+}
+
 AudioOptionView::AudioOptionView(ViewAttachParams attach, bool customMenu):
 	TableView{"Audio Options", attach, item},
 	snd
@@ -125,16 +134,28 @@ AudioOptionView::AudioOptionView(ViewAttachParams attach, bool customMenu):
 		(int)optionSoundBuffers - 1,
 		soundBuffersItem
 	},
-	addSoundBuffersOnUnderrun
+	rateControl
 	{
-		"Auto-increase Buffer Size", &defaultFace(),
-		(bool)optionAddSoundBuffersOnUnderrun,
+		"Dynamic Rate Control", &defaultFace(),
+		(bool)optionAudioRateControl,
 		[this](BoolMenuItem &item)
 		{
-			optionAddSoundBuffersOnUnderrun = item.flipBoolValue(*this);
-			audio->setAddSoundBuffersOnUnderrun(optionAddSoundBuffersOnUnderrun);
+			optionAudioRateControl = item.flipBoolValue(*this);
+			audio->setRateControl(optionAudioRateControl);
 		}
 	},
+	resamplerItem
+	{
+		{"Fast",   &defaultFace(), setResamplerDel(IG::Audio::ResamplerQuality::FAST)},
+		{"Medium", &defaultFace(), setResamplerDel(IG::Audio::ResamplerQuality::MEDIUM)},
+		{"High",   &defaultFace(), setResamplerDel(IG::Audio::ResamplerQuality::HIGH)},
+	},
+	resampler
+	{
+		"Resampler Quality", &defaultFace(),
+		(int)optionAudioResampler.val,
+		resamplerItem
+	},
 	audioRate
 	{
 		"Sound Rate", &defaultFace(),
@@ -217,7 +238,8 @@ void AudioOptionView::loadStockItems()
 		updateRateItem();
 	}
 	item.emplace_back(&soundBuffers);
-	item.emplace_back(&addSoundBuffersOnUnderrun);
+	item.emplace_back(&rateControl);
+	item.emplace_back(&resampler);
 	if constexpr(IG::Audio::Manager::HAS_SOLO_MIX)
 	{
 		item.emplace_back(&audioSoloMix);
@@ -178,6 +178,9 @@ void EmuApp::saveConfigFile(IO &io)
 		optionMenuOrientation,
 		optionConfirmOverwriteState,
 		optionFastForwardSpeed,
+		optionRewindBufferSize,
+		optionRewindFrameInterval,
+		optionRunAheadFrames,
 		#ifdef CONFIG_INPUT_DEVICE_HOTSWAP
 		optionNotifyInputDeviceChange,
 		#endif
@@ -185,6 +188,7 @@ void EmuApp::saveConfigFile(IO &io)
 		optionFrameInterval,
 		#endif
 		optionSkipLateFrames,
+		optionShowFrameTimingStats,
 		optionFrameRate,
 		optionFrameRatePAL,
 		optionNotificationIcon,
@@ -203,11 +207,17 @@ void EmuApp::saveConfigFile(IO &io)
 		optionShowBluetoothScan,
 		#endif
 		optionSoundBuffers,
-		optionAddSoundBuffersOnUnderrun,
+		optionAudioRateControl,
+		optionAudioResampler,
 		#ifdef CONFIG_AUDIO_MULTIPLE_SYSTEM_APIS
 		optionAudioAPI,
 		#endif
-		optionShowBundledGames
+		optionShowBundledGames,
+		optionContentCacheSize,
+		optionEmuThreadCPUAffinity,
+		optionRenderThreadCPUAffinity,
+		optionEmuThreadPriority,
+		optionDirectKeyInput
 	);
 
 	std::apply([&](auto &...opt){ (writeOptionValue(io, opt), ...); }, cfgFileOptions);
@@ -437,6 +447,12 @@ EmuApp::ConfigParams EmuApp::loadConfigFile(IG::ApplicationContext ctx)
 				bcase CFGKEY_FRAME_INTERVAL: optionFrameInterval.readFromIO(io, size);
 				#endif
 				bcase CFGKEY_SKIP_LATE_FRAMES: optionSkipLateFrames.readFromIO(io, size);
+				bcase CFGKEY_SHOW_FRAME_TIMING_STATS: optionShowFrameTimingStats.readFromIO(io, size);
+				bcase CFGKEY_CONTENT_CACHE_SIZE: optionContentCacheSize.readFromIO(io, size);
+				bcase CFGKEY_EMU_THREAD_CPU_AFFINITY: optionEmuThreadCPUAffinity.readFromIO(io, size);
+				bcase CFGKEY_RENDER_THREAD_CPU_AFFINITY: optionRenderThreadCPUAffinity.readFromIO(io, size);
+				bcase CFGKEY_EMU_THREAD_PRIORITY: optionEmuThreadPriority.readFromIO(io, size);
+				bcase CFGKEY_DIRECT_KEY_INPUT: optionDirectKeyInput.readFromIO(io, size);
 				bcase CFGKEY_FRAME_RATE: optionFrameRate.readFromIO(io, size);
 				bcase CFGKEY_FRAME_RATE_PAL: optionFrameRatePAL.readFromIO(io, size);
 				bcase CFGKEY_LAST_DIR:
@@ -478,6 +494,9 @@ EmuApp::ConfigParams EmuApp::loadConfigFile(IG::ApplicationContext ctx)
 				bcase CFGKEY_HIDE_STATUS_BAR: optionHideStatusBar.readFromIO(io, size);
 				bcase CFGKEY_CONFIRM_OVERWRITE_STATE: optionConfirmOverwriteState.readFromIO(io, size);
 				bcase CFGKEY_FAST_FORWARD_SPEED: optionFastForwardSpeed.readFromIO(io, size);
+				bcase CFGKEY_REWIND_BUFFER_SIZE: optionRewindBufferSize.readFromIO(io, size);
+				bcase CFGKEY_REWIND_FRAME_INTERVAL: optionRewindFrameInterval.readFromIO(io, size);
+				bcase CFGKEY_RUN_AHEAD_FRAMES: optionRunAheadFrames.readFromIO(io, size);
 				#ifdef CONFIG_INPUT_DEVICE_HOTSWAP
 				bcase CFGKEY_NOTIFY_INPUT_DEVICE_CHANGE: optionNotifyInputDeviceChange.readFromIO(io, size);
 				#endif
@@ -505,7 +524,8 @@ EmuApp::ConfigParams EmuApp::loadConfigFile(IG::ApplicationContext ctx)
 				#endif
 				bcase CFGKEY_SOUND_BUFFERS: optionSoundBuffers.readFromIO(io, size);
 				bcase CFGKEY_SOUND_VOLUME: optionSoundVolume.readFromIO(io, size);
-				bcase CFGKEY_ADD_SOUND_BUFFERS_ON_UNDERRUN: optionAddSoundBuffersOnUnderrun.readFromIO(io, size);
+				bcase CFGKEY_AUDIO_RATE_CONTROL: optionAudioRateControl.readFromIO(io, size);
+				bcase CFGKEY_AUDIO_RESAMPLER: optionAudioResampler.readFromIO(io, size);
 				bcase CFGKEY_AUDIO_SOLO_MIX: audioManager().setSoloMix(readOptionValue<bool>(io, size));
 				#ifdef CONFIG_AUDIO_MULTIPLE_SYSTEM_APIS
 				bcase CFGKEY_AUDIO_API: optionAudioAPI.readFromIO(io, size);
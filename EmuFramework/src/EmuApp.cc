@@ -42,6 +42,7 @@
 #include <imagine/util/string.h>
 #include <imagine/thread/Thread.hh>
 #include <cmath>
+#include <cstdio>
 
 namespace EmuEx
 {
@@ -68,6 +69,7 @@ EmuApp::EmuApp(IG::ApplicationInitParams initParams, IG::ApplicationContext &ctx
 	},
 	pixmapReader{ctx},
 	pixmapWriter{ctx},
+	screenshotWriter_{ctx, pixmapWriter, emuSystemTask},
 	vibrationManager_{ctx},
 	optionFontSize{CFGKEY_FONT_Y_SIZE,
 		Config::MACHINE_IS_PANDORA ? 6500 :
@@ -79,7 +81,11 @@ EmuApp::EmuApp(IG::ApplicationInitParams initParams, IG::ApplicationContext &ctx
 	optionAutoSaveState{CFGKEY_AUTO_SAVE_STATE, 1},
 	optionConfirmAutoLoadState{CFGKEY_CONFIRM_AUTO_LOAD_STATE, 1},
 	optionConfirmOverwriteState{CFGKEY_CONFIRM_OVERWRITE_STATE, 1},
-	optionFastForwardSpeed{CFGKEY_FAST_FORWARD_SPEED, 4, false, optionIsValidWithMinMax<2, 7>}
+	optionFastForwardSpeed{CFGKEY_FAST_FORWARD_SPEED, 4, false, optionIsValidWithMinMax<2, 7>},
+	optionRewindBufferSize{CFGKEY_REWIND_BUFFER_SIZE, 0, false, optionIsValidWithMax<128>},
+	optionRewindFrameInterval{CFGKEY_REWIND_FRAME_INTERVAL, 4, false,
+		optionIsValidWithMinMax<EmuRewinder::MIN_FRAME_INTERVAL, EmuRewinder::MAX_FRAME_INTERVAL>},
+	optionRunAheadFrames{CFGKEY_RUN_AHEAD_FRAMES, 0, false, optionIsValidWithMax<4>}
 {
 	EmuSystem::onInit(ctx);
 	mainInitCommon(initParams, ctx);
@@ -178,6 +184,38 @@ void EmuApp::setCPUNeedsLowLatency(IG::ApplicationContext ctx, bool needed)
 	#endif
 }
 
+static IG::CPUMask cpuMaskForAffinityOption(uint8_t val)
+{
+	switch(val)
+	{
+		case 1: return IG::performanceCPUMask();
+		case 2: return IG::efficiencyCPUMask();
+		default: return 0;
+	}
+}
+
+IG::ThreadAttributes EmuApp::emuThreadAttributes()
+{
+	IG::ThreadAttributes attrs{.cpuMask = cpuMaskForAffinityOption(optionEmuThreadCPUAffinity)};
+	if(optionEmuThreadPriority >= 1)
+		attrs.nice = -4;
+	if(optionEmuThreadPriority == 2)
+		attrs.policy = IG::ThreadPolicy::FIFO;
+	return attrs;
+}
+
+IG::ThreadAttributes EmuApp::renderThreadAttributes()
+{
+	// keep the renderer's default nice level
+	return {.cpuMask = cpuMaskForAffinityOption(optionRenderThreadCPUAffinity), .nice = Gfx::Renderer::DRAW_THREAD_PRIORITY};
+}
+
+void EmuApp::applyThreadAttributes()
+{
+	emuSystemTask.setThreadAttributes(emuThreadAttributes());
+	renderer.task().run([attrs = renderThreadAttributes()](){ IG::setThisThreadAttributes(attrs); });
+}
+
 static void suspendEmulation(EmuApp &app)
 {
 	if(!EmuSystem::gameIsRunning())
@@ -361,6 +399,42 @@ void EmuApp::updateLegacySavePath(IG::ApplicationContext ctx, IG::CStringView pa
 
 void EmuApp::mainInitCommon(IG::ApplicationInitParams initParams, IG::ApplicationContext ctx)
 {
+	if(auto benchParams = parseBenchmarkArgs(initParams.commandArgs());
+		benchParams)
+	{
+		initOptions(ctx);
+		loadConfigFile(ctx);
+		EmuSystem::onOptionsLoaded(ctx);
+		if(benchParams->hasInvalidArgs)
+		{
+			printBenchmarkUsage();
+			ctx.exit(1);
+			return;
+		}
+		// frames are rendered into the video texture as in a normal session, just without a window to present them
+		try
+		{
+			renderer.initMainTask(nullptr, windowDrawableConfig());
+		}
+		catch(std::exception &err)
+		{
+			logErr("error initializing renderer:%s", err.what());
+			std::fprintf(stderr, "error initializing renderer: %s\n", err.what());
+			ctx.exit(1);
+			return;
+		}
+		if(!supportsVideoImageBuffersOption(renderer))
+			optionVideoImageBuffers.resetToConst();
+		emuVideo.setRendererTask(renderer.task());
+		emuVideo.setOnFormatChanged([](EmuVideo &){});
+		emuVideo.setOnFrameFinished([](EmuVideo &){});
+		emuVideo.setTextureBufferMode((Gfx::TextureBufferMode)optionTextureBufferMode.val);
+		emuVideo.setImageBuffers(optionVideoImageBuffers);
+		emuVideoLayer.setLinearFilter(optionImgFilter);
+		applyRenderPixelFormat();
+		ctx.exit(runHeadlessBenchmark(*this, *benchParams));
+		return;
+	}
 	if(ctx.registerInstance(initParams))
 	{
 		ctx.exit();
@@ -387,7 +461,9 @@ void EmuApp::mainInitCommon(IG::ApplicationInitParams initParams, IG::Applicatio
 	if(optionSoundRate > optionSoundRate.defaultVal)
 		optionSoundRate.reset();
 	emuAudio.setRate(optionSoundRate);
-	emuAudio.setAddSoundBuffersOnUnderrun(optionAddSoundBuffersOnUnderrun);
+	emuAudio.setRateControl(optionAudioRateControl);
+	emuAudio.setResamplerQuality((IG::Audio::ResamplerQuality)optionAudioResampler.val);
+	frameTimingStats_.setEnabled(optionShowFrameTimingStats);
 	if(!renderer.supportsColorSpace())
 		windowDrawableConf.colorSpace = {};
 	applyOSNavStyle(ctx, false);
@@ -478,7 +554,11 @@ void EmuApp::mainInitCommon(IG::ApplicationInitParams initParams, IG::Applicatio
 				emuSystemTask, emuAudio);
 			if(!appConfig.rendererPresentationTime())
 				emuViewController->setUsePresentationTime(false);
+			if(optionDirectKeyInput)
+				setDirectKeyInput(true);
 			emuVideo.setRendererTask(renderer.task());
+			if(optionRenderThreadCPUAffinity)
+				renderer.task().run([attrs = renderThreadAttributes()](){ IG::setThisThreadAttributes(attrs); });
 			emuVideo.setTextureBufferMode((Gfx::TextureBufferMode)optionTextureBufferMode.val);
 			emuVideo.setImageBuffers(optionVideoImageBuffers);
 			emuVideoLayer.setLinearFilter(optionImgFilter); // init the texture sampler before setting format
@@ -945,6 +1025,32 @@ void EmuApp::removeTurboInputEvent(unsigned action)
 	turboActions.removeEvent(action);
 }
 
+void EmuApp::setDirectKeyInput(bool on)
+{
+	#ifdef CONFIG_INPUT_EVDEV
+	if(!on)
+	{
+		appContext().application().setOnDirectKeyInput({});
+		return;
+	}
+	appContext().application().setOnDirectKeyInput(
+		[this](const Input::KeyEvent &e)
+		{
+			if(!emuViewController || !viewController().isShowingEmulation() || !EmuSystem::isActive())
+				return false;
+			if(viewController().inputView().queueDirectKeyInput(e, directInputQueue_))
+				return true;
+			if(!directInputQueue_.empty())
+			{
+				// apply the already queued events first so this one isn't handled out of order
+				syncEmulationThread();
+				directInputQueue_.apply(*this);
+			}
+			return false;
+		});
+	#endif
+}
+
 void EmuApp::runTurboInputEvents()
 {
 	assert(EmuSystem::gameIsRunning());
@@ -1071,6 +1177,18 @@ void EmuApp::configFrameTime()
 
 void EmuApp::runFrames(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio *audio, int frames, bool skipForward)
 {
+	using TimingEvent = EmuFrameTimingStats::Event;
+	frameTimingStats_.mark(TimingEvent::INPUT_POLL);
+	if(auto inputTime = directInputQueue_.apply(*this); inputTime.count())
+		frameTimingStats_.markInputTime(inputTime);
+	if(emuRewinder.isActive() && emuRewinder.rewind()) [[unlikely]]
+	{
+		// present the restored snapshot, one per frame regardless of speed
+		frameTimingStats_.mark(TimingEvent::RUN_START);
+		EmuSystem::runFrame(taskCtx, video, nullptr);
+		frameTimingStats_.mark(TimingEvent::RUN_END);
+		return;
+	}
 	if(skipForward) [[unlikely]]
 	{
 		if(skipForwardFrames(taskCtx, frames - 1))
@@ -1089,7 +1207,85 @@ void EmuApp::runFrames(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio *
 		skipFrames(taskCtx, frames - 1, audio);
 	}
 	runTurboInputEvents();
-	EmuSystem::runFrame(taskCtx, video, audio);
+	frameTimingStats_.mark(TimingEvent::RUN_START);
+	if(optionRunAheadFrames && video && EmuSystem::hasSeamlessMemoryStates) [[unlikely]]
+		runFrameWithRunAhead(taskCtx, *video, audio, optionRunAheadFrames);
+	else
+		EmuSystem::runFrame(taskCtx, video, audio);
+	frameTimingStats_.mark(TimingEvent::RUN_END);
+	if(audio && frameTimingStats_.isEnabled())
+		frameTimingStats_.markAudioFill(audio->framesWritten());
+	emuRewinder.addFrames(frames);
+}
+
+void EmuApp::runFrameWithRunAhead(EmuSystemTaskContext taskCtx, EmuVideo &video, EmuAudio *audio, int aheadFrames)
+{
+	// the real frame only outputs audio, then the state is saved and the
+	// predicted frames are run to show the final one before restoring it
+	EmuSystem::runFrame(taskCtx, nullptr, audio);
+	size_t stateSize{};
+	try
+	{
+		if(runAheadState.empty())
+			runAheadState.resize(EmuSystem::stateSize());
+		try
+		{
+			stateSize = EmuSystem::saveState(std::span<uint8_t>{runAheadState});
+		}
+		catch(std::exception &)
+		{
+			// state may have outgrown the buffer, retry once with the updated size
+			auto newSize = EmuSystem::stateSize();
+			if(newSize <= runAheadState.size())
+				throw;
+			runAheadState.resize(newSize);
+			stateSize = EmuSystem::saveState(std::span<uint8_t>{runAheadState});
+		}
+	}
+	catch(std::exception &err)
+	{
+		logErr("error saving run-ahead state:%s", err.what());
+		disableRunAhead();
+		EmuSystem::renderFramebuffer(video);
+		return;
+	}
+	iterateTimes(aheadFrames - 1, i)
+	{
+		EmuSystem::runFrame(taskCtx, nullptr, nullptr);
+	}
+	EmuSystem::runFrame(taskCtx, &video, nullptr);
+	try
+	{
+		EmuSystem::loadState(std::span<const uint8_t>{runAheadState.data(), stateSize});
+	}
+	catch(std::exception &err)
+	{
+		logErr("error restoring run-ahead state:%s", err.what());
+		disableRunAhead();
+	}
+}
+
+void EmuApp::disableRunAhead()
+{
+	runAheadState = {};
+	// the option is only written on the main thread, run-ahead is tried again until this runs
+	runOnMainThread(
+		[](IG::ApplicationContext ctx)
+		{
+			auto &app = EmuApp::get(ctx);
+			if(!app.runAheadFramesOption())
+				return;
+			app.runAheadFramesOption() = 0;
+			app.postErrorMessage(4, "Run-ahead disabled due to a state error");
+		});
+}
+
+void EmuApp::configRewinder()
+{
+	emuRewinder.reset();
+	// cores with states that run extra frames can't be snapshotted every few frames
+	emuRewinder.setMemoryLimit(EmuSystem::hasSeamlessMemoryStates ? optionRewindBufferSize * 1024 * 1024 : 0);
+	emuRewinder.setFrameInterval(optionRewindFrameInterval);
 }
 
 void EmuApp::skipFrames(EmuSystemTaskContext taskCtx, uint32_t frames, EmuAudio *audio)
@@ -1116,29 +1312,6 @@ bool EmuApp::skipForwardFrames(EmuSystemTaskContext taskCtx, uint32_t frames)
 	return true;
 }
 
-bool EmuApp::writeScreenshot(IG::Pixmap pix, IG::CStringView path)
-{
-	return pixmapWriter.writeToFile(pix, path);
-}
-
-std::pair<int, FS::PathString> EmuApp::makeNextScreenshotFilename()
-{
-	static constexpr int maxNum = 999;
-	auto ctx = appContext();
-	auto basePath = EmuSystem::contentSavePath(ctx, EmuSystem::contentName());
-	iterateTimes(maxNum, i)
-	{
-		auto str = IG::format<FS::PathString>("{}.{:03d}.png", basePath, i);
-		if(!ctx.fileUriExists(str))
-		{
-			logMsg("screenshot %d", i);
-			return {i, str};
-		}
-	}
-	logMsg("no screenshot filenames left");
-	return {-1, {}};
-}
-
 bool EmuApp::mogaManagerIsActive() const
 {
 	return (bool)mogaManagerPtr;
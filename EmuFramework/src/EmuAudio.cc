@@ -23,51 +23,6 @@
 namespace EmuEx
 {
 
-struct AudioStats
-{
-	constexpr AudioStats() {}
-	unsigned underruns = 0;
-	unsigned overruns = 0;
-	std::atomic_uint callbacks{};
-	std::atomic_uint callbackBytes{};
-
-	void reset()
-	{
-		underruns = overruns = 0;
-		callbacks = 0;
-		callbackBytes = 0;
-	}
-};
-
-#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-static AudioStats audioStats{};
-static IG::Timer audioStatsTimer{"audioStatsTimer"};
-#endif
-
-static void startAudioStats(IG::Audio::Format format)
-{
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStats.reset();
-	audioStatsTimer.run(IG::Seconds(1), IG::Seconds(1), {},
-		[format]()
-		{
-			auto frames = format.bytesToFrames(audioStats.callbackBytes);
-			emuViewController.updateEmuAudioStats(audioStats.underruns, audioStats.overruns,
-				audioStats.callbacks, frames / (double)audioStats.callbacks, frames);
-			audioStats.callbacks = 0;
-			audioStats.callbackBytes = 0;
-		});
-	#endif
-}
-
-static void stopAudioStats()
-{
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsTimer.deinit();
-	clearEmuAudioStats();
-	#endif
-}
-
 uint32_t EmuAudio::framesFree() const
 {
 	return format().bytesToFrames(rBuff.freeSpace());
@@ -89,46 +44,6 @@ bool EmuAudio::shouldStartAudioWrites(uint32_t bytesToWrite) const
 	return rBuff.size() + bytesToWrite >= targetBufferFillBytes;
 }
 
-template<typename T>
-static void simpleResample(T * __restrict__ dest, unsigned destFrames, const T * __restrict__ src, unsigned srcFrames)
-{
-	if(!destFrames)
-		return;
-	float ratio = (float)srcFrames/(float)destFrames;
-	iterateTimes(destFrames, i)
-	{
-		unsigned srcPos = round(i * ratio);
-		if(srcPos > srcFrames) [[unlikely]]
-		{
-			logMsg("resample pos %u too high", srcPos);
-			srcPos = srcFrames-1;
-		}
-		dest[i] = src[srcPos];
-	}
-}
-
-static void simpleResample(void *dest, unsigned destFrames, const void *src, unsigned srcFrames, IG::Audio::Format format)
-{
-	if(format.channels == 1)
-	{
-		if(format.sample.isFloat())
-			simpleResample((uint32_t*)dest, destFrames, (uint32_t*)src, srcFrames);
-		else
-			simpleResample((uint16_t*)dest, destFrames, (uint16_t*)src, srcFrames);
-	}
-	else
-	{
-		if(format.channels != 2)
-		{
-			bug_unreachable("channels == %d", format.channels);
-		}
-		if(format.sample.isFloat())
-			simpleResample((uint64_t*)dest, destFrames, (uint64_t*)src, srcFrames);
-		else
-			simpleResample((uint32_t*)dest, destFrames, (uint32_t*)src, srcFrames);
-	}
-}
-
 void EmuAudio::resizeAudioBuffer(uint32_t targetBufferFillBytes)
 {
 	auto oldCapacity = rBuff.capacity();
@@ -154,7 +69,9 @@ void EmuAudio::start(IG::Microseconds targetBufferFillUSecs, IG::Microseconds bu
 		logMsg("sound is disabled");
 		return;
 	}
-	lastUnderrunTime = {};
+	avgFillError = {};
+	framesRemainder = {};
+	resampler.reset();
 	auto inputFormat = format();
 	targetBufferFillBytes = inputFormat.timeToBytes(targetBufferFillUSecs);
 	bufferIncrementBytes = inputFormat.timeToBytes(bufferIncrementUSecs);
@@ -169,10 +86,6 @@ void EmuAudio::start(IG::Microseconds targetBufferFillUSecs, IG::Microseconds bu
 			[this, outputSampleFormat = outputFormat.sample, inputSampleFormat = inputFormat.sample, channels = outputFormat.channels](void *samples, unsigned frames)
 			{
 				IG::Audio::Format outputFormat{{}, outputSampleFormat, channels};
-				#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-				audioStats.callbacks++;
-				audioStats.callbackBytes += bytes;
-				#endif
 				if(audioWriteState == AudioWriteState::ACTIVE)
 				{
 					IG::Audio::Format inputFormat = {{}, inputSampleFormat, channels};
@@ -185,20 +98,8 @@ void EmuAudio::start(IG::Microseconds targetBufferFillUSecs, IG::Microseconds bu
 						auto padFrames = frames - framesToRead;
 						std::fill_n(frameEndAddr, outputFormat.framesToBytes(padFrames), 0);
 						//logMsg("underrun, %d bytes ready out of %d", bytesReady, bytes);
-						auto now = IG::steadyClockTimestamp();
-						if(now - lastUnderrunTime < IG::Seconds(1))
-						{
-							//logWarn("multiple underruns within a short time");
-							audioWriteState = AudioWriteState::MULTI_UNDERRUN;
-						}
-						else
-						{
-							audioWriteState = AudioWriteState::UNDERRUN;
-						}
-						lastUnderrunTime = now;
-						#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-						audioStats.underruns++;
-						#endif
+						audioWriteState = AudioWriteState::UNDERRUN;
+						underruns.fetch_add(1, std::memory_order_relaxed);
 					}
 					return true;
 				}
@@ -210,12 +111,10 @@ void EmuAudio::start(IG::Microseconds targetBufferFillUSecs, IG::Microseconds bu
 			}
 		};
 		outputConf.setWantedLatencyHint({});
-		startAudioStats(inputFormat);
 		audioStream->open(outputConf);
 	}
 	else
 	{
-		startAudioStats(inputFormat);
 		if(shouldStartAudioWrites())
 		{
 			if(Config::DEBUG_BUILD)
@@ -232,11 +131,11 @@ void EmuAudio::start(IG::Microseconds targetBufferFillUSecs, IG::Microseconds bu
 
 void EmuAudio::stop()
 {
-	stopAudioStats();
 	audioWriteState = AudioWriteState::BUFFER;
 	if(audioStream)
 		audioStream->close();
 	rBuff.clear();
+	resampler.reset();
 }
 
 void EmuAudio::close()
@@ -250,61 +149,56 @@ void EmuAudio::flush()
 {
 	if(!audioStream) [[unlikely]]
 		return;
-	stopAudioStats();
 	audioWriteState = AudioWriteState::BUFFER;
 	if(audioStream)
 		audioStream->flush();
 	rBuff.clear();
+	resampler.reset();
 }
 
 void EmuAudio::writeFrames(const void *samples, uint32_t framesToWrite)
 {
 	assumeExpr(rBuff);
 	auto inputFormat = format();
-	switch(audioWriteState)
+	if(audioWriteState == AudioWriteState::UNDERRUN)
 	{
-		case AudioWriteState::MULTI_UNDERRUN:
-			if(speedMultiplier == 1 && addSoundBuffersOnUnderrun &&
-				inputFormat.bytesToTime(rBuff.capacity()).count() <= 1.) // hard cap buffer increase to 1 sec
-			{
-				logWarn("increasing buffer size due to multiple underruns within a short time");
-				targetBufferFillBytes += bufferIncrementBytes;
-				resizeAudioBuffer(targetBufferFillBytes);
-			}
-			[[fallthrough]];
-		case AudioWriteState::UNDERRUN:
-			audioWriteState = AudioWriteState::BUFFER;
-		break;
-		default:
-		break;
+		audioWriteState = AudioWriteState::BUFFER;
 	}
 	const uint32_t sampleFrames = framesToWrite;
+	double outputFrames = sampleFrames;
 	if(speedMultiplier > 1) [[unlikely]]
 	{
-		framesToWrite = std::ceil((double)framesToWrite / speedMultiplier);
-		framesToWrite = std::max(framesToWrite, 1u);
+		outputFrames /= speedMultiplier;
+	}
+	if(rateControl && audioWriteState == AudioWriteState::ACTIVE)
+	{
+		outputFrames *= rateControlFactor();
 	}
+	// carry the fractional frame over to the next write so the average rate is exact
+	outputFrames += framesRemainder;
+	framesToWrite = std::max(uint32_t(outputFrames), 1u);
+	framesRemainder = outputFrames - framesToWrite;
 	auto bytes = inputFormat.framesToBytes(framesToWrite);
 	auto freeBytes = rBuff.freeSpace();
 	if(bytes <= freeBytes)
 	{
-		if(sampleFrames > framesToWrite)
+		if(framesToWrite == sampleFrames && !resampler.hasHistory())
 		{
-			simpleResample(rBuff.writeAddr(), framesToWrite, samples, sampleFrames, inputFormat);
-			rBuff.commitWrite(bytes);
+			rBuff.writeUnchecked(samples, bytes);
 		}
 		else
-			rBuff.writeUnchecked(samples, bytes);
+		{
+			resampler.resample(rBuff.writeAddr(), framesToWrite, samples, sampleFrames, inputFormat);
+			rBuff.commitWrite(bytes);
+		}
 	}
 	else
 	{
 		logMsg("overrun, only %d out of %d bytes free", freeBytes, bytes);
-		#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-		audioStats.overruns++;
-		#endif
+		overruns.fetch_add(1, std::memory_order_relaxed);
 		auto freeFrames = inputFormat.bytesToFrames(freeBytes);
-		simpleResample(rBuff.writeAddr(), freeFrames, samples, sampleFrames, inputFormat);
-		rBuff.commitWrite(freeBytes);
+		resampler.resample(rBuff.writeAddr(), freeFrames, samples, sampleFrames, inputFormat);
+		rBuff.commitWrite(inputFormat.framesToBytes(freeFrames));
 	}
 	if(audioWriteState == AudioWriteState::BUFFER && shouldStartAudioWrites(bytes))
 	{
@@ -345,9 +239,25 @@ void EmuAudio::setSpeedMultiplier(uint8_t speed)
 	speedMultiplier = speed ? speed : 1;
 }
 
-void EmuAudio::setAddSoundBuffersOnUnderrun(bool on)
+// Proportional controller nudging the output rate by up to MAX_RATE_ADJUSTMENT to hold
+// the buffer near its fill target, absorbing small mismatches between the emulated &
+// real frame rates without audible pitch changes
+double EmuAudio::rateControlFactor()
+{
+	constexpr float smoothing = 1.f / 8.f;
+	float fillError = ((float)rBuff.size() - targetBufferFillBytes) / targetBufferFillBytes;
+	avgFillError += (std::clamp(fillError, -1.f, 1.f) - avgFillError) * smoothing;
+	return 1. - MAX_RATE_ADJUSTMENT * avgFillError;
+}
+
+void EmuAudio::setRateControl(bool on)
+{
+	rateControl = on;
+}
+
+void EmuAudio::setResamplerQuality(IG::Audio::ResamplerQuality quality)
 {
-	addSoundBuffersOnUnderrun = on;
+	resampler.setQuality(quality);
 }
 
 void EmuAudio::setVolume(uint8_t vol)
@@ -369,6 +279,17 @@ IG::Audio::Format EmuAudio::format() const
 	return {rate, EmuSystem::audioSampleFormat, channels};
 }
 
+EmuAudio::Stats EmuAudio::stats() const
+{
+	return {underruns.load(std::memory_order_relaxed), overruns.load(std::memory_order_relaxed)};
+}
+
+void EmuAudio::resetStats()
+{
+	underruns = 0;
+	overruns = 0;
+}
+
 EmuAudio::operator bool() const
 {
 	return (bool)rBuff;
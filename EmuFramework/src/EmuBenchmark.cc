@@ -0,0 +1,199 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Benchmark"
+#include <emuframework/EmuApp.hh>
+#include <emuframework/EmuSystem.hh>
+#include "private.hh"
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/util/format.hh>
+#include <imagine/util/string.h>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+namespace EmuEx
+{
+
+static std::optional<int> parseCountArg(std::string_view arg, std::string_view name, int minVal)
+{
+	arg.remove_prefix(name.size());
+	int val{};
+	auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), val);
+	if(ec != std::errc{} || ptr != arg.data() + arg.size() || val < minVal)
+	{
+		logErr("invalid value for %s", name.data());
+		std::fprintf(stderr, "invalid value for %.*s, expected an integer >= %d\n", int(name.size() - 1), name.data(), minVal);
+		return {};
+	}
+	return val;
+}
+
+std::optional<HeadlessBenchmarkParams> parseBenchmarkArgs(IG::CommandArgs arg)
+{
+	if(arg.c < 2 || std::string_view{arg.v[1]} != "--benchmark")
+		return {};
+	HeadlessBenchmarkParams params{};
+	for(int i = 2; i < arg.c; i++)
+	{
+		std::string_view argStr{arg.v[i]};
+		if(argStr.starts_with("--frames="))
+		{
+			if(auto frames = parseCountArg(argStr, "--frames=", 1); frames)
+				params.frames = *frames;
+			else
+				params.hasInvalidArgs = true;
+		}
+		else if(argStr.starts_with("--warmup="))
+		{
+			if(auto warmup = parseCountArg(argStr, "--warmup=", 0); warmup)
+				params.warmupFrames = *warmup;
+			else
+				params.hasInvalidArgs = true;
+		}
+		else if(argStr.starts_with("--output="))
+			params.outputPath = arg.v[i] + std::string_view{"--output="}.size();
+		else if(argStr.starts_with("--"))
+			logWarn("ignoring unknown benchmark option:%s", arg.v[i]);
+		else
+			params.paths.emplace_back(arg.v[i]);
+	}
+	return params;
+}
+
+void printBenchmarkUsage()
+{
+	std::fputs("usage: --benchmark [--frames=N] [--warmup=N] [--output=file.json] content...\n", stderr);
+}
+
+static std::string jsonEscaped(std::string_view str)
+{
+	std::string escaped;
+	escaped.reserve(str.size());
+	for(auto c : str)
+	{
+		switch(c)
+		{
+			case '"': escaped += "\\\""; break;
+			case '\\': escaped += "\\\\"; break;
+			case '\n': escaped += "\\n"; break;
+			case '\t': escaped += "\\t"; break;
+			default:
+				if((unsigned char)c < 0x20)
+					escaped += fmt::format("\\u{:04x}", (unsigned)c);
+				else
+					escaped += c;
+		}
+	}
+	return escaped;
+}
+
+static double percentileMSecs(std::span<const IG::Time> sortedTimes, double percentile)
+{
+	// nearest-rank percentile
+	auto rank = std::ceil(percentile / 100. * sortedTimes.size());
+	auto idx = std::clamp(int(rank) - 1, 0, int(sortedTimes.size()) - 1);
+	return std::chrono::duration<double, std::milli>{sortedTimes[idx]}.count();
+}
+
+static bool runContentBenchmark(EmuApp &app, IG::CStringView path, const HeadlessBenchmarkParams &params, std::string &results)
+{
+	if(results.size())
+		results += ",\n";
+	auto ctx = app.appContext();
+	logMsg("loading:%s", path.data());
+	try
+	{
+		EmuSystem::loadGameFromPath(ctx, path, FS::basename(path), {}, {});
+	}
+	catch(std::exception &err)
+	{
+		logErr("error loading %s:%s", path.data(), err.what());
+		EmuSystem::clearGamePaths();
+		results += fmt::format("\t\t{{\"path\": \"{}\", \"error\": \"{}\"}}", jsonEscaped(path), jsonEscaped(err.what()));
+		return false;
+	}
+	// frames are rendered into the video texture like EmuSystem::benchmark(), audio is skipped
+	auto &video = app.video();
+	iterateTimes(params.warmupFrames, i)
+	{
+		EmuSystem::runFrame({}, &video, nullptr);
+	}
+	std::vector<IG::Time> frameTimes;
+	frameTimes.reserve(params.frames);
+	auto startTime = IG::steadyClockTimestamp();
+	iterateTimes(params.frames, i)
+	{
+		frameTimes.emplace_back(IG::timeFunc(EmuSystem::runFrame, EmuSystemTaskContext{}, &video, nullptr));
+	}
+	IG::FloatSeconds totalTime = IG::steadyClockTimestamp() - startTime;
+	EmuSystem::closeRuntimeSystem(app, false);
+	std::sort(frameTimes.begin(), frameTimes.end());
+	double meanMSecs = totalTime.count() * 1000. / params.frames;
+	double fps = params.frames / totalTime.count();
+	logMsg("%s: %.2f fps", path.data(), fps);
+	results += fmt::format("\t\t{{\"path\": \"{}\", \"frames\": {}, \"seconds\": {:.6f}, \"fps\": {:.2f}, "
+		"\"meanFrameMs\": {:.4f}, \"p50FrameMs\": {:.4f}, \"p95FrameMs\": {:.4f}, \"p99FrameMs\": {:.4f}}}",
+		jsonEscaped(path), params.frames, totalTime.count(), fps,
+		meanMSecs, percentileMSecs(frameTimes, 50.), percentileMSecs(frameTimes, 95.), percentileMSecs(frameTimes, 99.));
+	return true;
+}
+
+int runHeadlessBenchmark(EmuApp &app, const HeadlessBenchmarkParams &params)
+{
+	if(params.paths.empty())
+	{
+		logErr("no content paths given to benchmark");
+		printBenchmarkUsage();
+		return 1;
+	}
+	auto ctx = app.appContext();
+	// battery saves, auto-states & session options go to a scratch directory
+	// so a benchmark run never reads or modifies the user's save data
+	auto scratchSavePath = FS::createDirectorySegments(ctx.cachePath(), "benchmark");
+	EmuSystem::setUserSaveDirectory(ctx, scratchSavePath);
+	std::string results;
+	bool hadError{};
+	for(auto path : params.paths)
+	{
+		hadError |= !runContentBenchmark(app, path, params, results);
+	}
+	ctx.forEachInDirectoryUri(scratchSavePath,
+		[](auto &entry)
+		{
+			FS::remove(entry.path());
+			return true;
+		});
+	FS::remove(scratchSavePath);
+	auto json = fmt::format("{{\n\t\"system\": \"{}\",\n\t\"warmupFrames\": {},\n\t\"frames\": {},\n\t\"results\":\n\t[\n{}\n\t]\n}}\n",
+		jsonEscaped(EmuSystem::shortSystemName()), params.warmupFrames, params.frames, results);
+	if(!params.outputPath)
+	{
+		std::fputs(json.c_str(), stdout);
+		std::fflush(stdout);
+	}
+	else if(FileUtils::writeToUri(app.appContext(), params.outputPath, {(const uint8_t*)json.data(), json.size()}) == -1)
+	{
+		logErr("error writing results to %s", params.outputPath);
+		return 1;
+	}
+	return hadError ? 1 : 0;
+}
+
+}
@@ -0,0 +1,190 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ContentCache"
+#include <emuframework/EmuContentCache.hh>
+#include <emuframework/EmuSystem.hh>
+#include <imagine/fs/ArchiveFS.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/util/format.hh>
+#include <imagine/util/math/int.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+namespace EmuEx
+{
+
+static constexpr std::string_view tempSuffix{".tmp"};
+static constexpr size_t copyBufferSize = 1024 * 1024;
+
+// FNV-1a, used instead of std::hash since the result must be stable across builds
+static uint64_t hashString(std::string_view str)
+{
+	uint64_t hash = 0xcbf29ce484222325;
+	for(auto c : str)
+	{
+		hash ^= (uint8_t)c;
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+EmuContentCache::EmuContentCache(IG::ApplicationContext ctx, uint64_t maxBytes):
+	ctx{ctx},
+	dir{FS::createDirectorySegments(ctx.cachePath(), "content")},
+	maxBytes{maxBytes} {}
+
+FS::FileString EmuContentCache::entryName(ArchiveIO &io, IG::CStringView archivePath, size_t archiveSize) const
+{
+	std::string_view name{io.name()};
+	auto key = fmt::format("{}\n{}\n{}\n{}\n{}\n{:08X}", archivePath, archiveSize,
+		ctx.fileUriLastWriteTime(archivePath), name, io.size(), io.crc32());
+	// keep the extension for cores that detect the content type from the cached file's path
+	auto dotOffset = name.rfind('.');
+	auto ext = dotOffset != name.npos ? name.substr(dotOffset) : std::string_view{};
+	return IG::format<FS::FileString>("{:016X}{}", hashString(key), ext);
+}
+
+static void reopenEntry(ArchiveIO &io)
+{
+	FS::FileString name{io.name()};
+	auto crc = io.crc32();
+	auto arch = io.releaseArchive();
+	arch.rewind();
+	for(auto &entry : FS::ArchiveIterator{std::move(arch)})
+	{
+		if(entry.name() == name && entry.crc32() == crc)
+		{
+			io = entry.moveIO();
+			return;
+		}
+	}
+	EmuSystem::throwFileReadError();
+}
+
+std::pair<FileIO, FS::PathString> EmuContentCache::open(ArchiveIO &io, IG::CStringView archivePath, size_t archiveSize,
+	EmuSystem::OnLoadProgressDelegate onLoadProgress)
+{
+	auto size = io.size();
+	if(!size || size > maxBytes)
+		return {};
+	auto name = entryName(io, archivePath, archiveSize);
+	auto path = FS::pathString(dir, name);
+	if(auto status = FS::status(path);
+		status.type() == FS::file_type::regular)
+	{
+		if(status.size() == size)
+		{
+			logMsg("using cached %s:%s", io.name().data(), path.data());
+			FS::last_write_time(path, std::time(nullptr));
+			return {FileIO{path, IO::AccessHint::NORMAL, IO::OPEN_TEST}, path};
+		}
+		logWarn("removing cache file with wrong size:%s", path.data());
+		FS::remove(path);
+	}
+	logMsg("caching %s (%zu bytes) to:%s", io.name().data(), size, path.data());
+	auto tempPath = path;
+	tempPath += tempSuffix;
+	{
+		auto cacheFile = FileIO::create(tempPath, IO::OPEN_TEST);
+		if(!cacheFile)
+		{
+			logErr("error creating cache file");
+			return {};
+		}
+		auto buff = std::make_unique<uint8_t[]>(copyBufferSize);
+		size_t bytesCopied{};
+		// progress is in KiB to fit the delegate's int range
+		onLoadProgress.callSafe(0, int(IG::divRoundUp(size, 1024)), "Decompressing...");
+		while(bytesCopied < size)
+		{
+			auto bytesRead = io.read(buff.get(), std::min(copyBufferSize, size - bytesCopied));
+			if(bytesRead <= 0)
+			{
+				FS::remove(tempPath);
+				EmuSystem::throwFileReadError();
+			}
+			if(cacheFile.write(buff.get(), bytesRead) != bytesRead)
+			{
+				logErr("error writing cache file, loading from archive");
+				cacheFile = {};
+				FS::remove(tempPath);
+				reopenEntry(io);
+				return {};
+			}
+			bytesCopied += bytesRead;
+			onLoadProgress.callSafe(int(bytesCopied / 1024), 0, nullptr);
+		}
+		onLoadProgress.callSafe(0, 0, ""); // back to the default label for the core's loading
+	}
+	if(!FS::rename(tempPath, path))
+	{
+		FS::remove(tempPath);
+		reopenEntry(io);
+		return {};
+	}
+	trim(name);
+	return {FileIO{path, IO::AccessHint::NORMAL, IO::OPEN_TEST}, path};
+}
+
+void EmuContentCache::trim(std::string_view keepName)
+{
+	struct CacheFile
+	{
+		FS::PathString path;
+		uint64_t size;
+		FS::file_time_type lastUseTime;
+	};
+	std::vector<CacheFile> files;
+	uint64_t totalSize{};
+	try
+	{
+		for(auto &entry : FS::directory_iterator{dir})
+		{
+			auto status = FS::status(entry.path());
+			if(status.type() != FS::file_type::regular)
+				continue;
+			if(entry.name().ends_with(tempSuffix))
+			{
+				// left over from an interrupted copy
+				FS::remove(entry.path());
+				continue;
+			}
+			totalSize += status.size();
+			if(entry.name() == keepName)
+				continue;
+			files.emplace_back(entry.path(), status.size(), status.lastWriteTime());
+		}
+	}
+	catch(std::exception &err)
+	{
+		logErr("error reading cache directory:%s", err.what());
+		return;
+	}
+	std::ranges::sort(files, {}, &CacheFile::lastUseTime);
+	for(const auto &f : files)
+	{
+		if(totalSize <= maxBytes)
+			break;
+		logMsg("removing least recently used:%s", f.path.data());
+		if(FS::remove(f.path))
+			totalSize -= f.size;
+	}
+}
+
+}
@@ -0,0 +1,265 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "FrameTiming"
+#include <emuframework/EmuFrameTimingStats.hh>
+#include <imagine/base/ApplicationContext.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/util/format.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <limits>
+
+namespace EmuEx
+{
+
+constexpr const char *stageName(EmuFrameTimingStats::Stage stage)
+{
+	using enum EmuFrameTimingStats::Stage;
+	switch(stage)
+	{
+		case FRAME_INTERVAL: return "Frame interval";
+		case EMULATION: return "Emulation";
+		case UPLOAD: return "Video upload";
+		case LATENCY: return "Frame start to present";
+		case INPUT_LATENCY: return "Input to emulated frame";
+	}
+	return "";
+}
+
+void EmuFrameTimingStats::setEnabled(bool on)
+{
+	if(on == isEnabled())
+		return;
+	if(on)
+	{
+		if(!records)
+			records = std::make_unique<Record[]>(HISTORY_FRAMES);
+		else
+			std::for_each_n(records.get(), HISTORY_FRAMES, [](auto &r){ r.clear(); });
+		frameCount.store(0, std::memory_order_relaxed);
+		emuFrameIdx.store(0, std::memory_order_relaxed);
+		enabled.store(true, std::memory_order_release);
+	}
+	else
+	{
+		// keep the records since the emulation thread may still be marking the last frame
+		enabled.store(false, std::memory_order_relaxed);
+	}
+	logMsg("%s frame timing stats", on ? "enabled" : "disabled");
+}
+
+void EmuFrameTimingStats::startFrame(IG::FrameTime vsyncTime)
+{
+	if(!isEnabled())
+		return;
+	auto idx = frameCount.load(std::memory_order_relaxed);
+	auto &r = record(idx);
+	r.clear();
+	r.vsyncTime.store(std::chrono::duration_cast<IG::Time>(vsyncTime).count(), std::memory_order_relaxed);
+	r.times[size_t(Event::FRAME_START)].store(IG::steadyClockTimestamp().count(), std::memory_order_relaxed);
+	frameCount.store(idx + 1, std::memory_order_release);
+}
+
+void EmuFrameTimingStats::markTime(Event e, IG::Time time)
+{
+	uint32_t idx;
+	if(e == Event::FRAME_START)
+	{
+		idx = frameCount.load(std::memory_order_relaxed) - 1;
+	}
+	else if(e == Event::INPUT_POLL)
+	{
+		// the emulation thread now works on the newest frame, later events of it use the same record
+		idx = frameCount.load(std::memory_order_acquire) - 1;
+		emuFrameIdx.store(idx, std::memory_order_relaxed);
+	}
+	else
+	{
+		idx = emuFrameIdx.load(std::memory_order_relaxed);
+	}
+	record(idx).times[size_t(e)].store(time.count(), std::memory_order_relaxed);
+}
+
+void EmuFrameTimingStats::markAudioFill(uint32_t frames)
+{
+	if(!isEnabled())
+		return;
+	record(emuFrameIdx.load(std::memory_order_relaxed)).audioFillFrames.store(frames, std::memory_order_relaxed);
+}
+
+void EmuFrameTimingStats::markInputTime(IG::Time time)
+{
+	if(!isEnabled())
+		return;
+	record(emuFrameIdx.load(std::memory_order_relaxed)).inputTime.store(time.count(), std::memory_order_relaxed);
+}
+
+void EmuFrameTimingStats::markUploadBytes(uint32_t bytes, uint32_t frameBytes)
+{
+	if(!isEnabled())
+		return;
+	auto &r = record(emuFrameIdx.load(std::memory_order_relaxed));
+	r.uploadBytes.store(bytes, std::memory_order_relaxed);
+	r.frameBytes.store(frameBytes, std::memory_order_relaxed);
+}
+
+int64_t EmuFrameTimingStats::stageTime(Stage stage, uint32_t frameIdx) const
+{
+	auto eventTime = [&](uint32_t idx, Event e){ return record(idx).times[size_t(e)].load(std::memory_order_relaxed); };
+	int64_t start{}, end{};
+	switch(stage)
+	{
+		case Stage::FRAME_INTERVAL:
+			start = eventTime(frameIdx - 1, Event::FRAME_START);
+			end = eventTime(frameIdx, Event::FRAME_START);
+			break;
+		case Stage::EMULATION:
+			start = eventTime(frameIdx, Event::RUN_START);
+			end = eventTime(frameIdx, Event::RUN_END);
+			break;
+		case Stage::UPLOAD:
+			start = eventTime(frameIdx, Event::FINISH_FRAME);
+			end = eventTime(frameIdx, Event::UPLOAD_END);
+			break;
+		case Stage::LATENCY:
+			start = eventTime(frameIdx, Event::FRAME_START);
+			end = eventTime(frameIdx, Event::PRESENT);
+			break;
+		case Stage::INPUT_LATENCY:
+			start = record(frameIdx).inputTime.load(std::memory_order_relaxed);
+			end = eventTime(frameIdx, Event::RUN_END);
+			break;
+	}
+	if(!start || end < start)
+		return -1;
+	return end - start;
+}
+
+void EmuFrameTimingStats::forEachStageTime(Stage stage, size_t frames, auto &&func) const
+{
+	if(!records)
+		return;
+	auto count = frameCount.load(std::memory_order_acquire);
+	// skip the oldest record since it's the next one cleared
+	auto n = std::min({size_t(count), frames, HISTORY_FRAMES - 1});
+	if(stage == Stage::FRAME_INTERVAL)
+		n = std::min(n, size_t(count ? count - 1 : 0));
+	for(auto idx = count - n; idx != count; idx++)
+	{
+		auto time = stageTime(stage, idx);
+		if(time >= 0)
+			func(time);
+	}
+}
+
+EmuFrameTimingStats::Histogram EmuFrameTimingStats::histogram(Stage stage, size_t frames) const
+{
+	Histogram hist{};
+	forEachStageTime(stage, frames, [&](int64_t time)
+	{
+		auto bucket = std::min(size_t(time / 1'000'000), HISTOGRAM_BUCKETS - 1);
+		hist[bucket]++;
+	});
+	return hist;
+}
+
+std::string EmuFrameTimingStats::summary(size_t frames) const
+{
+	std::string str;
+	for(auto stage : {Stage::FRAME_INTERVAL, Stage::EMULATION, Stage::UPLOAD, Stage::LATENCY, Stage::INPUT_LATENCY})
+	{
+		int64_t total{}, maxTime{};
+		size_t count{};
+		forEachStageTime(stage, frames, [&](int64_t time)
+		{
+			total += time;
+			maxTime = std::max(maxTime, time);
+			count++;
+		});
+		if(!count)
+			continue;
+		IG::formatTo(str, "{}: {:.2f}ms avg, {:.2f}ms max\n", stageName(stage),
+			total / double(count) / 1'000'000., maxTime / 1'000'000.);
+	}
+	if(records)
+	{
+		auto count = frameCount.load(std::memory_order_acquire);
+		auto n = std::min({size_t(count), frames, HISTORY_FRAMES - 1});
+		uint64_t total{};
+		uint32_t minFill = std::numeric_limits<uint32_t>::max();
+		size_t fills{};
+		uint64_t uploadBytes{}, frameBytes{};
+		size_t uploads{};
+		for(auto idx = count - n; idx != count; idx++)
+		{
+			auto &r = record(idx);
+			if(auto bytes = r.frameBytes.load(std::memory_order_relaxed); bytes)
+			{
+				uploadBytes += r.uploadBytes.load(std::memory_order_relaxed);
+				frameBytes += bytes;
+				uploads++;
+			}
+			auto fill = r.audioFillFrames.load(std::memory_order_relaxed);
+			if(!fill)
+				continue;
+			total += fill;
+			minFill = std::min(minFill, fill);
+			fills++;
+		}
+		if(uploads)
+			IG::formatTo(str, "Video upload: {:.1f}KB/frame avg, {:.0f}% of full frames\n",
+				uploadBytes / double(uploads) / 1024., uploadBytes * 100. / frameBytes);
+		if(fills)
+			IG::formatTo(str, "Audio buffer: {} frames avg, {} min\n", total / fills, minFill);
+	}
+	if(str.size())
+		str.pop_back();
+	return str;
+}
+
+void EmuFrameTimingStats::writeCSV(IG::ApplicationContext ctx, IG::CStringView path) const
+{
+	auto io = ctx.openFileUri(path, IG::IO::OPEN_CREATE);
+	std::string str{"frame,vsync_us,frame_start_us,input_poll_us,run_start_us,run_end_us,"
+		"finish_frame_us,upload_end_us,present_us,input_us,audio_fill_frames,upload_bytes\n"};
+	if(records)
+	{
+		auto count = frameCount.load(std::memory_order_acquire);
+		auto n = std::min(size_t(count), HISTORY_FRAMES - 1);
+		auto baseTime = record(count - n).times[size_t(Event::FRAME_START)].load(std::memory_order_relaxed);
+		auto relTime = [&](int64_t time)
+		{
+			if(!time)
+				return std::string{}; // event didn't happen this frame
+			return fmt::format("{:.1f}", (time - baseTime) / 1000.);
+		};
+		for(auto idx = count - n; idx != count; idx++)
+		{
+			auto &r = record(idx);
+			IG::formatTo(str, "{},{}", idx, relTime(r.vsyncTime.load(std::memory_order_relaxed)));
+			for(auto &t : r.times)
+			{
+				IG::formatTo(str, ",{}", relTime(t.load(std::memory_order_relaxed)));
+			}
+			IG::formatTo(str, ",{},{},{}\n", relTime(r.inputTime.load(std::memory_order_relaxed)),
+				r.audioFillFrames.load(std::memory_order_relaxed), r.uploadBytes.load(std::memory_order_relaxed));
+		}
+	}
+	io.write(str.data(), str.size());
+	logMsg("wrote frame timing log:%s", path.data());
+}
+
+}
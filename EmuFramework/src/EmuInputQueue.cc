@@ -0,0 +1,62 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuInputQueue.hh>
+#include <emuframework/EmuSystem.hh>
+
+namespace EmuEx
+{
+
+bool EmuInputQueue::push(std::span<const Event> newEvents)
+{
+	auto w = writeIdx.load(std::memory_order_relaxed);
+	auto r = readIdx.load(std::memory_order_acquire);
+	if(newEvents.size() > capacity - (w - r))
+		return false;
+	for(const auto &e : newEvents)
+	{
+		events[w++ % capacity] = e;
+	}
+	writeIdx.store(w, std::memory_order_release);
+	return true;
+}
+
+IG::Time EmuInputQueue::apply(EmuApp &app)
+{
+	auto r = readIdx.load(std::memory_order_relaxed);
+	auto w = writeIdx.load(std::memory_order_acquire);
+	if(r == w)
+		return {};
+	auto earliestTime = events[r % capacity].time;
+	for(; r != w; r++)
+	{
+		const auto &e = events[r % capacity];
+		EmuSystem::handleInputAction(&app, e.action, e.emuKey, e.metaState);
+	}
+	readIdx.store(r, std::memory_order_release);
+	return earliestTime;
+}
+
+void EmuInputQueue::clear()
+{
+	readIdx.store(writeIdx.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+bool EmuInputQueue::empty() const
+{
+	return readIdx.load(std::memory_order_acquire) == writeIdx.load(std::memory_order_acquire);
+}
+
+}
@@ -58,6 +58,7 @@ void EmuInputView::resetInput()
 	vController->resetInput();
 	#endif
 	ffToggleActive = false;
+	app().rewinder().setActive(false);
 }
 
 void EmuInputView::updateFastforward()
@@ -124,6 +125,14 @@ bool EmuInputView::inputEvent(const Input::Event &e)
 							logMsg("fast-forward state:%d", ffToggleActive);
 						}
 
+						bcase guiKeyIdxRewind:
+						{
+							if(isRepeated)
+								continue;
+							emuApp.rewinder().setActive(isPushed);
+							logMsg("rewind state:%d", isPushed);
+						}
+
 						bcase guiKeyIdxLoadGame:
 						if(isPushed)
 						{
@@ -264,4 +273,33 @@ bool EmuInputView::inputEvent(const Input::Event &e)
 	}, e.asVariant());
 }
 
+bool EmuInputView::queueDirectKeyInput(const Input::KeyEvent &keyEv, EmuInputQueue &queue)
+{
+	if(vController->isInKeyboardMode() || !keyEv.device())
+		return false;
+	const auto &actionTable = inputDevData(*keyEv.device()).actionTable;
+	if(!actionTable.size()) [[unlikely]]
+		return false;
+	const auto &actionGroup = actionTable[keyEv.mapKey()];
+	std::array<EmuInputQueue::Event, InputDeviceData::maxKeyActions> events;
+	size_t eventCount{};
+	for(auto action : actionGroup)
+	{
+		if(!action)
+			continue;
+		action--;
+		// UI & turbo actions take the normal path
+		if(action < Controls::systemKeyMapStart)
+			return false;
+		bool turbo;
+		unsigned sysAction = EmuSystem::translateInputAction(action, turbo);
+		if(turbo)
+			return false;
+		events[eventCount++] = {keyEv.time(), keyEv.metaKeyBits(), sysAction, keyEv.state()};
+	}
+	if(!eventCount)
+		return false;
+	return queue.push({events.data(), eventCount});
+}
+
 }
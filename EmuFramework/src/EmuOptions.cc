@@ -22,6 +22,7 @@
 #include "private.hh"
 #include "privateInput.hh"
 #include <imagine/base/ApplicationContext.hh>
+#include <imagine/audio/Resampler.hh>
 #include <imagine/gfx/Renderer.hh>
 #include <imagine/base/Screen.hh>
 #include <imagine/base/Window.hh>
@@ -67,7 +68,9 @@ Byte1Option optionSoundVolume(CFGKEY_SOUND_VOLUME,
 
 Byte1Option optionSoundBuffers(CFGKEY_SOUND_BUFFERS,
 	3, 0, optionIsValidWithMinMax<1, 7, uint8_t>);
-Byte1Option optionAddSoundBuffersOnUnderrun(CFGKEY_ADD_SOUND_BUFFERS_ON_UNDERRUN, 1, 0);
+Byte1Option optionAudioRateControl(CFGKEY_AUDIO_RATE_CONTROL, 1, 0);
+Byte1Option optionAudioResampler(CFGKEY_AUDIO_RESAMPLER,
+	(uint8_t)IG::Audio::Resampler::DEFAULT_QUALITY, 0, optionIsValidWithMax<(uint8_t)IG::Audio::ResamplerQuality::HIGH>);
 
 #ifdef CONFIG_AUDIO_MULTIPLE_SYSTEM_APIS
 Byte1Option optionAudioAPI(CFGKEY_AUDIO_API, 0);
@@ -154,6 +157,7 @@ Byte1Option optionFrameInterval
 	{CFGKEY_FRAME_INTERVAL,	1, !Config::envIsIOS, optionIsValidWithMinMax<1, 4>};
 #endif
 Byte1Option optionSkipLateFrames{CFGKEY_SKIP_LATE_FRAMES, 1, 0};
+Byte1Option optionShowFrameTimingStats{CFGKEY_SHOW_FRAME_TIMING_STATS, 0, 0};
 DoubleOption optionFrameRate{CFGKEY_FRAME_RATE, 0, 0, optionFrameTimeIsValid};
 DoubleOption optionFrameRatePAL{CFGKEY_FRAME_RATE_PAL, 1./50., !EmuSystem::hasPALVideoSystem, optionFrameTimePALIsValid};
 
@@ -173,6 +177,11 @@ Byte1Option optionSustainedPerformanceMode{CFGKEY_SUSTAINED_PERFORMANCE_MODE, 0}
 #endif
 
 Byte1Option optionShowBundledGames(CFGKEY_SHOW_BUNDLED_GAMES, 1);
+Byte2Option optionContentCacheSize{CFGKEY_CONTENT_CACHE_SIZE, 512, 0, optionIsValidWithMax<4096>};
+Byte1Option optionEmuThreadCPUAffinity{CFGKEY_EMU_THREAD_CPU_AFFINITY, 0, 0, optionIsValidWithMax<2>};
+Byte1Option optionRenderThreadCPUAffinity{CFGKEY_RENDER_THREAD_CPU_AFFINITY, 0, 0, optionIsValidWithMax<2>};
+Byte1Option optionEmuThreadPriority{CFGKEY_EMU_THREAD_PRIORITY, 0, 0, optionIsValidWithMax<2>};
+Byte1Option optionDirectKeyInput{CFGKEY_DIRECT_KEY_INPUT, 0, 0, optionIsValidWithMax<1>};
 
 void EmuApp::initOptions(IG::ApplicationContext ctx)
 {
@@ -274,6 +283,13 @@ void EmuApp::initOptions(IG::ApplicationContext ctx)
 		optionFrameRate.isConst = true;
 	}
 
+	if(!EmuSystem::handlesGenericIO)
+	{
+		// content is loaded by path, archives never pass through the content cache
+		optionContentCacheSize.initDefault(0);
+		optionContentCacheSize.isConst = true;
+	}
+
 	EmuSystem::initOptions(*this);
 }
 
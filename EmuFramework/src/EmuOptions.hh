@@ -78,13 +78,20 @@ enum { CFGKEY_SOUND = 0, CFGKEY_TOUCH_CONTROL_DISPLAY = 1,
 	CFGKEY_CONSUME_UNBOUND_GAMEPAD_KEYS = 86, CFGKEY_VIDEO_COLOR_SPACE = 87,
 	CFGKEY_RENDER_PIXEL_FORMAT = 88, CFGKEY_RUN_FRAMES_IN_THREAD = 89,
 	CFGKEY_SHOW_HIDDEN_FILES = 90, CFGKEY_RENDERER_PRESENTATION_TIME = 91,
+	CFGKEY_REWIND_BUFFER_SIZE = 92, CFGKEY_REWIND_FRAME_INTERVAL = 93,
+	CFGKEY_RUN_AHEAD_FRAMES = 94, CFGKEY_AUDIO_RESAMPLER = 95,
+	CFGKEY_AUDIO_RATE_CONTROL = 96, CFGKEY_SHOW_FRAME_TIMING_STATS = 97,
+	CFGKEY_CONTENT_CACHE_SIZE = 98, CFGKEY_EMU_THREAD_CPU_AFFINITY = 99,
+	CFGKEY_RENDER_THREAD_CPU_AFFINITY = 100, CFGKEY_EMU_THREAD_PRIORITY = 101,
+	CFGKEY_DIRECT_KEY_INPUT = 102,
 	// 256+ is reserved
 };
 
 extern Byte1Option optionSound;
 extern Byte1Option optionSoundVolume;
 extern Byte1Option optionSoundBuffers;
-extern Byte1Option optionAddSoundBuffersOnUnderrun;
+extern Byte1Option optionAudioRateControl;
+extern Byte1Option optionAudioResampler;
 #ifdef CONFIG_AUDIO_MULTIPLE_SYSTEM_APIS
 extern Byte1Option optionAudioAPI;
 #endif
@@ -124,6 +131,7 @@ extern Byte1Option optionMenuOrientation;
 extern Byte1Option optionFrameInterval;
 #endif
 extern Byte1Option optionSkipLateFrames;
+extern Byte1Option optionShowFrameTimingStats;
 extern DoubleOption optionFrameRate;
 extern DoubleOption optionFrameRatePAL;
 extern DoubleOption optionRefreshRateOverride;
@@ -143,6 +151,11 @@ extern Byte1Option optionVideoImageBuffers;
 static const char *optionSavePathDefaultToken = ":DEFAULT:";
 
 extern Byte1Option optionShowBundledGames;
+extern Byte2Option optionContentCacheSize;
+extern Byte1Option optionEmuThreadCPUAffinity;
+extern Byte1Option optionRenderThreadCPUAffinity;
+extern Byte1Option optionEmuThreadPriority;
+extern Byte1Option optionDirectKeyInput;
 
 bool soundIsEnabled();
 void setSoundEnabled(bool on);
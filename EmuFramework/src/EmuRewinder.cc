@@ -0,0 +1,287 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Rewind"
+#include <emuframework/EmuRewinder.hh>
+#include <emuframework/EmuSystem.hh>
+#include <imagine/util/utility.h>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cstring>
+#include <span>
+
+namespace EmuEx
+{
+
+// shortest run of unchanged bytes that ends a literal run in the delta encoding
+static constexpr size_t minZeroRun = 8;
+
+static constexpr size_t maxDeltaSize(size_t stateSize)
+{
+	// token pairs besides the first & last each cover at least minZeroRun + 1 bytes
+	return stateSize + stateSize / 4 + 16;
+}
+
+static uint8_t *writeVarint(uint8_t *out, uint32_t val)
+{
+	while(val >= 0x80)
+	{
+		*out++ = (val & 0x7F) | 0x80;
+		val >>= 7;
+	}
+	*out++ = val;
+	return out;
+}
+
+static const uint8_t *readVarint(const uint8_t *in, uint32_t &val)
+{
+	val = 0;
+	for(unsigned shift = 0;; shift += 7)
+	{
+		uint8_t b = *in++;
+		val |= uint32_t(b & 0x7F) << shift;
+		if(!(b & 0x80))
+			return in;
+	}
+}
+
+static size_t matchingBytes(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	size_t i = 0;
+	for(; i + 8 <= size; i += 8)
+	{
+		uint64_t aWord, bWord;
+		std::memcpy(&aWord, a + i, 8);
+		std::memcpy(&bWord, b + i, 8);
+		if(aWord != bWord)
+			break;
+	}
+	while(i < size && a[i] == b[i])
+		i++;
+	return i;
+}
+
+// Encodes newState ^ oldState as alternating (unchanged count, literal count, literal bytes) tokens
+static size_t encodeDelta(const uint8_t *newState, const uint8_t *oldState, size_t size, uint8_t *out)
+{
+	auto outStart = out;
+	size_t i = 0;
+	while(i < size)
+	{
+		size_t zeroRun = matchingBytes(newState + i, oldState + i, size - i);
+		i += zeroRun;
+		size_t litStart = i;
+		while(i < size)
+		{
+			if(newState[i] != oldState[i])
+			{
+				i++;
+				continue;
+			}
+			auto matchLen = matchingBytes(newState + i, oldState + i, std::min(minZeroRun, size - i));
+			if(matchLen == minZeroRun || i + matchLen == size)
+				break;
+			i += matchLen;
+		}
+		out = writeVarint(out, zeroRun);
+		out = writeVarint(out, i - litStart);
+		for(auto l = litStart; l < i; l++)
+		{
+			*out++ = newState[l] ^ oldState[l];
+		}
+	}
+	return out - outStart;
+}
+
+static void applyDelta(const uint8_t *delta, size_t deltaSize, uint8_t *state, [[maybe_unused]] size_t size)
+{
+	auto deltaEnd = delta + deltaSize;
+	size_t i = 0;
+	while(delta < deltaEnd)
+	{
+		uint32_t zeroRun, litRun;
+		delta = readVarint(delta, zeroRun);
+		delta = readVarint(delta, litRun);
+		i += zeroRun;
+		assumeExpr(i + litRun <= size);
+		for(auto end = i + litRun; i < end; i++)
+		{
+			state[i] ^= *delta++;
+		}
+	}
+}
+
+void EmuRewinder::setMemoryLimit(size_t bytes)
+{
+	if(bytes == ringCapacity)
+		return;
+	reset();
+	ringCapacity = bytes;
+	if(bytes)
+		logMsg("set buffer size:%zu", bytes);
+}
+
+void EmuRewinder::setFrameInterval(unsigned frames)
+{
+	frameInterval_ = std::clamp(frames, MIN_FRAME_INTERVAL, MAX_FRAME_INTERVAL);
+}
+
+void EmuRewinder::reset()
+{
+	ring = {};
+	packets = {};
+	currState = {};
+	scratchState = {};
+	deltaBuff = {};
+	ringWritePos = 0;
+	currStateSize = 0;
+	framesSinceCapture = 0;
+}
+
+size_t EmuRewinder::usedBytes() const
+{
+	size_t bytes = currStateSize;
+	for(const auto &p : packets)
+	{
+		bytes += p.size;
+	}
+	return bytes;
+}
+
+bool EmuRewinder::allocStateBuffers(size_t size)
+{
+	if(!size || size > UINT32_MAX)
+	{
+		logErr("unusable state size:%zu", size);
+		return false;
+	}
+	// newly added bytes are zero so states of different sizes can be XOR'd together
+	currState.resize(size);
+	scratchState.resize(size);
+	deltaBuff.resize(maxDeltaSize(size));
+	if(ring.size() != ringCapacity)
+		ring.resize(ringCapacity);
+	return true;
+}
+
+void EmuRewinder::addFrames(unsigned frames)
+{
+	if(!isEnabled())
+		return;
+	framesSinceCapture += frames;
+	if(framesSinceCapture < frameInterval_)
+		return;
+	capture();
+}
+
+void EmuRewinder::capture()
+{
+	framesSinceCapture = 0;
+	size_t size{};
+	try
+	{
+		if(scratchState.empty() && !allocStateBuffers(EmuSystem::stateSize()))
+		{
+			setMemoryLimit(0);
+			return;
+		}
+		try
+		{
+			size = EmuSystem::saveState(std::span<uint8_t>{scratchState});
+		}
+		catch(std::exception &)
+		{
+			// state may have outgrown the buffers, retry once with the updated size
+			auto newSize = EmuSystem::stateSize();
+			if(newSize <= scratchState.size() || !allocStateBuffers(newSize))
+				throw;
+			logMsg("state size increased to %zu", newSize);
+			size = EmuSystem::saveState(std::span<uint8_t>{scratchState});
+		}
+	}
+	catch(std::exception &err)
+	{
+		logErr("disabling rewind, error capturing state:%s", err.what());
+		setMemoryLimit(0);
+		return;
+	}
+	std::fill(scratchState.begin() + size, scratchState.end(), 0);
+	if(currStateSize)
+	{
+		auto deltaSize = encodeDelta(scratchState.data(), currState.data(),
+			std::max(size, currStateSize), deltaBuff.data());
+		pushPacket(deltaSize, currStateSize);
+	}
+	std::swap(currState, scratchState);
+	currStateSize = size;
+}
+
+void EmuRewinder::pushPacket(size_t size, size_t olderStateSize)
+{
+	if(size > ringCapacity) [[unlikely]]
+	{
+		logWarn("delta size:%zu exceeds buffer, dropping history", size);
+		packets.clear();
+		ringWritePos = 0;
+		return;
+	}
+	if(ringWritePos + size > ringCapacity)
+	{
+		// wrap around, any packets past the write position are the oldest
+		while(packets.size() && packets.front().offset >= ringWritePos)
+			packets.pop_front();
+		ringWritePos = 0;
+	}
+	while(packets.size() && packets.front().offset < ringWritePos + size
+		&& packets.front().offset + packets.front().size > ringWritePos)
+	{
+		packets.pop_front();
+	}
+	std::memcpy(&ring[ringWritePos], deltaBuff.data(), size);
+	packets.push_back({uint32_t(ringWritePos), uint32_t(size), uint32_t(olderStateSize)});
+	ringWritePos += size;
+}
+
+bool EmuRewinder::rewind()
+{
+	if(!currStateSize)
+		return false;
+	if(framesSinceCapture)
+	{
+		// return to the newest snapshot first
+		framesSinceCapture = 0;
+	}
+	else if(packets.size())
+	{
+		auto p = packets.back();
+		packets.pop_back();
+		applyDelta(&ring[p.offset], p.size, currState.data(), std::max(currStateSize, size_t(p.stateSize)));
+		currStateSize = p.stateSize;
+		ringWritePos = p.offset;
+	}
+	try
+	{
+		EmuSystem::loadState(std::span<const uint8_t>{currState.data(), currStateSize});
+	}
+	catch(std::exception &err)
+	{
+		logErr("error restoring state:%s", err.what());
+		reset();
+		return false;
+	}
+	return true;
+}
+
+}
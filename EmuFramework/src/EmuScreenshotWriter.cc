@@ -0,0 +1,159 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Screenshot"
+#include <emuframework/EmuScreenshotWriter.hh>
+#include <emuframework/EmuSystemTask.hh>
+#include <imagine/data-type/image/PixmapWriter.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/util/format.hh>
+#include <imagine/logger/logger.h>
+#include <charconv>
+
+namespace EmuEx
+{
+
+EmuScreenshotWriter::EmuScreenshotWriter(IG::ApplicationContext ctx,
+	const IG::Data::PixmapWriter &pixmapWriter, EmuSystemTask &systemTask):
+	ctx{ctx}, pixmapWriter{pixmapWriter}, systemTask{systemTask} {}
+
+EmuScreenshotWriter::~EmuScreenshotWriter()
+{
+	if(!thread.joinable())
+		return;
+	{
+		std::scoped_lock lock{mutex};
+		exiting = true;
+	}
+	jobsCond.notify_one();
+	thread.join();
+}
+
+void EmuScreenshotWriter::write(IG::Pixmap pix, FS::PathString dir, FS::FileString name)
+{
+	std::vector<char> pixData;
+	{
+		std::scoped_lock lock{mutex};
+		if(freeBuffers.size())
+		{
+			pixData = std::move(freeBuffers.back());
+			freeBuffers.pop_back();
+		}
+	}
+	// copy without any row padding so the buffer is independent of the source pitch
+	IG::PixmapDesc desc = pix;
+	pixData.resize(desc.bytes());
+	IG::Pixmap{desc, pixData.data()}.write(pix);
+	{
+		std::scoped_lock lock{mutex};
+		jobs.emplace_back(std::move(pixData), desc, std::move(dir), std::move(name));
+		if(!thread.joinable())
+		{
+			thread = std::thread{[this](){ run(); }};
+		}
+	}
+	jobsCond.notify_one();
+}
+
+void EmuScreenshotWriter::run()
+{
+	std::unique_lock lock{mutex};
+	while(true)
+	{
+		jobsCond.wait(lock, [this](){ return jobs.size() || exiting; });
+		if(jobs.empty())
+			return;
+		auto job = std::move(jobs.front());
+		jobs.pop_front();
+		lock.unlock();
+		writeJob(job);
+		lock.lock();
+		if(freeBuffers.size() < MAX_POOLED_BUFFERS)
+			freeBuffers.emplace_back(std::move(job.pixData));
+	}
+}
+
+void EmuScreenshotWriter::writeJob(const Job &job)
+{
+	auto num = nextFreeNumber(job);
+	if(num == -1)
+	{
+		logMsg("no screenshot filenames left");
+		systemTask.sendScreenshotReply(-1, false);
+		return;
+	}
+	auto path = IG::format<FS::PathString>("{}.{:03d}.png", FS::uriString(job.dir, job.name), num);
+	logMsg("writing screenshot %d", num);
+	auto success = pixmapWriter.writeToFile(IG::Pixmap{job.desc, (void*)job.pixData.data()}, path.data());
+	// a failed write leaves the number free to retry, if it left a partial file the next check skips it
+	if(success)
+		usedNumbers[num] = true;
+	systemTask.sendScreenshotReply(num, success);
+}
+
+int EmuScreenshotWriter::nextFreeNumber(const Job &job)
+{
+	auto basePath = FS::uriString(job.dir, job.name);
+	if(basePath != scannedBasePath)
+	{
+		scannedBasePath = basePath;
+		scanUsedNumbers(job);
+	}
+	for(int i = 0; i < MAX_SCREENSHOTS; i++)
+	{
+		if(usedNumbers[i])
+			continue;
+		// a single check catches files created since the scan
+		if(ctx.fileUriExists(IG::format<FS::PathString>("{}.{:03d}.png", basePath, i)))
+		{
+			usedNumbers[i] = true;
+			continue;
+		}
+		return i;
+	}
+	return -1;
+}
+
+void EmuScreenshotWriter::scanUsedNumbers(const Job &job)
+{
+	usedNumbers.reset();
+	std::string_view prefix{job.name};
+	try
+	{
+		ctx.forEachInDirectoryUri(job.dir,
+			[&](auto &entry)
+			{
+				// match "<name>.NNN.png"
+				std::string_view name = entry.name();
+				if(name.size() != prefix.size() + 8 || !name.starts_with(prefix)
+					|| name[prefix.size()] != '.' || !name.ends_with(".png"))
+					return true;
+				auto numStr = name.substr(prefix.size() + 1, 3);
+				int num{};
+				auto [ptr, ec] = std::from_chars(numStr.data(), numStr.data() + numStr.size(), num);
+				if(ec == std::errc{} && ptr == numStr.data() + numStr.size() && num < MAX_SCREENSHOTS)
+					usedNumbers[num] = true;
+				return true;
+			});
+	}
+	catch(std::exception &err)
+	{
+		// fall back to checking each file as it's used
+		logErr("error scanning %s:%s", job.dir.data(), err.what());
+	}
+	logMsg("%zu existing screenshots in:%s", usedNumbers.count(), job.dir.data());
+}
+
+}
@@ -19,6 +19,7 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAudio.hh>
 #include <emuframework/EmuVideo.hh>
+#include <emuframework/EmuContentCache.hh>
 #include "EmuTiming.hh"
 #include <imagine/base/ApplicationContext.hh>
 #include <imagine/fs/ArchiveFS.hh>
@@ -45,6 +46,7 @@ FS::PathString EmuSystem::firmwarePath_{};
 FS::FileString EmuSystem::contentName_{};
 std::string EmuSystem::contentDisplayName_{};
 FS::FileString EmuSystem::contentFileName_{};
+FS::PathString EmuSystem::contentCachePath_{};
 int EmuSystem::saveStateSlot = 0;
 [[gnu::weak]] bool EmuSystem::inputHasKeyboard = false;
 [[gnu::weak]] bool EmuSystem::inputHasShortBtnTexture = false;
@@ -60,6 +62,7 @@ IG::FloatSeconds EmuSystem::frameTimePAL{1./50.};
 [[gnu::weak]] bool EmuSystem::handlesArchiveFiles = false;
 [[gnu::weak]] bool EmuSystem::handlesGenericIO = true;
 [[gnu::weak]] bool EmuSystem::hasCheats = false;
+[[gnu::weak]] bool EmuSystem::hasSeamlessMemoryStates = true;
 [[gnu::weak]] bool EmuSystem::hasSound = true;
 [[gnu::weak]] int EmuSystem::forcedSoundRate = 0;
 [[gnu::weak]] IG::Audio::SampleFormat EmuSystem::audioSampleFormat = IG::Audio::SampleFormats::i16;
@@ -177,6 +180,7 @@ void EmuSystem::clearGamePaths()
 	contentFileName_ = {};
 	contentDirectory_ = {};
 	contentLocation_ = {};
+	contentCachePath_ = {};
 	contentSaveDirectory_ = {};
 }
 
@@ -240,6 +244,9 @@ void EmuSystem::closeRuntimeSystem(EmuApp &app, bool allowAutosaveState)
 		app.saveSessionOptions();
 		logMsg("closing game:%s", contentName_.data());
 		closeSystem(app.appContext());
+		app.directInputQueue().clear();
+		app.rewinder().reset();
+		app.clearRunAheadState();
 		app.cancelAutoSaveStateTimer();
 		state = State::OFF;
 	}
@@ -260,6 +267,7 @@ void EmuSystem::pause(EmuApp &app)
 {
 	if(isActive())
 		state = State::PAUSED;
+	app.directInputQueue().clear();
 	app.audio().stop();
 	app.cancelAutoSaveStateTimer();
 }
@@ -270,6 +278,7 @@ void EmuSystem::start(EmuApp &app)
 	if(inputHasKeyboard)
 		app.defaultVController().keyboard().setShiftActive(false);
 	clearInputBuffers(app.viewController().inputView());
+	app.directInputQueue().clear();
 	resetFrameTime();
 	app.audio().start(makeWantedAudioLatencyUSecs(optionSoundBuffers), makeWantedAudioLatencyUSecs(1));
 	app.startAutoSaveStateTimer();
@@ -418,6 +427,7 @@ void EmuSystem::loadGameFromFile(IG::ApplicationContext ctx, GenericIO file, IG:
 {
 	if(EmuApp::hasArchiveExtension(displayName))
 	{
+		auto archiveSize = file.size();
 		ArchiveIO io{};
 		FS::FileString originalName{};
 		for(auto &entry : FS::ArchiveIterator{std::move(file)})
@@ -441,6 +451,18 @@ void EmuSystem::loadGameFromFile(IG::ApplicationContext ctx, GenericIO file, IG:
 		}
 		closeAndSetupNew(ctx, path, displayName);
 		contentFileName_ = originalName;
+		if(optionContentCacheSize)
+		{
+			if(auto [cachedIO, cachedPath] = EmuContentCache{ctx, optionContentCacheSize * 1024ull * 1024ull}.open(io, path, archiveSize, onLoadProgress);
+				cachedIO)
+			{
+				contentCachePath_ = cachedPath;
+				EmuSystem::loadGame(ctx, cachedIO, params, onLoadProgress);
+				return;
+			}
+		}
+		// cores may seek anywhere in the content, avoid restarting decompression on backward seeks
+		io.setRandomAccess(ctx.cachePath());
 		EmuSystem::loadGame(ctx, io, params, onLoadProgress);
 	}
 	else
@@ -477,6 +499,14 @@ std::string EmuSystem::contentDisplayName()
 	return std::string{contentName_};
 }
 
+FS::PathString EmuSystem::contentFileLocation()
+{
+	// cores opening the content by path, like CD images, can't read it from inside an archive
+	if(contentCachePath_.size())
+		return contentCachePath_;
+	return contentLocation_;
+}
+
 FS::FileString EmuSystem::contentFileName()
 {
 	assert(contentFileName_.size());
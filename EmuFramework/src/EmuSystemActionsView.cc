@@ -24,6 +24,7 @@
 #include <emuframework/BundledGamesView.hh>
 #include <imagine/gui/AlertView.hh>
 #include <imagine/gui/TextEntry.hh>
+#include <imagine/fs/FS.hh>
 #include <imagine/base/ApplicationContext.hh>
 #include <imagine/util/format.hh>
 #include <imagine/logger/logger.h>
@@ -78,6 +79,7 @@ void EmuSystemActionsView::onShow()
 	loadState.setActive(EmuSystem::gameIsRunning() && EmuSystem::stateExists(appContext(), EmuSystem::saveStateSlot));
 	stateSlot.compile(makeStateSlotStr(EmuSystem::saveStateSlot), renderer(), projP);
 	screenshot.setActive(EmuSystem::gameIsRunning());
+	frameTimingLog.setActive(EmuSystem::gameIsRunning() && app().frameTimingStats().isEnabled());
 	#ifdef CONFIG_EMUFRAMEWORK_ADD_LAUNCHER_ICON
 	addLauncherIcon.setActive(EmuSystem::gameIsRunning());
 	#endif
@@ -100,6 +102,7 @@ void EmuSystemActionsView::loadStandardItems()
 	item.emplace_back(&addLauncherIcon);
 	#endif
 	item.emplace_back(&screenshot);
+	item.emplace_back(&frameTimingLog);
 	item.emplace_back(&resetSessionOptions);
 	item.emplace_back(&close);
 }
@@ -249,6 +252,27 @@ EmuSystemActionsView::EmuSystemActionsView(ViewAttachParams attach, bool customM
 			pushAndShowModal(std::move(ynAlertView), e);
 		}
 	},
+	frameTimingLog
+	{
+		"Save Frame Timing Log", &defaultFace(),
+		[this]()
+		{
+			if(!EmuSystem::gameIsRunning() || !app().frameTimingStats().isEnabled())
+				return;
+			auto path = FS::uriString(EmuSystem::contentSaveDirectory(),
+				EmuSystem::contentName().append(".frameTiming.csv"));
+			try
+			{
+				app().frameTimingStats().writeCSV(appContext(), path);
+				app().postMessage(fmt::format("Wrote log to folder {}",
+					appContext().fileUriDisplayName(EmuSystem::contentSaveDirectory())));
+			}
+			catch(std::exception &err)
+			{
+				app().postErrorMessage(fmt::format("Error writing log:\n{}", err.what()));
+			}
+		}
+	},
 	resetSessionOptions
 	{
 		"Reset Saved Options", &defaultFace(),
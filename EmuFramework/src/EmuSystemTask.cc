@@ -31,52 +31,42 @@ void EmuSystemTask::start()
 {
 	if(taskThread.joinable())
 		return;
-	taskThread = IG::makeThreadSync(
+	taskThread = IG::makeThreadSync(EmuApp::emuThreadAttributes(),
 		[this](auto &sem)
 		{
-			auto eventLoop = IG::EventLoop::makeForThread();
-			bool started = true;
-			commandPort.attach(eventLoop,
-				[this, &started](auto msgs)
+			threadId = IG::thisThreadId();
+			sem.release();
+			logMsg("starting thread message loop");
+			while(true)
+			{
+				auto msg = commandPort.receive();
+				switch(msg.command)
 				{
-					for(auto msg : msgs)
+					bcase Command::RUN_FRAME:
 					{
-						switch(msg.command)
-						{
-							bcase Command::RUN_FRAME:
-							{
-								auto frames = msg.args.run.frames;
-								assumeExpr(frames);
-								//logMsg("running %d frame(s)", frames);
-								app().runFrames({this, msg.semPtr}, msg.args.run.video, msg.args.run.audio,
-									frames, msg.args.run.skipForward);
-							}
-							bcase Command::PAUSE:
-							{
-								//logMsg("got pause command");
-								assumeExpr(msg.semPtr);
-								msg.semPtr->release();
-							}
-							bcase Command::EXIT:
-							{
-								//logMsg("got exit command");
-								started = false;
-								IG::EventLoop::forThread().stop();
-								return false;
-							}
-							bdefault:
-							{
-								logWarn("unknown CommandMessage value:%d", (int)msg.command);
-							}
-						}
+						auto frames = msg.args.run.frames;
+						assumeExpr(frames);
+						//logMsg("running %d frame(s)", frames);
+						app().runFrames({this, msg.semPtr}, msg.args.run.video, msg.args.run.audio,
+							frames, msg.args.run.skipForward);
 					}
-					return true;
-				});
-			sem.release();
-			logMsg("starting thread event loop");
-			eventLoop.run(started);
-			logMsg("exiting thread");
-			commandPort.detach();
+					bcase Command::PAUSE:
+					{
+						//logMsg("got pause command");
+						assumeExpr(msg.semPtr);
+						msg.semPtr->release();
+					}
+					bcase Command::EXIT:
+					{
+						logMsg("exiting thread");
+						return;
+					}
+					bdefault:
+					{
+						logWarn("unknown CommandMessage value:%d", (int)msg.command);
+					}
+				}
+			}
 		});
 }
 
@@ -146,6 +136,13 @@ void EmuSystemTask::sendScreenshotReply(int num, bool success)
 		});
 }
 
+void EmuSystemTask::setThreadAttributes(IG::ThreadAttributes attrs)
+{
+	if(!taskThread.joinable())
+		return;
+	IG::setThreadAttributes(threadId, attrs);
+}
+
 EmuApp &EmuSystemTask::app() const
 {
 	return *appPtr;
@@ -20,10 +20,18 @@
 #include <imagine/gfx/RendererTask.hh>
 #include <imagine/gfx/RendererCommands.hh>
 #include <imagine/logger/logger.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 
 namespace EmuEx
 {
 
+// after this many frames in a row with every line changed, stop hashing rows for a while
+constexpr uint8_t maxFullyDirtyFrames = 30;
+constexpr uint8_t skipRowHashFramesOnFullyDirty = 120;
+
 void EmuVideo::resetImage(IG::PixelFormat newFmt)
 {
 	if(!vidImg)
@@ -40,6 +48,7 @@ IG::PixmapDesc EmuVideo::deleteImage()
 {
 	auto desc = vidImg.usedPixmapDesc();
 	vidImg = {};
+	invalidateRowHashes();
 	return desc;
 }
 
@@ -76,6 +85,7 @@ bool EmuVideo::setFormat(IG::PixmapDesc desc, EmuSystemTaskContext taskCtx)
 	{
 		vidImg.setFormat(desc, colSpace, texSampler);
 	}
+	invalidateRowHashes();
 	logMsg("resized to:%dx%d", desc.w(), desc.h());
 	if(taskCtx)
 	{
@@ -163,9 +173,15 @@ void EmuVideo::finishFrame(EmuSystemTaskContext taskCtx, Gfx::LockedTextureBuffe
 {
 	if(screenshotNextFrame) [[unlikely]]
 	{
-		doScreenshot(taskCtx, texBuff.pixmap());
+		doScreenshot(texBuff.pixmap());
 	}
+	auto &timingStats = app().frameTimingStats();
+	timingStats.mark(EmuFrameTimingStats::Event::FINISH_FRAME);
 	vidImg.unlock(texBuff);
+	timingStats.mark(EmuFrameTimingStats::Event::UPLOAD_END);
+	auto frameBytes = texBuff.pixmap().unpaddedBytes();
+	timingStats.markUploadBytes(frameBytes, frameBytes);
+	invalidateRowHashes();
 	postFrameFinished(taskCtx);
 }
 
@@ -173,13 +189,115 @@ void EmuVideo::finishFrame(EmuSystemTaskContext taskCtx, IG::Pixmap pix)
 {
 	if(screenshotNextFrame) [[unlikely]]
 	{
-		doScreenshot(taskCtx, pix);
+		doScreenshot(pix);
 	}
-	syncImageAccess();
-	vidImg.write(pix, vidImg.WRITE_FLAG_ASYNC);
+	auto &timingStats = app().frameTimingStats();
+	timingStats.mark(EmuFrameTimingStats::Event::FINISH_FRAME);
+	auto [start, end] = dirtyRows(pix);
+	auto rowBytes = pix.format().pixelBytes(pix.w());
+	if(start < end)
+	{
+		syncImageAccess();
+		if(start == 0 && end == pix.h())
+			vidImg.write(pix, vidImg.WRITE_FLAG_ASYNC);
+		else
+			vidImg.writeSubRegion(pix.subView({0, start}, {pix.w(), end - start}), {0, start}, vidImg.WRITE_FLAG_ASYNC);
+	}
+	timingStats.mark(EmuFrameTimingStats::Event::UPLOAD_END);
+	timingStats.markUploadBytes(rowBytes * std::max(end - start, 0), rowBytes * pix.h());
 	postFrameFinished(taskCtx);
 }
 
+void EmuVideo::setDirtyRows(int start, int end)
+{
+	coreDirtyStart = std::clamp(start, 0, size().y);
+	coreDirtyEnd = std::clamp(end, 0, size().y);
+}
+
+static uint64_t hashRow(const char *data, size_t bytes)
+{
+	// multiply-xor over 4 independent lanes, each step is invertible so a change in
+	// a single word always changes the result
+	constexpr uint64_t prime = 0x9E3779B97F4A7C15;
+	std::array<uint64_t, 4> h{1, 2, 3, 4};
+	auto mix = [](uint64_t h, uint64_t w){ return std::rotl((h ^ w) * prime, 31); };
+	for(; bytes >= 32; data += 32, bytes -= 32)
+	{
+		std::array<uint64_t, 4> w;
+		std::memcpy(w.data(), data, 32);
+		for(size_t i = 0; i < 4; i++)
+		{
+			h[i] = mix(h[i], w[i]);
+		}
+	}
+	for(size_t i = 0; bytes; i++)
+	{
+		uint64_t w{};
+		auto wordBytes = std::min(bytes, sizeof(w));
+		std::memcpy(&w, data, wordBytes);
+		h[i] = mix(h[i], w);
+		data += wordBytes;
+		bytes -= wordBytes;
+	}
+	return h[0] ^ std::rotl(h[1], 16) ^ std::rotl(h[2], 32) ^ std::rotl(h[3], 48);
+}
+
+std::pair<int, int> EmuVideo::dirtyRows(IG::Pixmap pix)
+{
+	const int rows = pix.h();
+	if(coreDirtyStart != -1)
+	{
+		int start = std::min(std::exchange(coreDirtyStart, -1), rows);
+		int end = std::min(coreDirtyEnd, rows);
+		rowHashes.clear();
+		if(!vidImg.canWriteSubRegion() && start < end)
+			return {0, rows};
+		return {start, end};
+	}
+	if(!vidImg.canWriteSubRegion())
+		return {0, rows};
+	if(skipRowHashFrames)
+	{
+		skipRowHashFrames--;
+		return {0, rows};
+	}
+	bool hashesValid = !rowHashesInvalid.exchange(false, std::memory_order_acquire) && int(rowHashes.size()) == rows;
+	if(!hashesValid)
+		rowHashes.resize(rows);
+	const auto rowBytes = pix.format().pixelBytes(pix.w());
+	int start = rows, end = 0;
+	for(int y = 0; y < rows; y++)
+	{
+		auto hash = hashRow(pix.data() + y * pix.pitchBytes(), rowBytes);
+		if(!hashesValid || hash != rowHashes[y])
+		{
+			rowHashes[y] = hash;
+			start = std::min(start, y);
+			end = y + 1;
+		}
+	}
+	if(start == 0 && end == rows)
+	{
+		if(++fullyDirtyFrames == maxFullyDirtyFrames)
+		{
+			// content changes every frame, hashing only adds overhead
+			fullyDirtyFrames = 0;
+			skipRowHashFrames = skipRowHashFramesOnFullyDirty;
+			rowHashes.clear();
+		}
+	}
+	else
+	{
+		fullyDirtyFrames = 0;
+	}
+	return {start, end};
+}
+
+void EmuVideo::invalidateRowHashes()
+{
+	rowHashesInvalid.store(true, std::memory_order_release);
+}
+
 bool EmuVideo::addFence(Gfx::RendererCommands &cmds)
 {
 	if(!needsFence)
@@ -193,6 +311,7 @@ void EmuVideo::clear()
 	if(!vidImg)
 		return;
 	vidImg.clear();
+	invalidateRowHashes();
 }
 
 void EmuVideo::takeGameScreenshot()
@@ -200,33 +319,10 @@ void EmuVideo::takeGameScreenshot()
 	screenshotNextFrame = true;
 }
 
-void EmuVideo::doScreenshot(EmuSystemTaskContext taskCtx, IG::Pixmap pix)
+void EmuVideo::doScreenshot(IG::Pixmap pix)
 {
 	screenshotNextFrame = false;
-	auto [screenshotNum, path] = app().makeNextScreenshotFilename();
-	if(screenshotNum == -1)
-	{
-		if(taskCtx)
-		{
-			taskCtx.task().sendScreenshotReply(-1, false);
-		}
-		else
-		{
-			app().printScreenshotResult(-1, false);
-		}
-	}
-	else
-	{
-		auto success = app().writeScreenshot(pix, path);
-		if(taskCtx)
-		{
-			taskCtx.task().sendScreenshotReply(screenshotNum, success);
-		}
-		else
-		{
-			app().printScreenshotResult(screenshotNum, success);
-		}
-	}
+	app().screenshotWriter().write(pix, EmuSystem::contentSaveDirectory(), EmuSystem::contentName());
 }
 
 bool EmuVideo::isExternalTexture() const
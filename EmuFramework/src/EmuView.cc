@@ -16,6 +16,9 @@
 #include <emuframework/EmuView.hh>
 #include <emuframework/EmuVideoLayer.hh>
 #include <imagine/input/Input.hh>
+#include <imagine/gfx/RendererCommands.hh>
+#include <imagine/gui/ViewManager.hh>
+#include <imagine/util/algorithm.h>
 #include <algorithm>
 
 namespace EmuEx
@@ -30,9 +33,7 @@ EmuView::EmuView(ViewAttachParams attach, EmuVideoLayer *layer):
 
 void EmuView::prepareDraw()
 {
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsText.makeGlyphs(renderer());
-	#endif
+	statsText.makeGlyphs(renderer());
 }
 
 void EmuView::draw(Gfx::RendererCommands &cmds)
@@ -42,19 +43,42 @@ void EmuView::draw(Gfx::RendererCommands &cmds)
 	{
 		layer->draw(cmds, projP);
 	}
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	if(audioStatsText.isVisible())
+	if(statsText.isVisible())
 	{
 		cmds.setCommonProgram(CommonProgram::NO_TEX);
 		cmds.setBlendMode(BLEND_MODE_ALPHA);
 		cmds.setColor(0., 0., 0., .7);
-		GeomRect::draw(cmds, audioStatsRect);
+		GeomRect::draw(cmds, statsRect);
+		auto histHalf = histRect;
+		histHalf.y = histRect.yCenter();
+		cmds.setColor(0., 1., 0., 1.);
+		drawHistogram(cmds, statsHist[0], histHalf);
+		histHalf.y2 = histRect.yCenter();
+		histHalf.y = histRect.y;
+		cmds.setColor(1., 1., 0., 1.);
+		drawHistogram(cmds, statsHist[1], histHalf);
 		cmds.setColor(1., 1., 1., 1.);
 		cmds.setCommonProgram(CommonProgram::TEX_ALPHA);
-		audioStatsText.draw(cmds, projP.alignXToPixel(audioStatsRect.x + TableView::globalXIndent),
-			projP.alignYToPixel(audioStatsRect.yCenter()), LC2DO, projP);
+		statsText.draw(cmds, projP.alignXToPixel(statsRect.x + manager().tableXIndent()),
+			projP.alignYToPixel(statsRect.y2 - statsText.nominalHeight() * .5f), LT2DO, projP);
+	}
+}
+
+void EmuView::drawHistogram(Gfx::RendererCommands &cmds, const EmuFrameTimingStats::Histogram &hist, Gfx::GCRect rect) const
+{
+	auto maxCount = std::ranges::max(hist);
+	if(!maxCount)
+		return;
+	auto barWidth = rect.xSize() / hist.size();
+	auto barHeight = rect.ySize() * .9f;
+	iterateTimes(hist.size(), i)
+	{
+		if(!hist[i])
+			continue;
+		auto x = rect.x + barWidth * i;
+		auto height = std::max(barHeight * hist[i] / maxCount, projP.unprojectYSize(1));
+		Gfx::GeomRect::draw(cmds, Gfx::makeGCRectRel({x, rect.y}, {barWidth * .8f, height}));
 	}
-	#endif
 }
 
 void EmuView::place()
@@ -63,14 +87,18 @@ void EmuView::place()
 	{
 		layer->place(viewRect(), projP, inputView);
 	}
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	if(audioStatsText.compile(renderer(), projP))
+	if(statsText.compile(renderer(), projP))
 	{
-		audioStatsRect = projP.bounds();
-		audioStatsRect.y2 = (audioStatsRect.y + audioStatsText.nominalHeight * audioStatsText.lines)
-			+ audioStatsText.nominalHeight * .5f; // adjust to bottom
+		// text above two histograms, anchored to the bottom left corner
+		auto lineHeight = statsText.nominalHeight();
+		auto indent = manager().tableXIndent();
+		auto histWidth = std::min(lineHeight * 16, projP.width() - indent * 2);
+		statsRect = projP.bounds();
+		statsRect.x2 = statsRect.x + std::max(statsText.width(), histWidth) + indent * 2;
+		histRect = Gfx::makeGCRectRel({statsRect.x + indent, statsRect.y + lineHeight * .5f},
+			{histWidth, lineHeight * 4});
+		statsRect.y2 = histRect.y2 + lineHeight * (statsText.currentLines() + .5f);
 	}
-	#endif
 }
 
 bool EmuView::inputEvent(const Input::Event &e)
@@ -83,20 +111,20 @@ void EmuView::setLayoutInputView(EmuInputView *view)
 	inputView = view;
 }
 
-void EmuView::updateAudioStats(unsigned underruns, unsigned overruns, unsigned callbacks, double avgCallbackFrames, unsigned frames)
+void EmuView::updateStats(std::string_view text, const EmuFrameTimingStats::Histogram &intervalHist,
+	const EmuFrameTimingStats::Histogram &latencyHist)
 {
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsText.setString(fmt::format("Underruns:{}\nOverruns:{}\nCallbacks per second:{}\nFrames per callback:{:.2f}\nTotal frames:{}",
-		underruns, overruns, callbacks, avgCallbackFrames, frames), &View::defaultFace);
+	if(!statsText.face())
+		statsText.setFace(&defaultFace());
+	statsText.setString(text);
+	statsHist = {intervalHist, latencyHist};
+	statsText.makeGlyphs(renderer());
 	place();
-	#endif
 }
 
-void EmuView::clearAudioStats()
+void EmuView::clearStats()
 {
-	#ifdef CONFIG_EMUFRAMEWORK_AUDIO_STATS
-	audioStatsText.setString(nullptr);
-	#endif
+	statsText.setString(u"");
 }
 
 }
@@ -158,13 +158,16 @@ EmuViewController::EmuViewController(ViewAttachParams viewAttach,
 		[this](IG::Window &win, IG::Window::DrawParams params)
 		{
 			auto &winData = windowData(win);
-			return rendererTask().draw(win, params, {}, winData.viewport(), winData.projection.matrix(),
+			bool didDraw = rendererTask().draw(win, params, {}, winData.viewport(), winData.projection.matrix(),
 				[this](IG::Window &win, Gfx::RendererCommands &cmds)
 				{
 					auto &winData = windowData(win);
 					cmds.clear();
 					drawMainWindow(win, cmds, winData.hasEmuView, winData.hasPopup);
 				});
+			if(showingEmulation && winData.hasEmuView)
+				app().frameTimingStats().mark(EmuFrameTimingStats::Event::PRESENT);
+			return didDraw;
 		});
 
 	initViews(viewAttach);
@@ -268,6 +271,7 @@ void EmuViewController::initViews(ViewAttachParams viewAttach)
 			{
 				return true;
 			}
+			app().frameTimingStats().startFrame(params.timestamp());
 			if(!optionSkipLateFrames && !fastForwarding)
 			{
 				frameInfo.advanced = currentFrameInterval();
@@ -568,7 +572,7 @@ void EmuViewController::setEmuViewOnExtraWindow(bool on, IG::Screen &screen)
 					[this](IG::Window &win, IG::Window::DrawParams params)
 					{
 						auto &winData = windowData(win);
-						return rendererTask().draw(win, params, {}, winData.viewport(), winData.projection.matrix(),
+						bool didDraw = rendererTask().draw(win, params, {}, winData.viewport(), winData.projection.matrix(),
 							[this, &winData](IG::Window &win, Gfx::RendererCommands &cmds)
 							{
 								cmds.clear();
@@ -579,6 +583,9 @@ void EmuViewController::setEmuViewOnExtraWindow(bool on, IG::Screen &screen)
 								}
 								cmds.present();
 							});
+						if(showingEmulation)
+							app().frameTimingStats().mark(EmuFrameTimingStats::Event::PRESENT);
+						return didDraw;
 					});
 
 				win.setOnInputEvent(
@@ -670,14 +677,36 @@ void EmuViewController::updateWindowViewport(IG::Window &win, IG::Window::Surfac
 	}
 }
 
-void EmuViewController::updateEmuAudioStats(unsigned underruns, unsigned overruns, unsigned callbacks, double avgCallbackFrames, unsigned frames)
+void EmuViewController::startFrameTimingStats()
 {
-	emuView.updateAudioStats(underruns, overruns, callbacks, avgCallbackFrames, frames);
+	if(!app().frameTimingStats().isEnabled())
+		return;
+	frameTimingStatsTimer.runIn(IG::Seconds{1}, IG::Seconds{1}, {},
+		[this]()
+		{
+			updateFrameTimingStats();
+			return true;
+		});
+}
+
+void EmuViewController::stopFrameTimingStats()
+{
+	if(!frameTimingStatsTimer.isArmed())
+		return;
+	frameTimingStatsTimer.cancel();
+	emuView.clearStats();
 }
 
-void EmuViewController::clearEmuAudioStats()
+void EmuViewController::updateFrameTimingStats()
 {
-	emuView.clearAudioStats();
+	using Stage = EmuFrameTimingStats::Stage;
+	auto &stats = app().frameTimingStats();
+	auto text = stats.summary();
+	auto audioStats = emuAudio().stats();
+	IG::formatTo(text, "\nAudio underruns: {}, overruns: {}", audioStats.underruns, audioStats.overruns);
+	text += "\nHistograms (1ms per bar): green frame interval, yellow frame start to present";
+	emuView.updateStats(text, stats.histogram(Stage::FRAME_INTERVAL), stats.histogram(Stage::LATENCY));
+	postDrawToEmuWindows();
 }
 
 bool EmuViewController::allWindowsAreFocused() const
@@ -758,6 +787,7 @@ void EmuViewController::startEmulation()
 	EmuSystem::start(*appPtr);
 	videoLayer().setBrightness(1.f);
 	addOnFrameDelayed();
+	startFrameTimingStats();
 }
 
 void EmuViewController::pauseEmulation()
@@ -770,6 +800,7 @@ void EmuViewController::pauseEmulation()
 	setFastForwardSpeed(0);
 	emuWindow().setDrawEventPriority();
 	removeOnFrame();
+	stopFrameTimingStats();
 }
 
 void EmuViewController::closeSystem(bool allowAutosaveState)
@@ -903,6 +934,8 @@ void EmuViewController::onInputDevicesChanged()
 void EmuViewController::onSystemCreated()
 {
 	EmuSystem::prepareAudio(emuAudio());
+	appPtr->configRewinder();
+	appPtr->clearRunAheadState();
 	viewStack.navView()->showRightBtn(true);
 }
 
@@ -1003,7 +1036,6 @@ void EmuViewController::setFastForwardSpeed(int speed)
 {
 	bool active = speed > 1;
 	targetFastForwardSpeed = speed;
-	emuAudio().setAddSoundBuffersOnUnderrun(active ? optionAddSoundBuffersOnUnderrun.val : false);
 	auto soundVolume = (active && !soundDuringFastForwardIsEnabled()) ? 0 : optionSoundVolume.val;
 	emuAudio().setVolume(soundVolume);
 }
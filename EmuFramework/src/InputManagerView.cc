@@ -464,6 +464,18 @@ InputManagerOptionsView::InputManagerOptionsView(ViewAttachParams attach, EmuInp
 			app().setSwappedConfirmKeys(item.flipBoolValue(*this));
 		}
 	},
+	#ifdef CONFIG_INPUT_EVDEV
+	directKeyInput
+	{
+		"Low Latency Gamepad Input", &defaultFace(),
+		(bool)optionDirectKeyInput,
+		[this](BoolMenuItem &item)
+		{
+			optionDirectKeyInput = item.flipBoolValue(*this);
+			app().setDirectKeyInput(optionDirectKeyInput);
+		}
+	},
+	#endif
 	emuInputView{emuInputView_}
 {
 	if constexpr(Config::EmuFramework::MOGA_INPUT)
@@ -471,6 +483,9 @@ InputManagerOptionsView::InputManagerOptionsView(ViewAttachParams attach, EmuInp
 		item.emplace_back(&mogaInputSystem);
 	}
 	item.emplace_back(&altGamepadConfirm);
+	#ifdef CONFIG_INPUT_EVDEV
+	item.emplace_back(&directKeyInput);
+	#endif
 	#if 0
 	if(Input::hasTrackball())
 	{
@@ -16,6 +16,7 @@
 #include <emuframework/OptionView.hh>
 #include <emuframework/EmuApp.hh>
 #include <emuframework/FilePicker.hh>
+#include <emuframework/EmuContentCache.hh>
 #include "EmuOptions.hh"
 #include <imagine/base/ApplicationContext.hh>
 #include <imagine/gui/TextTableView.hh>
@@ -112,6 +113,71 @@ TextMenuItem::SelectDelegate SystemOptionView::setFastForwardSpeedDel(int val)
 	return [this, val]() { app().fastForwardSpeedOption() = val; };
 }
 
+TextMenuItem::SelectDelegate SystemOptionView::setRewindBufferSizeDel(int val)
+{
+	return [this, val]()
+	{
+		app().rewindBufferSizeOption() = val;
+		if(EmuSystem::gameIsRunning())
+			app().configRewinder();
+		logMsg("set rewind buffer size:%uMB", val);
+	};
+}
+
+TextMenuItem::SelectDelegate SystemOptionView::setRewindFrameIntervalDel(int val)
+{
+	return [this, val]()
+	{
+		app().rewindFrameIntervalOption() = val;
+		if(EmuSystem::gameIsRunning())
+			app().configRewinder();
+		logMsg("set rewind frame interval:%u", val);
+	};
+}
+
+TextMenuItem::SelectDelegate SystemOptionView::setRunAheadFramesDel(int val)
+{
+	return [this, val]() { app().runAheadFramesOption() = val; };
+}
+
+TextMenuItem::SelectDelegate SystemOptionView::setContentCacheSizeDel(int val)
+{
+	return [this, val]()
+	{
+		optionContentCacheSize = val;
+		// remove files over the new limit now instead of on the next cached load
+		EmuContentCache{appContext(), val * 1024ull * 1024ull}.trim();
+		logMsg("set content cache size:%uMB", val);
+	};
+}
+
+TextMenuItem::SelectDelegate SystemOptionView::setEmuThreadCPUAffinityDel(int val)
+{
+	return [this, val]()
+	{
+		optionEmuThreadCPUAffinity = val;
+		app().applyThreadAttributes();
+	};
+}
+
+TextMenuItem::SelectDelegate SystemOptionView::setRenderThreadCPUAffinityDel(int val)
+{
+	return [this, val]()
+	{
+		optionRenderThreadCPUAffinity = val;
+		app().applyThreadAttributes();
+	};
+}
+
+TextMenuItem::SelectDelegate SystemOptionView::setEmuThreadPriorityDel(int val)
+{
+	return [this, val]()
+	{
+		optionEmuThreadPriority = val;
+		app().applyThreadAttributes();
+	};
+}
+
 static auto makePathMenuEntryStr(IG::ApplicationContext ctx, std::string_view savePath)
 {
 	return fmt::format("Save Path: {}", savePathStrToDescStr(ctx, savePath));
@@ -292,6 +358,134 @@ SystemOptionView::SystemOptionView(ViewAttachParams attach, bool customMenu):
 			return 0;
 		}(),
 		fastForwardSpeedItem
+	},
+	rewindBufferSizeItem
+	{
+		{"Off",   &defaultFace(), setRewindBufferSizeDel(0)},
+		{"8MB",   &defaultFace(), setRewindBufferSizeDel(8)},
+		{"16MB",  &defaultFace(), setRewindBufferSizeDel(16)},
+		{"32MB",  &defaultFace(), setRewindBufferSizeDel(32)},
+		{"64MB",  &defaultFace(), setRewindBufferSizeDel(64)},
+		{"128MB", &defaultFace(), setRewindBufferSizeDel(128)},
+	},
+	rewindBufferSize
+	{
+		"Rewind Buffer Size", &defaultFace(),
+		[this]()
+		{
+			switch(app().rewindBufferSizeOption().val)
+			{
+				default: return 0;
+				case 8: return 1;
+				case 16: return 2;
+				case 32: return 3;
+				case 64: return 4;
+				case 128: return 5;
+			}
+		}(),
+		rewindBufferSizeItem
+	},
+	rewindFrameIntervalItem
+	{
+		{"1",  &defaultFace(), setRewindFrameIntervalDel(1)},
+		{"2",  &defaultFace(), setRewindFrameIntervalDel(2)},
+		{"4",  &defaultFace(), setRewindFrameIntervalDel(4)},
+		{"8",  &defaultFace(), setRewindFrameIntervalDel(8)},
+		{"15", &defaultFace(), setRewindFrameIntervalDel(15)},
+		{"30", &defaultFace(), setRewindFrameIntervalDel(30)},
+	},
+	rewindFrameInterval
+	{
+		"Frames Per Rewind Snapshot", &defaultFace(),
+		[this]()
+		{
+			switch(app().rewindFrameIntervalOption().val)
+			{
+				default: return 2;
+				case 1: return 0;
+				case 2: return 1;
+				case 8: return 3;
+				case 15: return 4;
+				case 30: return 5;
+			}
+		}(),
+		rewindFrameIntervalItem
+	},
+	runAheadFramesItem
+	{
+		{"Off", &defaultFace(), setRunAheadFramesDel(0)},
+		{"1",   &defaultFace(), setRunAheadFramesDel(1)},
+		{"2",   &defaultFace(), setRunAheadFramesDel(2)},
+		{"3",   &defaultFace(), setRunAheadFramesDel(3)},
+		{"4",   &defaultFace(), setRunAheadFramesDel(4)},
+	},
+	runAheadFrames
+	{
+		"Run-ahead Frames", &defaultFace(),
+		std::min((int)app().runAheadFramesOption().val, 4),
+		runAheadFramesItem
+	},
+	contentCacheSizeItem
+	{
+		{"Off",    &defaultFace(), setContentCacheSizeDel(0)},
+		{"256MB",  &defaultFace(), setContentCacheSizeDel(256)},
+		{"512MB",  &defaultFace(), setContentCacheSizeDel(512)},
+		{"1GB",    &defaultFace(), setContentCacheSizeDel(1024)},
+		{"2GB",    &defaultFace(), setContentCacheSizeDel(2048)},
+		{"4GB",    &defaultFace(), setContentCacheSizeDel(4096)},
+	},
+	contentCacheSize
+	{
+		"Archive Content Cache", &defaultFace(),
+		[]()
+		{
+			switch(optionContentCacheSize.val)
+			{
+				default: return 0;
+				case 256: return 1;
+				case 512: return 2;
+				case 1024: return 3;
+				case 2048: return 4;
+				case 4096: return 5;
+			}
+		}(),
+		contentCacheSizeItem
+	},
+	emuThreadCPUAffinityItem
+	{
+		{"Any",               &defaultFace(), setEmuThreadCPUAffinityDel(0)},
+		{"Performance Cores", &defaultFace(), setEmuThreadCPUAffinityDel(1)},
+		{"Efficiency Cores",  &defaultFace(), setEmuThreadCPUAffinityDel(2)},
+	},
+	emuThreadCPUAffinity
+	{
+		"Emulation Thread CPUs", &defaultFace(),
+		(int)optionEmuThreadCPUAffinity.val,
+		emuThreadCPUAffinityItem
+	},
+	renderThreadCPUAffinityItem
+	{
+		{"Any",               &defaultFace(), setRenderThreadCPUAffinityDel(0)},
+		{"Performance Cores", &defaultFace(), setRenderThreadCPUAffinityDel(1)},
+		{"Efficiency Cores",  &defaultFace(), setRenderThreadCPUAffinityDel(2)},
+	},
+	renderThreadCPUAffinity
+	{
+		"Render Thread CPUs", &defaultFace(),
+		(int)optionRenderThreadCPUAffinity.val,
+		renderThreadCPUAffinityItem
+	},
+	emuThreadPriorityItem
+	{
+		{"Normal",    &defaultFace(), setEmuThreadPriorityDel(0)},
+		{"High",      &defaultFace(), setEmuThreadPriorityDel(1)},
+		{"Real-time", &defaultFace(), setEmuThreadPriorityDel(2)},
+	},
+	emuThreadPriority
+	{
+		"Emulation Thread Priority", &defaultFace(),
+		(int)optionEmuThreadPriority.val,
+		emuThreadPriorityItem
 	}
 	#if defined __ANDROID__
 	,performanceMode
@@ -320,6 +514,19 @@ void SystemOptionView::loadStockItems()
 	savePath.setName(makePathMenuEntryStr(appContext(), EmuSystem::userSaveDirectory()));
 	item.emplace_back(&savePath);
 	item.emplace_back(&fastForwardSpeed);
+	if(EmuSystem::hasSeamlessMemoryStates)
+	{
+		item.emplace_back(&rewindBufferSize);
+		item.emplace_back(&rewindFrameInterval);
+		item.emplace_back(&runAheadFrames);
+	}
+	if(EmuSystem::handlesGenericIO)
+		item.emplace_back(&contentCacheSize);
+	#ifdef __linux__
+	item.emplace_back(&emuThreadCPUAffinity);
+	item.emplace_back(&renderThreadCPUAffinity);
+	item.emplace_back(&emuThreadPriority);
+	#endif
 	#ifdef __ANDROID__
 	if(!optionSustainedPerformanceMode.isConst)
 		item.emplace_back(&performanceMode);
@@ -684,6 +684,16 @@ VideoOptionView::VideoOptionView(ViewAttachParams attach, bool customMenu):
 			app().viewController().setUsePresentationTime(item.flipBoolValue(*this));
 		}
 	},
+	frameTimingStats
+	{
+		"Show Frame Timing Stats", &defaultFace(),
+		(bool)optionShowFrameTimingStats,
+		[this](BoolMenuItem &item)
+		{
+			optionShowFrameTimingStats = item.flipBoolValue(*this);
+			app().frameTimingStats().setEnabled(optionShowFrameTimingStats);
+		}
+	},
 	visualsHeading{"Visuals", &defaultBoldFace()},
 	screenShapeHeading{"Screen Shape", &defaultBoldFace()},
 	advancedHeading{"Advanced", &defaultBoldFace()},
@@ -809,6 +819,7 @@ void VideoOptionView::loadStockItems()
 		item.emplace_back(&imageBuffers);
 	if(IG::used(presentationTime) && renderer().supportsPresentationTime())
 		item.emplace_back(&presentationTime);
+	item.emplace_back(&frameTimingStats);
 	#if defined CONFIG_BASE_MULTI_WINDOW && defined CONFIG_BASE_X11
 	item.emplace_back(&secondDisplay);
 	#endif
@@ -18,9 +18,12 @@
 #include <emuframework/EmuSystem.hh>
 #include <imagine/pixmap/PixelFormat.hh>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace IG
 {
+struct CommandArgs;
 class Window;
 class GenericIO;
 class ViewAttachParams;
@@ -45,9 +48,21 @@ class EmuViewController;
 class EmuVideo;
 class EmuAudio;
 
+struct HeadlessBenchmarkParams
+{
+	std::vector<const char*> paths;
+	const char *outputPath{};
+	int frames{180};
+	int warmupFrames{60};
+	bool hasInvalidArgs{};
+};
+
 std::u16string_view appViewTitle();
 bool hasGooglePlayStoreFeatures();
 void runBenchmarkOneShot(EmuApp &, EmuVideo &);
+std::optional<HeadlessBenchmarkParams> parseBenchmarkArgs(IG::CommandArgs);
+void printBenchmarkUsage();
+int runHeadlessBenchmark(EmuApp &, const HeadlessBenchmarkParams &);
 void onSelectFileFromPicker(EmuApp &, GenericIO, IG::CStringView path, std::string_view displayName,
 	const Input::Event &, EmuSystemCreateParams, ViewAttachParams);
 void launchSystem(EmuApp &, bool tryAutoState);
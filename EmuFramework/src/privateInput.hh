@@ -108,5 +108,6 @@ static constexpr int guiKeyIdxFastForward = 6;
 static constexpr int guiKeyIdxGameScreenshot = 7;
 static constexpr int guiKeyIdxExit = 8;
 static constexpr int guiKeyIdxToggleFastForward = 9;
+static constexpr int guiKeyIdxRewind = 10;
 
 }
@@ -15,6 +15,11 @@
 
 #include <imagine/pixmap/Pixmap.hh>
 #include <mednafen/video/surface.h>
+#include <mednafen/state.h>
+#include <mednafen/MemoryStream.h>
+#include <span>
+#include <stdexcept>
+#include <cstring>
 
 static Mednafen::MDFN_Surface pixmapToMDFNSurface(IG::Pixmap pix)
 {
@@ -34,3 +39,27 @@ static Mednafen::MDFN_Surface pixmapToMDFNSurface(IG::Pixmap pix)
 		}();
 	return {pix.data(), (uint32)pix.w(), (uint32)pix.h(), (uint32)pix.pitchPixels(), fmt};
 }
+
+static size_t stateSizeMDFN()
+{
+	Mednafen::MemoryStream s{};
+	Mednafen::MDFNSS_SaveSM(&s);
+	return s.size();
+}
+
+static size_t saveStateMDFN(std::span<uint8_t> buff)
+{
+	Mednafen::MemoryStream s{buff.size()};
+	Mednafen::MDFNSS_SaveSM(&s);
+	if(s.size() > buff.size())
+		throw std::runtime_error("State buffer too small");
+	memcpy(buff.data(), s.map(), s.size());
+	return s.size();
+}
+
+static void loadStateMDFN(std::span<const uint8_t> buff)
+{
+	Mednafen::MemoryStream s{buff.size(), -1};
+	memcpy(s.map(), buff.data(), buff.size());
+	Mednafen::MDFNSS_LoadSM(&s);
+}
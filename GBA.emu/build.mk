@@ -52,6 +52,8 @@ main/EmuControls.cc \
 main/EmuMenuViews.cc \
 main/VbamApi.cc \
 main/Cheats.cc \
+main/PPUThread.cc \
+main/CodeCache.cc \
 $(addprefix $(vbamPath)/,$(vbamSrc))
 
 include $(EMUFRAMEWORK_PATH)/package/emuframework.mk
@@ -0,0 +1,149 @@
+/*  This file is part of GBA.emu.
+
+	GBA.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	GBA.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with GBA.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+#include "CodeCache.hh"
+#include <span>
+
+// unconditional branches, no point decoding past them
+static bool armEndsBlock(uint32_t opcode)
+{
+	return (opcode & 0xFE000000) == 0xEA000000 || // B, BL
+		(opcode & 0xFFFFFFF0) == 0xE12FFF10 || // BX
+		(opcode & 0xFF000000) == 0xEF000000 || // SWI
+		(opcode & 0xFE108000) == 0xE8108000; // LDM with PC
+}
+
+static bool thumbEndsBlock(uint32_t opcode)
+{
+	return (opcode & 0xF800) == 0xE000 || // B
+		(opcode & 0xFF00) == 0x4700 || // BX
+		(opcode & 0xF800) == 0xF800 || // BL (2nd half)
+		(opcode & 0xFF00) == 0xDF00 || // SWI
+		(opcode & 0xFF00) == 0xBD00; // POP with PC
+}
+
+template<class Block>
+static bool isValid(const Block &block, uint32_t pc, const auto &pageGen)
+{
+	return block.pc == pc && (block.page == GBACodeCache::noPage || block.pageGen == pageGen[block.page]);
+}
+
+GBACodeCache::GBACodeCache():
+	armBlocks{std::make_unique<ArmBlock[]>(blocks)},
+	thumbBlocks{std::make_unique<ThumbBlock[]>(blocks)} {}
+
+void GBACodeCache::flush()
+{
+	for(auto &b : std::span{armBlocks.get(), blocks})
+		b.pc = 1;
+	for(auto &b : std::span{thumbBlocks.get(), blocks})
+		b.pc = 1;
+	pageHasCode = {};
+	// the block being run may have changed, leave it & refill the prefetch pipeline normally
+	codeWritten = true;
+}
+
+bool GBACodeCache::canRunBlock()
+{
+	if(codeWritten) [[unlikely]]
+	{
+		codeWritten = false;
+		stalePrefetchInsns = 2;
+	}
+	if(stalePrefetchInsns) [[unlikely]]
+	{
+		// the pipeline may still hold opcodes from before the write
+		stalePrefetchInsns--;
+		return false;
+	}
+	return true;
+}
+
+template<class Handler, class ReadOpcode, class GetHandler, class EndsBlock>
+GBACodeCache::Block<Handler> *GBACodeCache::decodeBlock(Block<Handler> &block, uint32_t pc, uint32_t insnBytes,
+	ReadOpcode readOpcode, GetHandler getHandler, EndsBlock endsBlock)
+{
+	uint32_t end{};
+	uint16_t page = noPage;
+	switch(pc >> 24)
+	{
+		case 0x00:
+			end = 0x4000;
+			break;
+		case 0x02:
+			page = (pc & 0x3FFFF) >> pageBits;
+			break;
+		case 0x03:
+			page = ewramPages + ((pc & 0x7FFF) >> pageBits);
+			break;
+		case 0x08: case 0x09: case 0x0A: case 0x0B: case 0x0C: case 0x0D:
+			end = 0x0E000000 - insnBytes * 2;
+			break;
+		default:
+			return nullptr;
+	}
+	if(page != noPage)
+	{
+		// keep the opcodes following the block in the same page so writing them invalidates it
+		end = (((pc >> pageBits) + 1) << pageBits) - insnBytes * 2;
+	}
+	if(pc >= end)
+		return nullptr;
+	unsigned size = 0;
+	uint32_t addr = pc;
+	while(size < maxBlockInsns && addr < end)
+	{
+		uint32_t opcode = readOpcode(addr);
+		block.insns[size++] = {getHandler(opcode), opcode};
+		addr += insnBytes;
+		if(endsBlock(opcode))
+			break;
+	}
+	block.insns[size].opcode = readOpcode(addr);
+	block.insns[size + 1].opcode = readOpcode(addr + insnBytes);
+	block.pc = pc;
+	block.size = size;
+	block.page = page;
+	if(page != noPage)
+	{
+		block.pageGen = pageGen[page];
+		pageHasCode[page] = true;
+	}
+	return &block;
+}
+
+GBACodeCache::ArmBlock *GBACodeCache::armBlock(ARM7TDMI &cpu, uint32_t pc)
+{
+	if(!canRunBlock())
+		return nullptr;
+	auto &block = armBlocks[(pc >> 2) % blocks];
+	if(isValid(block, pc, pageGen)) [[likely]]
+		return &block;
+	return decodeBlock(block, pc, 4,
+		[&](uint32_t addr){ return CPUReadMemoryQuick(cpu, addr); },
+		armInsnHandler, armEndsBlock);
+}
+
+GBACodeCache::ThumbBlock *GBACodeCache::thumbBlock(ARM7TDMI &cpu, uint32_t pc)
+{
+	if(!canRunBlock())
+		return nullptr;
+	auto &block = thumbBlocks[(pc >> 1) % blocks];
+	if(isValid(block, pc, pageGen)) [[likely]]
+		return &block;
+	return decodeBlock(block, pc, 2,
+		[&](uint32_t addr){ return CPUReadHalfWordQuick(cpu, addr); },
+		thumbInsnHandler, thumbEndsBlock);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vbam/gba/GBA.h>
+#include <vbam/gba/GBAcpu.h>
+#include <array>
+#include <memory>
+
+// Caches runs of pre-decoded instructions from BIOS, ROM, EWRAM & IWRAM keyed by their
+// start PC so armExecute()/thumbExecute() can dispatch from handler & opcode pairs instead
+// of fetching & decoding each instruction. Writes to a RAM page holding decoded code
+// invalidate its blocks. Since the real CPU executes whatever is in its prefetch
+// pipeline, the interpreter runs the next 2 instructions after any code write normally.
+class GBACodeCache
+{
+public:
+	typedef INSN_REGPARM void (*ArmHandler)(ARM7TDMI &, uint32_t opcode, int &clockTicks);
+	typedef INSN_REGPARM int (*ThumbHandler)(ARM7TDMI &, uint32_t opcode, uint32_t oldArmNextPC);
+	static constexpr unsigned maxBlockInsns = 16;
+	static constexpr unsigned blocks = 2048;
+	static constexpr unsigned pageBits = 8;
+	static constexpr unsigned ewramPages = 0x40000 >> pageBits;
+	static constexpr unsigned iwramPages = 0x8000 >> pageBits;
+	static constexpr uint16_t noPage = 0xFFFF; // BIOS & ROM are never written
+
+	template<class Handler>
+	struct Block
+	{
+		struct Insn
+		{
+			Handler handler{};
+			uint32_t opcode{};
+		};
+
+		uint32_t pc = 1; // never a fetch address
+		uint32_t pageGen{};
+		uint16_t page = noPage;
+		uint8_t size{};
+		// followed by the next 2 opcodes to refill the prefetch pipeline on exit
+		std::array<Insn, maxBlockInsns + 2> insns;
+	};
+
+	using ArmBlock = Block<ArmHandler>;
+	using ThumbBlock = Block<ThumbHandler>;
+
+	GBACodeCache();
+	// call after memory changes without going through invalidate()
+	void flush();
+	// returns a block starting at pc or nullptr if the instructions must be fetched normally
+	ArmBlock *armBlock(ARM7TDMI &, uint32_t pc);
+	ThumbBlock *thumbBlock(ARM7TDMI &, uint32_t pc);
+	bool hasWrittenCode() const { return codeWritten; }
+
+	void invalidate(uint32_t address)
+	{
+		auto page = (address >> 24) == 2 ? (address & 0x3FFFF) >> pageBits :
+			ewramPages + ((address & 0x7FFF) >> pageBits);
+		if(pageHasCode[page]) [[unlikely]]
+		{
+			pageHasCode[page] = false;
+			pageGen[page]++;
+			codeWritten = true;
+		}
+	}
+
+private:
+	std::unique_ptr<ArmBlock[]> armBlocks;
+	std::unique_ptr<ThumbBlock[]> thumbBlocks;
+	std::array<uint32_t, ewramPages + iwramPages> pageGen{};
+	std::array<bool, ewramPages + iwramPages> pageHasCode{};
+	bool codeWritten{};
+	uint8_t stalePrefetchInsns{};
+
+	bool canRunBlock();
+	template<class Handler, class ReadOpcode, class GetHandler, class EndsBlock>
+	Block<Handler> *decodeBlock(Block<Handler> &, uint32_t pc, uint32_t insnBytes, ReadOpcode, GetHandler, EndsBlock);
+};
+
+// defined with the instruction tables in GBA-arm.cpp & GBA-thumb.cpp
+GBACodeCache::ArmHandler armInsnHandler(uint32_t opcode);
+GBACodeCache::ThumbHandler thumbInsnHandler(uint32_t opcode);
+
+static inline void invalidateCodeCache(ARM7TDMI &cpu, uint32_t address)
+{
+	if(cpu.codeCache)
+		cpu.codeCache->invalidate(address);
+}
+
+static inline void flushCodeCache(ARM7TDMI &cpu)
+{
+	if(cpu.codeCache)
+		cpu.codeCache->flush();
+}
@@ -24,6 +24,55 @@
 namespace EmuEx
 {
 
+class CustomVideoOptionView : public VideoOptionView
+{
+	BoolMenuItem ppuThread
+	{
+		"Render Video On Separate Thread", &defaultFace(),
+		(bool)optionPPUThread,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionPPUThread = item.flipBoolValue(*this);
+			if(EmuSystem::gameIsRunning())
+			{
+				setPPUThread(optionPPUThread);
+			}
+		}
+	};
+
+public:
+	CustomVideoOptionView(ViewAttachParams attach): VideoOptionView{attach, true}
+	{
+		loadStockItems();
+		item.emplace_back(&systemSpecificHeading);
+		item.emplace_back(&ppuThread);
+	}
+};
+
+class CustomSystemOptionView : public SystemOptionView
+{
+	BoolMenuItem codeCache
+	{
+		"Cache Decoded CPU Instructions", &defaultFace(),
+		(bool)optionCodeCache,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionCodeCache = item.flipBoolValue(*this);
+			if(EmuSystem::gameIsRunning())
+			{
+				setCodeCache(optionCodeCache);
+			}
+		}
+	};
+
+public:
+	CustomSystemOptionView(ViewAttachParams attach): SystemOptionView{attach, true}
+	{
+		loadStockItems();
+		item.emplace_back(&codeCache);
+	}
+};
+
 class ConsoleOptionView : public TableView
 {
 	TextMenuItem rtcItem[3]
@@ -98,6 +147,8 @@ std::unique_ptr<View> EmuApp::makeCustomView(ViewAttachParams attach, ViewID id)
 {
 	switch(id)
 	{
+		case ViewID::VIDEO_OPTIONS: return std::make_unique<CustomVideoOptionView>(attach);
+		case ViewID::SYSTEM_OPTIONS: return std::make_unique<CustomSystemOptionView>(attach);
 		case ViewID::SYSTEM_ACTIONS: return std::make_unique<CustomSystemActionsView>(attach);
 		case ViewID::EDIT_CHEATS: return std::make_unique<EmuEditCheatListView>(attach);
 		case ViewID::LIST_CHEATS: return std::make_unique<EmuCheatsView>(attach);
@@ -251,6 +251,8 @@ struct GBATimers
 };
 
 void mode0RenderLine(MixColorType *, GBALCD &lcd, const GBAMem::IoMem &ioMem);
+class GBAPPUThread;
+class GBACodeCache;
 
 struct GBALCD
 {
@@ -284,6 +286,7 @@ struct GBALCD
 	int layerEnableDelay = 0;
 	int lcdTicks = 0;
 	uint16_t gfxLastVCOUNT = 0;
+	GBAPPUThread *ppuThread{}; // set while scanlines are rendered on a separate thread
 
 	void registerRamReset(uint32_t flags)
 	{
@@ -301,6 +304,21 @@ struct GBALCD
     }
 	}
 
+	static void updateWindow(bool (&inWin)[240], uint16_t winH)
+	{
+		int x00 = winH >> 8;
+		int x01 = winH & 255;
+		if (x00 <= x01) {
+			for (int i = 0; i < 240; i++) {
+				inWin[i] = (i >= x00 && i < x01);
+			}
+		} else {
+			for (int i = 0; i < 240; i++) {
+				inWin[i] = (i >= x00 || i < x01);
+			}
+		}
+	}
+
 	void reset()
 	{
 		memset(paletteRAM, 0, sizeof(paletteRAM));
@@ -399,6 +417,7 @@ public:
 	//uint8_t cpuBitsSet[256];
 	//uint8_t cpuLowestBitSet[256];
 	GBASys *gba;
+	GBACodeCache *codeCache{}; // set when running pre-decoded instruction blocks
 	unsigned memoryWait[16]
 	  {0, 0, 2, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4, 4, 4, 0};
 	unsigned memoryWait32[16]
@@ -521,6 +540,14 @@ public:
 #endif
 	}
 
+	void setPrefetch(uint32_t opcode0, uint32_t opcode1)
+	{
+#ifdef VBAM_USE_CPU_PREFETCH
+		cpuPrefetch[0] = opcode0;
+		cpuPrefetch[1] = opcode1;
+#endif
+	}
+
 	int prefetchArmOpcode() __attribute__((always_inline))
 	{
 #ifdef VBAM_USE_CPU_PREFETCH
@@ -19,8 +19,11 @@
 #include <emuframework/EmuAudio.hh>
 #include <emuframework/EmuVideo.hh>
 #include "internal.hh"
+#include "PPUThread.hh"
+#include "CodeCache.hh"
 #include <imagine/fs/FS.hh>
 #include <imagine/util/format.hh>
+#include <imagine/util/ScopeGuard.hh>
 #include <vbam/gba/GBA.h>
 #include <vbam/gba/GBAGfx.h>
 #include <vbam/gba/Sound.h>
@@ -37,6 +40,8 @@ const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2012-2022\nRobe
 bool EmuSystem::hasBundledGames = true;
 bool EmuSystem::hasCheats = true;
 constexpr IG::WP lcdSize{240, 160};
+static std::unique_ptr<GBAPPUThread> ppuThread;
+static std::unique_ptr<GBACodeCache> codeCache;
 
 EmuSystem::NameFilterFunc EmuSystem::defaultFsFilter =
 	[](std::string_view name)
@@ -65,9 +70,49 @@ const char *EmuSystem::systemName()
 	return "Game Boy Advance";
 }
 
+void setPPUThread(bool on)
+{
+	if(on)
+	{
+		if(!ppuThread)
+			ppuThread = std::make_unique<GBAPPUThread>();
+		ppuThread->start(gGba.lcd, gGba.mem.ioMem);
+	}
+	else if(ppuThread)
+	{
+		ppuThread->stop(gGba.lcd);
+	}
+}
+
+void setCodeCache(bool on)
+{
+	if(on)
+	{
+		if(!codeCache)
+			codeCache = std::make_unique<GBACodeCache>();
+		else
+			codeCache->flush(); // writes made while disabled weren't tracked
+		gGba.cpu.codeCache = codeCache.get();
+	}
+	else
+	{
+		gGba.cpu.codeCache = {};
+	}
+}
+
+// syncs the PPU thread before the LCD state is replaced & reloads its copy on scope exit
+static auto pausePPUThread()
+{
+	bool wasRunning = ppuThread && ppuThread->isRunning();
+	if(wasRunning)
+		ppuThread->pause(gGba.lcd);
+	return IG::scopeGuard([]{ ppuThread->resume(gGba.lcd, gGba.mem.ioMem); }, wasRunning);
+}
+
 void EmuSystem::reset(ResetMode mode)
 {
 	assert(gameIsRunning());
+	auto ppuPause = pausePPUThread();
 	CPUReset(gGba);
 }
 
@@ -84,10 +129,40 @@ void EmuSystem::saveState(IG::ApplicationContext ctx, IG::CStringView path)
 
 void EmuSystem::loadState(EmuApp &app, IG::CStringView path)
 {
+	auto ppuPause = pausePPUThread();
 	if(!CPUReadState(app.appContext(), gGba, path))
 		return throwFileReadError();
 }
 
+size_t EmuSystem::stateSize()
+{
+	// measure the uncompressed state, growing the buffer until it fits
+	std::vector<char> buff(0x100000);
+	long size{};
+	while(!CPUWriteMemState(gGba, buff.data(), buff.size(), size))
+	{
+		if(buff.size() >= 0x1000000)
+			throwFileWriteError();
+		buff.resize(buff.size() * 2);
+	}
+	return size + 1; // CPUWriteMemState() needs at least 1 unused byte to detect truncation
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	long size{};
+	if(!CPUWriteMemState(gGba, (char*)buff.data(), buff.size(), size))
+		throwFileWriteError();
+	return size;
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	auto ppuPause = pausePPUThread();
+	if(!CPUReadMemState(gGba, (char*)buff.data(), buff.size()))
+		throwFileReadError();
+}
+
 void EmuSystem::saveBackupMem(IG::ApplicationContext ctx)
 {
 	if(gameIsRunning())
@@ -104,6 +179,8 @@ void EmuSystem::closeSystem(IG::ApplicationContext ctx)
 {
 	assert(gameIsRunning());
 	saveBackupMem(ctx);
+	setPPUThread(false);
+	setCodeCache(false);
 	CPUCleanUp();
 	detectedRtcGame = 0;
 	cheatsList.clear();
@@ -154,6 +231,10 @@ void EmuSystem::loadGame(IG::ApplicationContext ctx, IO &io, EmuSystemCreatePara
 	auto saveStr = EmuSystem::contentSaveFilePath(ctx, ".sav");
 	CPUReadBatteryFile(ctx, gGba, saveStr.data());
 	readCheatFile(ctx);
+	if(optionPPUThread)
+		setPPUThread(true);
+	if(optionCodeCache)
+		setCodeCache(true);
 }
 
 bool EmuSystem::onVideoRenderFormatChange(EmuVideo &video, IG::PixelFormat fmt)
@@ -211,12 +292,12 @@ void systemDrawScreen(EmuEx::EmuSystemTaskContext taskCtx, EmuEx::EmuVideo &vide
 	assumeExpr(img.pixmap().size() == framePix.size());
 	if(img.pixmap().format() == IG::PIXEL_FMT_RGB565)
 	{
-		img.pixmap().writeTransformed([](uint16_t p){ return systemColorMap.map16[p]; }, framePix);
+		img.pixmap().writeLookup(systemColorMap.map16, framePix);
 	}
 	else
 	{
 		assumeExpr(img.pixmap().format().bytesPerPixel() == 4);
-		img.pixmap().writeTransformed([](uint16_t p){ return systemColorMap.map32[p]; }, framePix);
+		img.pixmap().writeLookup(systemColorMap.map32, framePix);
 	}
 	img.endFrame();
 }
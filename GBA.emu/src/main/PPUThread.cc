@@ -0,0 +1,232 @@
+/*  This file is part of GBA.emu.
+
+	GBA.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	GBA.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with GBA.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "PPUThread"
+#include <emuframework/EmuApp.hh>
+#include "PPUThread.hh"
+#include <imagine/thread/Thread.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+
+static void clearLines(GBALCD &lcd, unsigned layerMask)
+{
+	if(!layerMask)
+		return;
+	using LayerLine = std::pair<unsigned, uint32_t*>;
+	for(auto [layerBit, line] : std::array{LayerLine{0x1, lcd.line0}, LayerLine{0x2, lcd.line1},
+		LayerLine{0x4, lcd.line2}, LayerLine{0x8, lcd.line3}})
+	{
+		if(layerMask & layerBit)
+			std::fill_n(line, 240, 0x80000000); // same as gfxClearArray()
+	}
+}
+
+GBAPPUThread::GBAPPUThread():
+	lcd{std::make_unique<GBALCD>()},
+	ioMem{std::make_unique<GBAMem::IoMem>()},
+	writes{std::make_unique<MemWrite[]>(maxWrites)} {}
+
+GBAPPUThread::~GBAPPUThread()
+{
+	if(!isRunning())
+		return;
+	send(CommandType::EXIT);
+	thread.join();
+}
+
+void GBAPPUThread::start(GBALCD &srcLcd, const GBAMem::IoMem &srcIoMem)
+{
+	if(isRunning())
+		return;
+	copyStateFrom(srcLcd, srcIoMem);
+	thread = IG::makeThreadSync(EmuEx::EmuApp::emuThreadAttributes(),
+		[this](std::binary_semaphore &sem)
+		{
+			sem.release();
+			run();
+		});
+	srcLcd.ppuThread = this;
+	logMsg("started PPU thread");
+}
+
+void GBAPPUThread::stop(GBALCD &dstLcd)
+{
+	if(!isRunning())
+		return;
+	send(CommandType::EXIT, true);
+	thread.join();
+	thread = {};
+	copyStateTo(dstLcd);
+	logMsg("stopped PPU thread");
+}
+
+void GBAPPUThread::pause(GBALCD &dstLcd)
+{
+	send(CommandType::SYNC, true);
+	linesPending = false;
+	copyStateTo(dstLcd);
+}
+
+void GBAPPUThread::resume(GBALCD &srcLcd, const GBAMem::IoMem &srcIoMem)
+{
+	// the worker is idle after pause() so its state can be replaced directly
+	copyStateFrom(srcLcd, srcIoMem);
+	srcLcd.ppuThread = this;
+}
+
+void GBAPPUThread::copyStateFrom(const GBALCD &srcLcd, const GBAMem::IoMem &srcIoMem)
+{
+	*lcd = srcLcd;
+	lcd->ppuThread = {};
+	*ioMem = srcIoMem;
+	win0H = srcIoMem.WIN0H;
+	win1H = srcIoMem.WIN1H;
+	writeIdx = writesAppliedSeen = 0;
+	writesApplied.store(0, std::memory_order_relaxed);
+	pendingClearMask = 0;
+}
+
+void GBAPPUThread::copyStateTo(GBALCD &dstLcd)
+{
+	// state only updated by the renderer, along with unapplied changes it already received
+	std::ranges::copy(lcd->line0, dstLcd.line0);
+	std::ranges::copy(lcd->line1, dstLcd.line1);
+	std::ranges::copy(lcd->line2, dstLcd.line2);
+	std::ranges::copy(lcd->line3, dstLcd.line3);
+	std::ranges::copy(lcd->lineOBJ, dstLcd.lineOBJ);
+	std::ranges::copy(lcd->lineOBJWin, dstLcd.lineOBJWin);
+	std::ranges::copy(lcd->lineOBJpixleft, dstLcd.lineOBJpixleft);
+	dstLcd.gfxBG2Changed |= lcd->gfxBG2Changed;
+	dstLcd.gfxBG3Changed |= lcd->gfxBG3Changed;
+	dstLcd.gfxBG2X = lcd->gfxBG2X;
+	dstLcd.gfxBG2Y = lcd->gfxBG2Y;
+	dstLcd.gfxBG3X = lcd->gfxBG3X;
+	dstLcd.gfxBG3Y = lcd->gfxBG3Y;
+	dstLcd.gfxLastVCOUNT = lcd->gfxLastVCOUNT;
+	// apply line buffer clears requested after the last rendered line
+	clearLines(dstLcd, std::exchange(pendingClearMask, 0));
+	dstLcd.ppuThread = {};
+}
+
+void GBAPPUThread::renderLine(GBALCD &srcLcd, const GBAMem::IoMem &srcIoMem)
+{
+	Command cmd{.type = CommandType::RENDER_LINE,
+		.clearMask = std::exchange(pendingClearMask, 0),
+		.bg2Changed = uint8_t(std::exchange(srcLcd.gfxBG2Changed, 0)),
+		.bg3Changed = uint8_t(std::exchange(srcLcd.gfxBG3Changed, 0)),
+		.layerEnable = srcLcd.layerEnable,
+		.writesEnd = writeIdx,
+		.renderLine = srcLcd.renderLine,
+		.lineMix = srcLcd.lineMix};
+	std::memcpy(cmd.regs.data(), srcIoMem.b, lcdRegsSize);
+	port.send(cmd);
+	linesPending = true;
+}
+
+void GBAPPUThread::finishFrame()
+{
+	if(!std::exchange(linesPending, false))
+		return;
+	send(CommandType::SYNC, true);
+}
+
+void GBAPPUThread::reloadMemory(const GBALCD &srcLcd)
+{
+	send(CommandType::SYNC, true);
+	linesPending = false;
+	// the worker is idle and any unsent writes are already in srcLcd
+	std::ranges::copy(srcLcd.paletteRAM, lcd->paletteRAM);
+	std::ranges::copy(srcLcd.vram, lcd->vram);
+	std::ranges::copy(srcLcd.oam, lcd->oam);
+	writesAppliedSeen = writeIdx;
+	writesApplied.store(writeIdx, std::memory_order_relaxed);
+}
+
+void GBAPPUThread::send(CommandType type, bool awaitReply)
+{
+	port.send(Command{.type = type, .writesEnd = writeIdx}, awaitReply);
+}
+
+void GBAPPUThread::waitForWriteSpace()
+{
+	writesAppliedSeen = writesApplied.load(std::memory_order_acquire);
+	if(writeIdx - writesAppliedSeen != maxWrites)
+		return;
+	// more writes than fit in the log since the last line, apply them without rendering
+	send(CommandType::APPLY_WRITES);
+	do
+	{
+		std::this_thread::yield();
+		writesAppliedSeen = writesApplied.load(std::memory_order_acquire);
+	} while(writeIdx - writesAppliedSeen == maxWrites);
+}
+
+void GBAPPUThread::applyWrites(uint32_t end)
+{
+	auto idx = writesApplied.load(std::memory_order_relaxed);
+	if(idx == end)
+		return;
+	auto lcdBytes = (uint8_t*)lcd.get();
+	for(; idx != end; idx++)
+	{
+		auto w = writes[idx % maxWrites];
+		std::memcpy(lcdBytes + (w.offset & ~WRITE_32BIT), &w.data, (w.offset & WRITE_32BIT) ? 4 : 2);
+	}
+	writesApplied.store(end, std::memory_order_release);
+}
+
+void GBAPPUThread::render(const Command &cmd)
+{
+	std::memcpy(ioMem->b, cmd.regs.data(), lcdRegsSize);
+	if(ioMem->WIN0H != win0H)
+	{
+		win0H = ioMem->WIN0H;
+		GBALCD::updateWindow(lcd->gfxInWin0, win0H);
+	}
+	if(ioMem->WIN1H != win1H)
+	{
+		win1H = ioMem->WIN1H;
+		GBALCD::updateWindow(lcd->gfxInWin1, win1H);
+	}
+	clearLines(*lcd, cmd.clearMask);
+	lcd->layerEnable = cmd.layerEnable;
+	lcd->gfxBG2Changed |= cmd.bg2Changed;
+	lcd->gfxBG3Changed |= cmd.bg3Changed;
+	cmd.renderLine(cmd.lineMix, *lcd, *ioMem);
+}
+
+void GBAPPUThread::run()
+{
+	while(true)
+	{
+		auto cmd = port.receive();
+		applyWrites(cmd.writesEnd);
+		switch(cmd.type)
+		{
+			case CommandType::RENDER_LINE:
+				render(cmd);
+				break;
+			case CommandType::APPLY_WRITES:
+				break;
+			case CommandType::SYNC:
+				cmd.semPtr->release();
+				break;
+			case CommandType::EXIT:
+				if(cmd.semPtr)
+					cmd.semPtr->release();
+				return;
+		}
+	}
+}
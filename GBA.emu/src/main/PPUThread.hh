@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vbam/gba/GBA.h>
+#include <imagine/thread/SPSCMessagePort.hh>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+// Renders scanlines on a worker thread one or more lines behind the CPU. At each
+// H-Blank the CPU thread sends the LCD registers, replacing the inline renderLine()
+// call, and its palette RAM/VRAM/OAM writes are logged so the worker can replay them
+// into its own copy of the LCD state in order, keeping the output bit-identical.
+class GBAPPUThread
+{
+public:
+	GBAPPUThread();
+	~GBAPPUThread();
+	// copies the current LCD state to the worker & sets lcd.ppuThread
+	void start(GBALCD &, const GBAMem::IoMem &);
+	// copies the renderer state back to lcd & clears lcd.ppuThread
+	void stop(GBALCD &);
+	// like stop() & start() but keeps the thread idle in between, for replacing the LCD state
+	void pause(GBALCD &);
+	void resume(GBALCD &, const GBAMem::IoMem &);
+	bool isRunning() const { return thread.joinable(); }
+	void renderLine(GBALCD &, const GBAMem::IoMem &);
+	// blocks until all sent lines are rendered, returning immediately if none were sent since the last call
+	void finishFrame();
+	// call after palette RAM/VRAM/OAM change without going through logWrite()
+	void reloadMemory(const GBALCD &);
+	void clearLineBuffers(unsigned layerMask) { pendingClearMask |= layerMask; }
+
+	void logWrite(const GBALCD &lcd, const void *dest, unsigned bytes)
+	{
+		if(writeIdx - writesAppliedSeen == maxWrites) [[unlikely]]
+			waitForWriteSpace();
+		MemWrite w{uint32_t((const uint8_t*)dest - (const uint8_t*)&lcd) | (bytes == 4 ? WRITE_32BIT : 0)};
+		std::memcpy(&w.data, dest, bytes);
+		writes[writeIdx % maxWrites] = w;
+		writeIdx++;
+	}
+
+private:
+	static constexpr uint32_t maxWrites = 0x8000;
+	static constexpr uint32_t WRITE_32BIT = 0x80000000;
+	static constexpr size_t lcdRegsSize = offsetof(GBAMem::IoMem, soundRegs);
+
+	struct MemWrite
+	{
+		uint32_t offset{}; // from the start of GBALCD
+		uint32_t data{};
+	};
+
+	enum class CommandType : uint8_t
+	{
+		RENDER_LINE, APPLY_WRITES, SYNC, EXIT
+	};
+
+	struct Command
+	{
+		CommandType type{};
+		uint8_t clearMask{};
+		uint8_t bg2Changed{};
+		uint8_t bg3Changed{};
+		unsigned layerEnable{};
+		uint32_t writesEnd{};
+		GBALCD::RenderLineFunc renderLine{};
+		MixColorType *lineMix{};
+		std::binary_semaphore *semPtr{};
+		std::array<uint8_t, lcdRegsSize> regs{};
+
+		void setReplySemaphore(std::binary_semaphore *semPtr_) { semPtr = semPtr_; }
+	};
+
+	IG::SPSCMessagePort<Command, 64> port;
+	std::thread thread;
+	std::unique_ptr<GBALCD> lcd;
+	std::unique_ptr<GBAMem::IoMem> ioMem;
+	std::unique_ptr<MemWrite[]> writes;
+	uint32_t writeIdx{}; // CPU thread
+	uint32_t writesAppliedSeen{}; // CPU thread's last read of writesApplied
+	alignas(64) std::atomic_uint32_t writesApplied{}; // worker thread
+	uint16_t win0H{};
+	uint16_t win1H{};
+	uint8_t pendingClearMask{};
+	bool linesPending{};
+
+	void run();
+	void copyStateFrom(const GBALCD &, const GBAMem::IoMem &);
+	void copyStateTo(GBALCD &);
+	void applyWrites(uint32_t end);
+	void render(const Command &);
+	void send(CommandType, bool awaitReply = false);
+	void waitForWriteSpace();
+};
+
+static inline void logPPUWrite(GBALCD &lcd, const void *dest, unsigned bytes)
+{
+	if(lcd.ppuThread)
+		lcd.ppuThread->logWrite(lcd, dest, bytes);
+}
@@ -16,9 +16,13 @@ class EmuAudio;
 static const unsigned RTC_EMU_AUTO = 0, RTC_EMU_OFF = 1, RTC_EMU_ON = 2;
 
 extern Byte1Option optionRtcEmulation;
+extern Byte1Option optionPPUThread;
+extern Byte1Option optionCodeCache;
 extern bool detectedRtcGame;
 
 void setRTC(unsigned mode);
+void setPPUThread(bool on);
+void setCodeCache(bool on);
 void readCheatFile(IG::ApplicationContext);
 void writeCheatFile(IG::ApplicationContext);
 
@@ -23,7 +23,8 @@ namespace EmuEx
 
 enum
 {
-	CFGKEY_RTC_EMULATION = 256
+	CFGKEY_RTC_EMULATION = 256, CFGKEY_PPU_THREAD = 257,
+	CFGKEY_CODE_CACHE = 258
 };
 
 const char *EmuSystem::configFilename = "GbaEmu.config";
@@ -34,6 +35,8 @@ const AspectRatioInfo EmuSystem::aspectRatioInfo[]
 };
 const unsigned EmuSystem::aspectRatioInfos = std::size(EmuSystem::aspectRatioInfo);
 Byte1Option optionRtcEmulation(CFGKEY_RTC_EMULATION, RTC_EMU_AUTO, 0, optionIsValidWithMax<2>);
+Byte1Option optionPPUThread(CFGKEY_PPU_THREAD, 0);
+Byte1Option optionCodeCache(CFGKEY_CODE_CACHE, 0);
 
 bool EmuSystem::resetSessionOptions(EmuApp &)
 {
@@ -57,6 +60,23 @@ void EmuSystem::writeSessionConfig(IO &io)
 	optionRtcEmulation.writeWithKeyIfNotDefault(io);
 }
 
+bool EmuSystem::readConfig(IO &io, unsigned key, unsigned readSize)
+{
+	switch(key)
+	{
+		default: return 0;
+		bcase CFGKEY_PPU_THREAD: optionPPUThread.readFromIO(io, readSize);
+		bcase CFGKEY_CODE_CACHE: optionCodeCache.readFromIO(io, readSize);
+	}
+	return 1;
+}
+
+void EmuSystem::writeConfig(IO &io)
+{
+	optionPPUThread.writeWithKeyIfNotDefault(io);
+	optionCodeCache.writeWithKeyIfNotDefault(io);
+}
+
 void setRTC(unsigned mode)
 {
 	if(detectedRtcGame && mode == RTC_EMU_AUTO)
@@ -313,10 +313,24 @@ uint8_t v3_deadtable2[256] = {
 #define CHEAT_IS_HEX(a) (((a) >= 'A' && (a) <= 'F') || ((a) >= '0' && (a) <= '9'))
 
 #define CHEAT_PATCH_ROM_16BIT(a, v) \
-  WRITE16LE(((uint16_t*)&rom[(a)&0x1ffffff]), v);
+  cheatPatchRom<uint16_t>(cpu, a, v);
 
 #define CHEAT_PATCH_ROM_32BIT(a, v) \
-  WRITE32LE(((uint32_t*)&rom[(a)&0x1ffffff]), v);
+  cheatPatchRom<uint32_t>(cpu, a, v);
+
+template <class T>
+static void cheatPatchRom(ARM7TDMI &cpu, uint32_t address, T value)
+{
+  auto dest = (T*)&rom[address & 0x1ffffff];
+  T oldValue = *dest;
+  if constexpr (sizeof(T) == 2)
+    WRITE16LE(dest, value);
+  else
+    WRITE32LE(dest, value);
+  // ROM isn't tracked by the code cache since only cheats can write it
+  if (*dest != oldValue)
+    flushCodeCache(cpu);
+}
 
 static bool isMultilineWithData(int i)
 {
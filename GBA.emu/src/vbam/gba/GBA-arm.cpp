@@ -2274,6 +2274,120 @@ constexpr insnfunc_t armInsnTable[4096] = {
 
 // Wrapper routine (execution loop) ///////////////////////////////////////
 
+static inline __attribute__((always_inline)) bool armConditionPassed(ARM7TDMI &cpu, int cond)
+{
+    bool cond_res = true;
+    if (UNLIKELY(cond != 0x0E)) {  // most opcodes are AL (always)
+        switch (cond) {
+          case 0x00: // EQ
+            cond_res = Z_FLAG;
+            break;
+          case 0x01: // NE
+            cond_res = !Z_FLAG;
+            break;
+          case 0x02: // CS
+            cond_res = C_FLAG;
+            break;
+          case 0x03: // CC
+            cond_res = !C_FLAG;
+            break;
+          case 0x04: // MI
+            cond_res = N_FLAG;
+            break;
+          case 0x05: // PL
+            cond_res = !N_FLAG;
+            break;
+          case 0x06: // VS
+            cond_res = V_FLAG;
+            break;
+          case 0x07: // VC
+            cond_res = !V_FLAG;
+            break;
+          case 0x08: // HI
+            cond_res = C_FLAG && !Z_FLAG;
+            break;
+          case 0x09: // LS
+            cond_res = !C_FLAG || Z_FLAG;
+            break;
+          case 0x0A: // GE
+            cond_res = N_FLAG == V_FLAG;
+            break;
+          case 0x0B: // LT
+            cond_res = N_FLAG != V_FLAG;
+            break;
+          case 0x0C: // GT
+            cond_res = !Z_FLAG && (N_FLAG == V_FLAG);
+            break;
+          case 0x0D: // LE
+            cond_res = Z_FLAG || (N_FLAG != V_FLAG);
+            break;
+          /*case 0x0E: // AL (impossible, checked above)
+            cond_res = true;
+            break;*/
+          case 0x0F:
+          	cond_res = false;
+          	break;
+          default:
+            // ???
+          	bug_unreachable("invalid condition:0x%X", cond);
+            break;
+        }
+    }
+    return cond_res;
+}
+
+static constexpr unsigned armInsnIndex(uint32_t opcode)
+{
+    return ((opcode >> 16) & 0xFF0) | ((opcode >> 4) & 0x0F);
+}
+
+GBACodeCache::ArmHandler armInsnHandler(uint32_t opcode)
+{
+    return armInsnTable[armInsnIndex(opcode)];
+}
+
+// Runs instructions from a pre-decoded block, same as the loop in armExecute() except
+// the opcodes come from the block & the prefetch pipeline is only refilled on exit
+static bool armExecuteBlock(ARM7TDMI &cpu, GBACodeCache &cache)
+{
+    auto block = cache.armBlock(cpu, armNextPC);
+    if (!block)
+        return false;
+    int &cpuNextEvent = cpu.cpuNextEvent;
+    int &cpuTotalTicks = cpu.cpuTotalTicks;
+    // handlers like the HLE RegisterRamReset SWI can flush the cache, invalidating block->pc
+    const uint32_t blockPC = block->pc;
+    for (unsigned i = 0;;) {
+        auto &insn = block->insns[i++];
+        if ((armNextPC & 0x0803FFFF) == 0x08020000)
+          busPrefetchCount = 0x100;
+
+        busPrefetch = false;
+        if (busPrefetchCount & 0xFFFFFE00)
+            busPrefetchCount = 0x100 | (busPrefetchCount & 0xFF);
+
+        int clockTicks = 0;
+        int oldArmNextPC = armNextPC;
+        armNextPC = reg[15].I;
+        reg[15].I += 4;
+
+        if (armConditionPassed(cpu, insn.opcode >> 28))
+        	insn.handler(cpu, insn.opcode, clockTicks);
+
+        if (clockTicks == 0)
+            clockTicks = 1 + codeTicksAccessSeq32(oldArmNextPC);
+        cpuTotalTicks += clockTicks;
+
+        if (armNextPC != blockPC + i * 4)
+            return true; // branched and refilled the pipeline
+        if (i == block->size || cache.hasWrittenCode() ||
+        		!(cpuTotalTicks < cpuNextEvent && (!CONFIG_TRIGGER_ARM_STATE_EVENT && armState) && !cpu.SWITicks)) {
+            cpu.setPrefetch(block->insns[i].opcode, block->insns[i + 1].opcode);
+            return true;
+        }
+    }
+}
+
 #if 0
 #include <time.h>
 static void tester(void) {
@@ -2295,6 +2409,8 @@ int armExecute(ARM7TDMI &cpu)
     do {
 		if (cheatsEnabled) {
 			cpuMasterCodeCheck(cpu);
+		} else if (cpu.codeCache && armExecuteBlock(cpu, *cpu.codeCache)) {
+			continue;
 		}
 
         if ((armNextPC & 0x0803FFFF) == 0x08020000)
@@ -2331,67 +2447,9 @@ int armExecute(ARM7TDMI &cpu)
         }
 #endif
 
-        int cond = opcode >> 28;
-        bool cond_res = true;
-        if (UNLIKELY(cond != 0x0E)) {  // most opcodes are AL (always)
-            switch (cond) {
-              case 0x00: // EQ
-                cond_res = Z_FLAG;
-                break;
-              case 0x01: // NE
-                cond_res = !Z_FLAG;
-                break;
-              case 0x02: // CS
-                cond_res = C_FLAG;
-                break;
-              case 0x03: // CC
-                cond_res = !C_FLAG;
-                break;
-              case 0x04: // MI
-                cond_res = N_FLAG;
-                break;
-              case 0x05: // PL
-                cond_res = !N_FLAG;
-                break;
-              case 0x06: // VS
-                cond_res = V_FLAG;
-                break;
-              case 0x07: // VC
-                cond_res = !V_FLAG;
-                break;
-              case 0x08: // HI
-                cond_res = C_FLAG && !Z_FLAG;
-                break;
-              case 0x09: // LS
-                cond_res = !C_FLAG || Z_FLAG;
-                break;
-              case 0x0A: // GE
-                cond_res = N_FLAG == V_FLAG;
-                break;
-              case 0x0B: // LT
-                cond_res = N_FLAG != V_FLAG;
-                break;
-              case 0x0C: // GT
-                cond_res = !Z_FLAG && (N_FLAG == V_FLAG);
-                break;
-              case 0x0D: // LE
-                cond_res = Z_FLAG || (N_FLAG != V_FLAG);
-                break;
-              /*case 0x0E: // AL (impossible, checked above)
-                cond_res = true;
-                break;*/
-              case 0x0F:
-              	cond_res = false;
-              	break;
-              default:
-                // ???
-              	bug_unreachable("invalid condition:0x%X", cond);
-                break;
-            }
-        }
-
+        bool cond_res = armConditionPassed(cpu, opcode >> 28);
         if (cond_res)
-        	(*armInsnTable[((opcode >> 16) & 0xFF0) | ((opcode >> 4) & 0x0F)])(cpu, opcode, clockTicks);
+        	(*armInsnTable[armInsnIndex(opcode)])(cpu, opcode, clockTicks);
 #ifdef INSN_COUNTER
         count(opcode, cond_res);
 #endif
@@ -1628,6 +1628,45 @@ constexpr insnfunc_t thumbInsnTable[1024] = {
 
 // Wrapper routine (execution loop) ///////////////////////////////////////
 
+GBACodeCache::ThumbHandler thumbInsnHandler(uint32_t opcode)
+{
+    return thumbInsnTable[opcode >> 6];
+}
+
+// Runs instructions from a pre-decoded block, same as the loop in thumbExecute() except
+// the opcodes come from the block & the prefetch pipeline is only refilled on exit
+static bool thumbExecuteBlock(ARM7TDMI &cpu, GBACodeCache &cache)
+{
+  auto block = cache.thumbBlock(cpu, armNextPC);
+  if (!block)
+    return false;
+  int &cpuNextEvent = cpu.cpuNextEvent;
+  int &cpuTotalTicks = cpu.cpuTotalTicks;
+  // handlers like the HLE RegisterRamReset SWI can flush the cache, invalidating block->pc
+  const uint32_t blockPC = block->pc;
+  for (unsigned i = 0;;) {
+    auto &insn = block->insns[i++];
+    busPrefetch = false;
+    uint32_t oldArmNextPC = armNextPC;
+    armNextPC = reg[15].I;
+    reg[15].I += 2;
+
+    int clockTicks = insn.handler(cpu, insn.opcode, oldArmNextPC);
+
+    if (clockTicks == 0)
+        clockTicks = codeTicksAccessSeq16(oldArmNextPC) + 1;
+    cpuTotalTicks += clockTicks;
+
+    if (armNextPC != blockPC + i * 2)
+      return true; // branched and refilled the pipeline
+    if (i == block->size || cache.hasWrittenCode() ||
+    		!(cpuTotalTicks < cpuNextEvent && (!CONFIG_TRIGGER_ARM_STATE_EVENT && !armState) && !cpu.SWITicks)) {
+      cpu.setPrefetch(block->insns[i].opcode, block->insns[i + 1].opcode);
+      return true;
+    }
+  }
+}
+
 int thumbExecute(ARM7TDMI &cpu)
 {
 	int &cpuNextEvent = cpu.cpuNextEvent;
@@ -1635,6 +1674,8 @@ int thumbExecute(ARM7TDMI &cpu)
   do {
 	  if (cheatsEnabled) {
 		  cpuMasterCodeCheck(cpu);
+	  } else if (cpu.codeCache && thumbExecuteBlock(cpu, *cpu.codeCache)) {
+		  continue;
 	  }
 
     //if ((armNextPC & 0x0803FFFF) == 0x08020000)
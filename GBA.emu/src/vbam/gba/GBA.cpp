@@ -618,34 +618,12 @@ inline int CPUUpdateTicks(ARM7TDMI &cpu)
 
 static void CPUUpdateWindow0(GBASys &gba)
 {
-  int x00 = WIN0H >> 8;
-  int x01 = WIN0H & 255;
-
-  if (x00 <= x01) {
-    for (int i = 0; i < 240; i++) {
-      gfxInWin0[i] = (i >= x00 && i < x01);
-    }
-  } else {
-    for (int i = 0; i < 240; i++) {
-    	gfxInWin0[i] = (i >= x00 || i < x01);
-    }
-  }
+  GBALCD::updateWindow(gfxInWin0, WIN0H);
 }
 
 static void CPUUpdateWindow1(GBASys &gba)
 {
-  int x00 = WIN1H >> 8;
-  int x01 = WIN1H & 255;
-
-  if (x00 <= x01) {
-    for (int i = 0; i < 240; i++) {
-    	gfxInWin1[i] = (i >= x00 && i < x01);
-    }
-  } else {
-    for (int i = 0; i < 240; i++) {
-    	gfxInWin1[i] = (i >= x00 || i < x01);
-    }
-  }
+  GBALCD::updateWindow(gfxInWin1, WIN1H);
 }
 
 #define CPUUpdateTicks() CPUUpdateTicks(cpu)
@@ -681,6 +659,14 @@ static void CPUUpdateWindow1(GBASys &gba)
 
 static void CPUUpdateRenderBuffers(GBASys &gba, bool force)
 {
+  if (gba.lcd.ppuThread) {
+    unsigned layerMask = 0;
+    for (unsigned i = 0; i < 4; i++) {
+      if (!(layerEnable & (0x0100 << i)) || force)
+        layerMask |= 1 << i;
+    }
+    gba.lcd.ppuThread->clearLineBuffers(layerMask);
+  }
   if (!(layerEnable & 0x0100) || force) {
     CLEAR_ARRAY(line0);
   }
@@ -873,7 +859,8 @@ bool CPUWriteState(IG::ApplicationContext ctx, GBASys &gba, const char* file)
 
 bool CPUWriteMemState(GBASys &gba, char *memory, int available, long& reserved)
 {
-  gzFile gzFile = utilMemGzOpen(memory, available, "w");
+  // in-memory states are usually short-lived, skip compression
+  gzFile gzFile = utilMemGzOpen(memory, available, "w0");
 
   if (gzFile == NULL) {
     return false;
@@ -881,19 +868,25 @@ bool CPUWriteMemState(GBASys &gba, char *memory, int available, long& reserved)
 
   bool res = CPUWriteState(gba, gzFile);
 
-  reserved = utilGzMemTell(gzFile)+8;
+  if (utilGzClose(gzFile) != Z_OK)
+    res = false;
+
+  // the header after the 4 byte tag stores the size of the remaining data
+  int dataSize;
+  memcpy(&dataSize, memory + 4, sizeof(dataSize));
+  reserved = dataSize + 8;
 
+  // a completely filled buffer means the trailer may have been truncated
   if (reserved >= (available))
     res = false;
 
-  utilGzClose(gzFile);
-
   return res;
 }
 
 static bool CPUReadState(GBASys &gba, gzFile gzFile)
 {
 	auto &cpu = gba.cpu;
+  flushCodeCache(cpu); // memory is replaced without going through the write functions
   int version = utilReadInt(gzFile);
 
   if (version > SAVE_GAME_VERSION || version < SAVE_GAME_VERSION_1) {
@@ -3644,6 +3637,7 @@ void CPUReset(GBASys &gba)
   SetSaveType(saveType);
 
   gba.cpu.ARM_PREFETCH();
+  flushCodeCache(gba.cpu);
 
   systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 
@@ -3896,7 +3890,11 @@ void CPULoop(GBASys &gba, EmuEx::EmuSystemTaskContext taskCtx, EmuEx::EmuVideo *
               uint32_t ext = (joy >> 10);
               // If no (m) code is enabled, apply the cheats at each LCDline
               if (cheatsList.size())
+              {
               	remainingTicks += cheatsCheckKeys(cpu, P1 ^ 0x3FF, 0);
+              	if (gba.lcd.ppuThread) // cheats write memory directly
+              		gba.lcd.ppuThread->reloadMemory(gba.lcd);
+              }
 
 #if 0
               speedup = false;
@@ -4061,11 +4059,17 @@ void CPULoop(GBASys &gba, EmuEx::EmuSystemTaskContext taskCtx, EmuEx::EmuVideo *
             	else
             	{
             	}*/
-              (*gba.lcd.renderLine)(gba.lcd.lineMix, gba.lcd, ioMem);
+              if (gba.lcd.ppuThread)
+                gba.lcd.ppuThread->renderLine(gba.lcd, ioMem);
+              else
+                (*gba.lcd.renderLine)(gba.lcd.lineMix, gba.lcd, ioMem);
             }
             if (VCOUNT == 159)
             {
             	cpuBreakLoop = true;
+              // wait for the PPU thread every frame so states are never taken while it renders
+              if (gba.lcd.ppuThread)
+                gba.lcd.ppuThread->finishFrame();
               if (video)
               {
             	  systemDrawScreen(taskCtx, *video);
@@ -159,7 +159,7 @@ extern void CPUCleanUp();
 extern void CPUUpdateRender(GBASys &gba);
 extern void CPUUpdateRenderBuffers(bool);
 extern bool CPUReadMemState(GBASys &gba, char *, int);
-extern bool CPUWriteMemState(GBASys &gba, char *, int);
+extern bool CPUWriteMemState(GBASys &gba, char *, int, long &);
 #ifdef __LIBRETRO__
 extern bool CPUReadState(const uint8_t*, unsigned);
 extern unsigned int CPUWriteState(uint8_t* data, unsigned int size);
@@ -8,6 +8,8 @@
 #include "RTC.h"
 #include "Sound.h"
 #include "agbprint.h"
+#include <main/PPUThread.hh>
+#include <main/CodeCache.hh>
 
 constexpr uint32_t objTilesAddress[3]{0x010000, 0x014000, 0x014000};
 
@@ -482,6 +484,7 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, uint32_t address, uint32_t valu
         else
 #endif
             WRITE32LE(((uint32_t*)&workRAM[address & 0x3FFFC]), value);
+        invalidateCodeCache(cpu, address);
         break;
     case 0x03:
 #ifdef BKPT_SUPPORT
@@ -490,6 +493,7 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, uint32_t address, uint32_t valu
         else
 #endif
             WRITE32LE(((uint32_t*)&internalRAM[address & 0x7ffC]), value);
+        invalidateCodeCache(cpu, address);
         break;
     case 0x04:
         if (address < 0x4000400) {
@@ -504,7 +508,10 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, uint32_t address, uint32_t valu
             cheatsWriteMemory(address & 0x70003FC, value);
         else
 #endif
+        {
             WRITE32LE(((uint32_t*)&paletteRAM[address & 0x3FC]), value);
+            logPPUWrite(cpu.gba->lcd, &paletteRAM[address & 0x3FC], 4);
+        }
         break;
     case 0x06:
         address = (address & 0x1fffc);
@@ -519,7 +526,10 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, uint32_t address, uint32_t valu
         else
 #endif
 
+        {
             WRITE32LE(((uint32_t*)&vram[address]), value);
+            logPPUWrite(cpu.gba->lcd, &vram[address], 4);
+        }
         break;
     case 0x07:
 #ifdef BKPT_SUPPORT
@@ -527,7 +537,10 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, uint32_t address, uint32_t valu
             cheatsWriteMemory(address & 0x70003FC, value);
         else
 #endif
+        {
             WRITE32LE(((uint32_t*)&oam[address & 0x3fc]), value);
+            logPPUWrite(cpu.gba->lcd, &oam[address & 0x3fc], 4);
+        }
         break;
     case 0x0D:
         if (cpuEEPROMEnabled) {
@@ -586,6 +599,7 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, uint32_t address, uint16_t va
         else
 #endif
             WRITE16LE(((uint16_t*)&workRAM[address & 0x3FFFE]), value);
+        invalidateCodeCache(cpu, address);
         break;
     case 3:
 #ifdef BKPT_SUPPORT
@@ -594,6 +608,7 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, uint32_t address, uint16_t va
         else
 #endif
             WRITE16LE(((uint16_t*)&internalRAM[address & 0x7ffe]), value);
+        invalidateCodeCache(cpu, address);
         break;
     case 4:
         if (address < 0x4000400)
@@ -607,7 +622,10 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, uint32_t address, uint16_t va
             cheatsWriteHalfWord(address & 0x70003fe, value);
         else
 #endif
+        {
             WRITE16LE(((uint16_t*)&paletteRAM[address & 0x3fe]), value);
+            logPPUWrite(cpu.gba->lcd, &paletteRAM[address & 0x3fe], 2);
+        }
         break;
     case 6:
         address = (address & 0x1fffe);
@@ -620,7 +638,10 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, uint32_t address, uint16_t va
             cheatsWriteHalfWord(address + 0x06000000, value);
         else
 #endif
+        {
             WRITE16LE(((uint16_t*)&vram[address]), value);
+            logPPUWrite(cpu.gba->lcd, &vram[address], 2);
+        }
         break;
     case 7:
 #ifdef BKPT_SUPPORT
@@ -628,7 +649,10 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, uint32_t address, uint16_t va
             cheatsWriteHalfWord(address & 0x70003fe, value);
         else
 #endif
+        {
             WRITE16LE(((uint16_t*)&oam[address & 0x3fe]), value);
+            logPPUWrite(cpu.gba->lcd, &oam[address & 0x3fe], 2);
+        }
         break;
     case 8:
     case 9:
@@ -685,6 +709,7 @@ static inline void CPUWriteByte(ARM7TDMI &cpu, uint32_t address, uint8_t b)
         else
 #endif
             workRAM[address & 0x3FFFF] = b;
+        invalidateCodeCache(cpu, address);
         break;
     case 3:
 #ifdef BKPT_SUPPORT
@@ -693,6 +718,7 @@ static inline void CPUWriteByte(ARM7TDMI &cpu, uint32_t address, uint8_t b)
         else
 #endif
             internalRAM[address & 0x7fff] = b;
+        invalidateCodeCache(cpu, address);
         break;
     case 4:
         if (address < 0x4000400) {
@@ -763,6 +789,7 @@ static inline void CPUWriteByte(ARM7TDMI &cpu, uint32_t address, uint8_t b)
     case 5:
         // no need to switch
         *((uint16_t*)&paletteRAM[address & 0x3FE]) = (b << 8) | b;
+        logPPUWrite(cpu.gba->lcd, &paletteRAM[address & 0x3FE], 2);
         break;
     case 6:
         address = (address & 0x1fffe);
@@ -779,7 +806,10 @@ static inline void CPUWriteByte(ARM7TDMI &cpu, uint32_t address, uint8_t b)
                 cheatsWriteByte(address + 0x06000000, b);
             else
 #endif
+            {
                 *((uint16_t*)&vram[address]) = (b << 8) | b;
+                logPPUWrite(cpu.gba->lcd, &vram[address], 2);
+            }
         }
         break;
     case 7:
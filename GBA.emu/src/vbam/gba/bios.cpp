@@ -878,6 +878,9 @@ void BIOS_RegisterRamReset(ARM7TDMI &cpu, uint32_t flags)
     	memset(internalRAM, 0, 0x7e00); // don't clear 0x7e00-0x7fff
     }
     cpu.gba->lcd.registerRamReset(flags);
+    if (cpu.gba->lcd.ppuThread)
+      cpu.gba->lcd.ppuThread->reloadMemory(cpu.gba->lcd);
+    flushCodeCache(cpu);
     /*if (flags & 0x04) {
       // clear palette RAM
       memset(paletteRAM, 0, 0x400);
@@ -1075,6 +1078,7 @@ void BIOS_SoftReset(ARM7TDMI &cpu)
 
   cpu.softReset(internalRAM[0x7ffa]);
   memset(&internalRAM[0x7e00], 0, 0x200);
+  flushCodeCache(cpu);
 
   /*armState = true;
   armMode = 0x1F;
@@ -159,7 +159,12 @@ public:
 	  */
 	bool loadState(std::string const &filepath);
 
-	bool loadState(std::istream &file);
+	/**
+	  * Loads emulator state from a stream.
+	  * @param  saveSavedata write the current save data to disk before loading, if any.
+	  * @return success
+	  */
+	bool loadState(std::istream &file, bool saveSavedata = true);
 
 	/**
 	  * Selects which state slot to save state to or load state from.
@@ -163,9 +163,10 @@ bool GB::loadState(std::string const &filepath) {
 	return false;
 }
 
-bool GB::loadState(std::istream &file) {
+bool GB::loadState(std::istream &file, bool saveSavedata) {
 	if (p_->cpu.loaded()) {
-		p_->cpu.saveSavedata();
+		if (saveSavedata)
+			p_->cpu.saveSavedata();
 
 		SaveState state = SaveState();
 		p_->cpu.setStatePtrs(state);
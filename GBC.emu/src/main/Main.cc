@@ -21,6 +21,8 @@
 #include <imagine/util/ScopeGuard.hh>
 #include <imagine/util/format.hh>
 #include <imagine/fs/FS.hh>
+#include <imagine/io/MapIO.hh>
+#include <imagine/io/IOStream.hh>
 #include <gambatte.h>
 #include <libgambatte/src/video/lcddef.h>
 #include <resample/resampler.h>
@@ -28,6 +30,7 @@
 #include <main/Cheats.hh>
 #include <main/Palette.hh>
 #include "internal.hh"
+#include <sstream>
 
 namespace EmuEx
 {
@@ -137,6 +140,28 @@ void EmuSystem::loadState(EmuApp &app, IG::CStringView path)
 		throwFileReadError();
 }
 
+size_t EmuSystem::stateSize()
+{
+	std::ostringstream stream;
+	gbEmu.saveState(nullptr, 0, stream);
+	return stream.tellp();
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	IG::OStream<IG::MapIO> stream{IG::MapIO{IG::ByteBuffer{buff}}};
+	if(!gbEmu.saveState(nullptr, 0, stream))
+		throwFileWriteError();
+	return stream.tellp();
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	IG::IStream<IG::MapIO> stream{IG::MapIO{IG::ByteBuffer{{const_cast<uint8_t*>(buff.data()), buff.size()}}}};
+	if(!gbEmu.loadState(stream, false))
+		throwFileReadError();
+}
+
 void EmuSystem::saveBackupMem(IG::ApplicationContext ctx)
 {
 	logMsg("saving battery");
@@ -294,7 +294,7 @@ void state_load(const unsigned char *buffer)
 	}
 }
 
-int state_save(unsigned char *buffer)
+int state_save(unsigned char *buffer, size_t bufferSize, int compressionLevel)
 {
 	auto state = std::make_unique<unsigned char[]>(STATE_SIZE);
 
@@ -394,10 +394,14 @@ int state_save(unsigned char *buffer)
 
   /* compress state file */
   unsigned long inbytes   = bufferptr;
-  unsigned long outbytes  = STATE_SIZE;
+  unsigned long outbytes  = bufferSize - 4;
   logMsg("compressing %d bytes to buffer of %d size", (int)inbytes, (int)outbytes);
-  int ret = compress2 ((Bytef *)(buffer + 4), &outbytes, (Bytef *)state.get(), inbytes, 9);
+  int ret = compress2 ((Bytef *)(buffer + 4), &outbytes, (Bytef *)state.get(), inbytes, compressionLevel);
   logMsg("compress2 returned %d, reduced to %d bytes", ret, (int)outbytes);
+  if(ret != Z_OK)
+  {
+    throw std::runtime_error(fmt::format("Error {} during compress", ret));
+  }
   uint32 outbytes32 = outbytes; // assumes no save states will ever be over 4GB
   memcpy(buffer, &outbytes32, 4);
 
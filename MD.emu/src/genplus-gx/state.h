@@ -41,6 +41,6 @@
 
 /* Function prototypes */
 void state_load(const unsigned char *buffer);
-int state_save(unsigned char *buffer);
+int state_save(unsigned char *buffer, size_t bufferSize = STATE_SIZE + 4, int compressionLevel = 9);
 
 #endif
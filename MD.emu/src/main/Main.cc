@@ -41,6 +41,7 @@
 #include <imagine/io/FileIO.hh>
 #include <imagine/util/format.hh>
 #include <imagine/util/ScopeGuard.hh>
+#include <zlib.h>
 
 t_config config{};
 t_bitmap bitmap{};
@@ -166,6 +167,28 @@ void EmuSystem::loadState(EmuApp &app, IG::CStringView path)
 	state_load(FileUtils::bufferFromUri(app.appContext(), path).data());
 }
 
+size_t EmuSystem::stateSize()
+{
+	return compressBound(STATE_SIZE) + 4;
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	// skip compression since in-memory states are usually short-lived
+	return state_save(buff.data(), buff.size(), Z_NO_COMPRESSION);
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	if(buff.size() < 4)
+		throwFileReadError();
+	uint32_t compressedSize;
+	memcpy(&compressedSize, buff.data(), 4);
+	if(compressedSize > buff.size() - 4)
+		throwFileReadError();
+	state_load(buff.data());
+}
+
 static bool sramHasContent(std::span<uint8> sram)
 {
 	for(auto v : sram)
@@ -383,7 +406,7 @@ void EmuSystem::loadGame(IG::ApplicationContext ctx, IO &io, EmuSystemCreatePara
 		{
 			throwMissingContentDirError();
 		}
-		cd = CDAccess_Open(&NVFS, std::string{contentLocation()}, false);
+		cd = CDAccess_Open(&NVFS, std::string{contentFileLocation()}, false);
 
 		unsigned region = REGION_USA;
 		if (config.region_detect == 1) region = REGION_USA;
@@ -471,21 +471,14 @@ FS::FileString EmuSystem::stateFilename(int slot, std::string_view name)
 	return IG::format<FS::FileString>("{}.0{}.sta", name, saveSlotCharUpper(slot));
 }
 
-static void saveBlueMSXState(const char *filename)
+static bool writeBlueMSXState(const char *filename)
 {
-	if(!zipStartWrite(filename))
-	{
-		logErr("error creating zip:%s", filename);
-		EmuSystem::throwFileWriteError();
-	}
 	saveStateCreateForWrite(filename);
 	int rv = zipSaveFile(filename, "version", 0, saveStateVersion, sizeof(saveStateVersion));
 	if (!rv)
 	{
 		saveStateDestroy();
-		zipEndWrite();
-		logErr("error writing to zip:%s", filename);
-		EmuSystem::throwFileWriteError();
+		return false;
 	}
 
 	SaveState* state = saveStateOpenForWrite("board");
@@ -514,7 +507,22 @@ static void saveBlueMSXState(const char *filename)
 	machineSaveState(machine);
 	boardInfo.saveState();
 	saveStateDestroy();
-	zipEndWrite();
+	return true;
+}
+
+static void saveBlueMSXState(const char *filename)
+{
+	if(!zipStartWrite(filename))
+	{
+		logErr("error creating zip:%s", filename);
+		EmuSystem::throwFileWriteError();
+	}
+	auto endWrite = IG::scopeGuard([](){ zipEndWrite(); });
+	if(!writeBlueMSXState(filename))
+	{
+		logErr("error writing to zip:%s", filename);
+		EmuSystem::throwFileWriteError();
+	}
 }
 
 void EmuSystem::saveState(IG::ApplicationContext ctx, IG::CStringView path)
@@ -598,6 +606,44 @@ void EmuSystem::loadState(EmuApp &app, IG::CStringView path)
 	return loadBlueMSXState(app, path);
 }
 
+size_t EmuSystem::stateSize()
+{
+	return saveState(std::span<uint8_t>{});
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	zipStartMemWrite(buff);
+	bool success = writeBlueMSXState("");
+	auto size = zipEndMemWrite();
+	if(!success || !size)
+		throwFileWriteError();
+	return size;
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	// the machine & media don't change within a session, so unlike
+	// loadBlueMSXState() only the board state is restored
+	assert(machine);
+	zipStartMemRead(buff);
+	saveStateCreateForRead("");
+	auto endRead = IG::scopeGuard([](){ saveStateDestroy(); zipEndMemRead(); });
+	int size;
+	char *version = (char*)zipLoadFile("", "version", &size);
+	if(!version)
+	{
+		throwFileReadError();
+	}
+	bool versionMatches = !strncmp(version, saveStateVersion, sizeof(saveStateVersion) - 1);
+	free(version);
+	if(!versionMatches)
+	{
+		throw std::runtime_error("Incorrect state version");
+	}
+	boardInfo.loadState();
+}
+
 void EmuSystem::saveBackupMem(IG::ApplicationContext ctx)
 {
 	if(gameIsRunning())
@@ -17,6 +17,10 @@ extern Machine *machine;
 
 bool zipStartWrite(const char *fileName);
 void zipEndWrite();
+void zipStartMemWrite(std::span<uint8_t> buff);
+size_t zipEndMemWrite();
+void zipStartMemRead(std::span<const uint8_t> buff);
+void zipEndMemRead();
 IG::Pixmap frameBufferPixmap();
 HdType boardGetHdType(int hdIndex);
 
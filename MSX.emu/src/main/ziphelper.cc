@@ -31,6 +31,15 @@ static struct archive *writeArch{};
 static FS::ArchiveIterator cachedZipIt{};
 static FS::PathString cachedZipName{};
 
+// In-memory states skip the zip archive and store each file uncompressed as:
+// null-terminated name, 32-bit size, data. An empty write buffer only counts bytes.
+static struct
+{
+	std::span<uint8_t> buff;
+	size_t size;
+	bool writing, reading, overflow;
+} memZip{};
+
 void zipCacheReadOnlyZip(const char* zipName)
 {
 	if(zipName && strlen(zipName))
@@ -72,8 +81,49 @@ static void *loadFromArchiveIt(FS::ArchiveIterator &it, const char* zipName, con
 	return nullptr;
 }
 
+static void *loadFromMemZip(const char* fileName, int* size)
+{
+	size_t pos = 0;
+	auto buff = memZip.buff;
+	while(pos < buff.size())
+	{
+		auto namePtr = (const char*)&buff[pos];
+		auto nameLen = strnlen(namePtr, buff.size() - pos);
+		pos += nameLen + 1;
+		uint32_t fileSize;
+		if(pos + sizeof(fileSize) > buff.size())
+			break;
+		memcpy(&fileSize, &buff[pos], sizeof(fileSize));
+		pos += sizeof(fileSize);
+		if(fileSize > buff.size() - pos)
+			break;
+		if(std::string_view{namePtr, nameLen} == fileName)
+		{
+			void *data = malloc(fileSize);
+			memcpy(data, &buff[pos], fileSize);
+			*size = fileSize;
+			return data;
+		}
+		pos += fileSize;
+	}
+	logErr("file %s not in memory state", fileName);
+	return nullptr;
+}
+
+void zipStartMemRead(std::span<const uint8_t> buff)
+{
+	memZip = {.buff{const_cast<uint8_t*>(buff.data()), buff.size()}, .reading = true};
+}
+
+void zipEndMemRead()
+{
+	memZip = {};
+}
+
 void* zipLoadFile(const char* zipName, const char* fileName, int* size)
 {
+	if(memZip.reading)
+		return loadFromMemZip(fileName, size);
 	try
 	{
 		if(cachedZipIt.hasEntry() && cachedZipName == zipName)
@@ -111,8 +161,43 @@ bool zipStartWrite(const char *fileName)
 	return true;
 }
 
+void zipStartMemWrite(std::span<uint8_t> buff)
+{
+	memZip = {.buff{buff}, .writing = true};
+}
+
+size_t zipEndMemWrite()
+{
+	auto size = memZip.overflow ? 0 : memZip.size;
+	memZip = {};
+	return size;
+}
+
+static int saveToMemZip(const char* fileName, const void* buffer, int size)
+{
+	auto nameLen = strlen(fileName) + 1;
+	uint32_t fileSize = size;
+	auto entrySize = nameLen + sizeof(fileSize) + fileSize;
+	if(memZip.buff.data())
+	{
+		if(entrySize > memZip.buff.size() - memZip.size)
+		{
+			memZip.overflow = true;
+			return 0;
+		}
+		auto outPtr = &memZip.buff[memZip.size];
+		memcpy(outPtr, fileName, nameLen);
+		memcpy(outPtr + nameLen, &fileSize, sizeof(fileSize));
+		memcpy(outPtr + nameLen + sizeof(fileSize), buffer, fileSize);
+	}
+	memZip.size += entrySize;
+	return 1;
+}
+
 int zipSaveFile(const char* zipName, const char* fileName, int append, const void* buffer, int size)
 {
+	if(memZip.writing)
+		return saveToMemZip(fileName, buffer, size);
 	assert(writeArch);
 	auto entry = archive_entry_new();
 	auto freeEntry = IG::scopeGuard([&](){ archive_entry_free(entry); });
@@ -444,43 +444,47 @@ bool save_state(char *game,int slot) {
 
 #else
 
-static gzFile open_state(void *contextPtr, const char *st_name, int mode) {
-	char string[20];
-	char *m=(mode==STWRITE?"wb":"rb");
-	gzFile gzf;
-	int  flags;
-	Uint32 rate;
-
-	if ((gzf = gzopenHelper(contextPtr, st_name, m)) == NULL) {
-		logMsg("%s not found\n", st_name);
-		return NULL;
-    }
+static const char *stateSig = "GNGST3";
 
-	static const char *stateSig = "GNGST3";
+static int mkstate_header(gzFile gzf, int mode) {
+	char string[20];
+	int flags=m68k_flag | z80_flag | endian_flag;
 
 	if(mode==STREAD) {
 
 		memset(string, 0, 20);
-		gzread(gzf, string, 6);
+		mkstate_data(gzf, string, 6, STREAD);
 
-		if (strcmp(string, stateSig)) {
-			logMsg("%s is not a valid gngeo st file", st_name);
-			gzclose(gzf);
-			return NULL;
-		}
+		if (strcmp(string, stateSig))
+			return false;
 
-		gzread(gzf, &flags, sizeof (int));
+		mkstate_data(gzf, &flags, sizeof (int), STREAD);
 
 		if (flags != (m68k_flag | z80_flag | endian_flag)) {
 			logMsg("This save state comes from a different endian architecture.\n"
 					"This is not currently supported :(");
-			gzclose(gzf);
-			return NULL;
+			return false;
 		}
 	} else {
-		int flags=m68k_flag | z80_flag | endian_flag;
-		gzwrite(gzf, stateSig, 6);
-		gzwrite(gzf, &flags, sizeof(int));
+		mkstate_data(gzf, (void*)stateSig, 6, STWRITE);
+		mkstate_data(gzf, &flags, sizeof(int), STWRITE);
+	}
+	return true;
+}
+
+static gzFile open_state(void *contextPtr, const char *st_name, int mode) {
+	char *m=(mode==STWRITE?"wb":"rb");
+	gzFile gzf;
+
+	if ((gzf = gzopenHelper(contextPtr, st_name, m)) == NULL) {
+		logMsg("%s not found\n", st_name);
+		return NULL;
+    }
+
+	if (!mkstate_header(gzf, mode)) {
+		logMsg("%s is not a valid gngeo st file", st_name);
+		gzclose(gzf);
+		return NULL;
 	}
 	return gzf;
 }
@@ -491,7 +495,37 @@ static gzFile open_state(void *contextPtr, const char *st_name, int mode) {
 	return open_stateWithName(st_name, mode);
 }*/
 
+/* When memState is active mkstate_data() reads/writes its buffer instead of
+ * the gzFile, a NULL data pointer only counts the bytes written */
+static struct {
+	Uint8 *data;
+	Uint32 size;
+	Uint32 pos;
+	int active;
+	int overflow;
+} memState;
+
+static int mkstate_mem_data(void *data, int size, int mode) {
+	if (mode==STREAD) {
+		if ((Uint32)size > memState.size - memState.pos) {
+			memState.overflow = 1;
+			size = memState.size - memState.pos;
+		}
+		memcpy(data, memState.data + memState.pos, size);
+	} else if (memState.data) {
+		if ((Uint32)size > memState.size - memState.pos) {
+			memState.overflow = 1;
+			return 0;
+		}
+		memcpy(memState.data + memState.pos, data, size);
+	}
+	memState.pos += size;
+	return size;
+}
+
 int mkstate_data(gzFile gzf,void *data,int size,int mode) {
+	if (memState.active)
+		return mkstate_mem_data(data,size,mode);
 	if (mode==STREAD)
 		return gzread(gzf,data,size);
 	return gzwrite(gzf,data,size);
@@ -553,8 +587,7 @@ int save_stateWithName(void *contextPtr, const char *name) {
 	return true;
 }
 
-int load_stateWithName(void *contextPtr, const char *name) {
-	gzFile gzf;
+static void load_state_data(gzFile gzf) {
 	/* Save pointers */
 	Uint8 *ng_lo = memory.ng_lo;
 	Uint8 *fix_game_usage=memory.fix_game_usage;
@@ -563,9 +596,6 @@ int load_stateWithName(void *contextPtr, const char *name) {
 //	GAME_ROMS r;
 //	memcpy(&r,&memory.rom,sizeof(GAME_ROMS));
 	
-	if ((gzf = open_state(contextPtr, name, STREAD))==NULL)
-		return false;
-
 	//gzread(gzf,state_img_tmp->pixels,304*224*2);
 
 	neogeo_mkstate(gzf,STREAD);
@@ -599,10 +629,45 @@ int load_stateWithName(void *contextPtr, const char *name) {
 		current_fix = memory.rom.bios_sfix.p;
 		fix_usage = memory.fix_board_usage;
 	}
+}
+
+int load_stateWithName(void *contextPtr, const char *name) {
+	gzFile gzf;
+
+	if ((gzf = open_state(contextPtr, name, STREAD))==NULL)
+		return false;
+
+	load_state_data(gzf);
 
 	gzclose(gzf);
 	return true;
 }
+
+Uint32 save_stateToMem(Uint8 *buf, Uint32 size) {
+	memState.data = buf;
+	memState.size = size;
+	memState.pos = 0;
+	memState.overflow = 0;
+	memState.active = 1;
+	mkstate_header(NULL, STWRITE);
+	neogeo_mkstate(NULL, STWRITE);
+	memState.active = 0;
+	return memState.overflow ? 0 : memState.pos;
+}
+
+int load_stateFromMem(const Uint8 *buf, Uint32 size) {
+	int ok;
+	memState.data = (Uint8*)buf;
+	memState.size = size;
+	memState.pos = 0;
+	memState.overflow = 0;
+	memState.active = 1;
+	ok = mkstate_header(NULL, STREAD);
+	if (ok)
+		load_state_data(NULL);
+	memState.active = 0;
+	return ok && !memState.overflow;
+}
 #endif
 
 #if 0
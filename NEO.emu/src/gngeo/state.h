@@ -92,6 +92,8 @@ void set_post_load_function(ST_MODULE_TYPE module,void (*func)(void));
 //SDL_Surface *load_state_img(char *game,int slot);
 int save_stateWithName(void *contextPtr, const char *name);
 int load_stateWithName(void *contextPtr, const char *name);
+Uint32 save_stateToMem(Uint8 *buf, Uint32 size); /* returns bytes written or 0 if buf is too small, a NULL buf only returns the size */
+int load_stateFromMem(const Uint8 *buf, Uint32 size);
 Uint32 how_many_slot(char *game);
 int mkstate_data(gzFile gzf,void *data,int size,int mode);
 gzFile gzopenHelper(void *contextPtr, const char *filename, const char *mode);
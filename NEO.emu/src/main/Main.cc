@@ -146,6 +146,25 @@ void EmuSystem::loadState(EmuApp &app, IG::CStringView path)
 		return EmuSystem::throwFileReadError();
 }
 
+size_t EmuSystem::stateSize()
+{
+	return save_stateToMem(nullptr, 0);
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	auto size = save_stateToMem(buff.data(), buff.size());
+	if(!size)
+		EmuSystem::throwFileWriteError();
+	return size;
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	if(!load_stateFromMem(buff.data(), buff.size()))
+		EmuSystem::throwFileReadError();
+}
+
 static auto nvramPath(IG::ApplicationContext ctx)
 {
 	return EmuSystem::contentSaveFilePath(ctx, ".nv");
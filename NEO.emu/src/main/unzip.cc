@@ -22,6 +22,7 @@
 #include <imagine/logger/logger.h>
 #include <imagine/util/string.h>
 #include <cstdlib>
+#include <utility>
 
 extern "C"
 {
@@ -31,21 +32,25 @@ extern "C"
 
 using namespace IG;
 
-struct PKZIP : public FS::ArchiveIterator {};
+struct PKZIP : public FS::ArchiveIterator
+{
+	using ArchiveIterator::ArchiveIterator;
+	bool entryOpened{}; // current entry's data was read by a previous gn_unzip_fopen()
+};
 
 struct ZFILE
 {
 	ArchiveIO io;
-	FS::ArchiveIterator *arch;
+	PKZIP *arch;
 };
 
-ZFILE *gn_unzip_fopen(PKZIP *archPtr, const char *filename, uint32_t fileCRC)
+static ZFILE *openEntry(PKZIP *archPtr, const char *filename, uint32_t fileCRC)
 {
 	auto &arch = *archPtr;
-	arch.rewind();
+	bool skipEntry = arch.entryOpened;
 	for(auto &entry : arch)
 	{
-		if(entry.type() == FS::file_type::directory)
+		if(std::exchange(skipEntry, false) || entry.type() == FS::file_type::directory)
 		{
 			continue;
 		}
@@ -58,6 +63,29 @@ ZFILE *gn_unzip_fopen(PKZIP *archPtr, const char *filename, uint32_t fileCRC)
 			return new ZFILE{entry.moveIO(), archPtr};
 		}
 	}
+	return nullptr;
+}
+
+ZFILE *gn_unzip_fopen(PKZIP *archPtr, const char *filename, uint32_t fileCRC)
+{
+	if(!archPtr->hasEntry())
+	{
+		return nullptr;
+	}
+	// ROMs are usually requested in archive order, so continue from the last opened
+	// entry before rewinding, which means decompressing solid archives again from the start
+	if(auto z = openEntry(archPtr, filename, fileCRC);
+		z)
+	{
+		return z;
+	}
+	archPtr->rewind();
+	archPtr->entryOpened = false;
+	if(auto z = openEntry(archPtr, filename, fileCRC);
+		z)
+	{
+		return z;
+	}
 	logMsg("file:%s crc32:0x%X not found in archive", filename, fileCRC);
 	return nullptr;
 }
@@ -66,6 +94,7 @@ void gn_unzip_fclose(ZFILE *z)
 {
 	//logMsg("done with archive entry");
 	*z->arch = z->io.releaseArchive();
+	z->arch->entryOpened = true;
 	delete z;
 }
 
@@ -80,8 +109,7 @@ PKZIP *gn_open_zip(void *contextPtr, const char *path)
 	auto &ctx = *((IG::ApplicationContext*)contextPtr);
 	try
 	{
-		auto arch = std::make_unique<FS::ArchiveIterator>(ctx.openFileUri(path));
-		return static_cast<PKZIP*>(arch.release());
+		return std::make_unique<PKZIP>(ctx.openFileUri(path)).release();
 	}
 	catch(...)
 	{
@@ -38,6 +38,23 @@ int EmuFileIO::fgetc()
 	return IG::fgetc(io);
 }
 
+int EmuFileIO::fputc(int c)
+{
+	uint8_t byte = c;
+	if(io.write(&byte, 1) != 1)
+	{
+		failbit = true;
+		return EOF;
+	}
+	return byte;
+}
+
+void EmuFileIO::fwrite(const void *ptr, size_t bytes)
+{
+	if(io.write(ptr, bytes) < (ssize_t)bytes)
+		failbit = true;
+}
+
 size_t EmuFileIO::_fread(const void *ptr, size_t bytes)
 {
 	ssize_t ret = io.read((void*)ptr, bytes);
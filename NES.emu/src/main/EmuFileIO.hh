@@ -48,18 +48,14 @@ public:
 
 	int fgetc();
 
-	int fputc(int c) {
-		return 0;
-	}
+	int fputc(int c);
 
 	size_t _fread(const void *ptr, size_t bytes);
 
 	//removing these return values for now so we can find any code that might be using them and make sure
 	//they handle the return values correctly
 
-	void fwrite(const void *ptr, size_t bytes){
-		failbit = true;
-	}
+	void fwrite(const void *ptr, size_t bytes);
 
 	int fseek(int offset, int origin);
 
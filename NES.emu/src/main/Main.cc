@@ -35,6 +35,7 @@
 #include <fceu/sound.h>
 #include <fceu/palette.h>
 #include <fceu/x6502.h>
+#include <zlib.h>
 
 void ApplyDeemphasisComplete(pal* pal512);
 void FCEU_setDefaultPalettePtr(pal *ptr);
@@ -149,6 +150,31 @@ void EmuSystem::loadState(IG::CStringView path)
 		EmuSystem::throwFileReadError();
 }
 
+size_t EmuSystem::stateSize()
+{
+	EMUFILE_MEMORY stateMem{};
+	FCEUSS_SaveMS(&stateMem, Z_NO_COMPRESSION);
+	return stateMem.size();
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	IG::MapIO buffIO{IG::ByteBuffer{buff}};
+	EmuFileIO stateIO{buffIO};
+	if(!FCEUSS_SaveMS(&stateIO, Z_NO_COMPRESSION) || stateIO.fail())
+		EmuSystem::throwFileWriteError();
+	return stateIO.ftell();
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	IG::MapIO buffIO{IG::ByteBuffer{{const_cast<uint8_t*>(buff.data()), buff.size()}}};
+	EmuFileIO stateIO{buffIO};
+	if(!FCEUSS_LoadFP(&stateIO, SSLOADPARAM_NOBACKUP))
+		EmuSystem::throwFileReadError();
+	newppu_hacky_emergency_reset();
+}
+
 void EmuSystem::saveBackupMem(IG::ApplicationContext ctx)
 {
 	if(gameIsRunning())
@@ -406,12 +432,12 @@ static void renderVideo(EmuSystemTaskContext taskCtx, EmuVideo &video, uint8 *bu
 	assumeExpr(pix.size() == ppuPixRegion.size());
 	if(pix.format() == IG::PIXEL_RGB565)
 	{
-		pix.writeTransformed([](uint8 p){ return nativeCol.col16[p]; }, ppuPixRegion);
+		pix.writeLookup(nativeCol.col16, ppuPixRegion);
 	}
 	else
 	{
 		assumeExpr(pix.format().bytesPerPixel() == 4);
-		pix.writeTransformed([](uint8 p){ return nativeCol.col32[p]; }, ppuPixRegion);
+		pix.writeLookup(nativeCol.col32, ppuPixRegion);
 	}
 	img.endFrame();
 }
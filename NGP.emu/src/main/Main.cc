@@ -91,6 +91,10 @@ void EmuSystem::loadState(IG::CStringView path)
 		throwFileReadError();
 }
 
+size_t EmuSystem::stateSize() { return stateSizeMDFN(); }
+size_t EmuSystem::saveState(std::span<uint8_t> buff) { return saveStateMDFN(buff); }
+void EmuSystem::loadState(std::span<const uint8_t> buff) { loadStateMDFN(buff); }
+
 static FS::PathString saveFilename(IG::ApplicationContext ctx)
 {
 	return EmuSystem::contentSaveFilePath(ctx, ".ngf");
@@ -162,7 +162,7 @@ void EmuSystem::loadGame(IG::ApplicationContext ctx, IO &io, EmuSystemCreatePara
 			throw std::runtime_error("No System Card Set");
 		}
 		CDInterfaces.reserve(1);
-		CDInterfaces.push_back(CDInterface::Open(&NVFS, contentLocation().data(), false, 0));
+		CDInterfaces.push_back(CDInterface::Open(&NVFS, contentFileLocation().data(), false, 0));
 		writeCDMD5();
 		emuSys->LoadCD(&CDInterfaces);
 		PCECD_Drive_SetDisc(false, CDInterfaces[0]);
@@ -260,6 +260,10 @@ void EmuSystem::loadState(IG::CStringView path)
 		throwFileReadError();
 }
 
+size_t EmuSystem::stateSize() { return stateSizeMDFN(); }
+size_t EmuSystem::saveState(std::span<uint8_t> buff) { return saveStateMDFN(buff); }
+void EmuSystem::loadState(std::span<const uint8_t> buff) { loadStateMDFN(buff); }
+
 void EmuApp::onCustomizeNavView(EmuApp::NavView &view)
 {
 	const Gfx::LGradientStopDesc navViewGrad[] =
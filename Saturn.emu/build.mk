@@ -25,7 +25,9 @@ SRC += main/Main.cc \
 main/input.cc \
 main/options.cc \
 main/EmuMenuViews.cc \
-main/EmuControls.cc
+main/EmuControls.cc \
+main/WorkerPool.cc \
+main/WorkerThread.cc
 
 CPPFLAGS += -I$(projectPath)/src \
 -DHAVE_SYS_TIME_H=1 \
@@ -45,6 +47,17 @@ else ifeq ($(ARCH), x86_64)
  # TODO: x86_64 dynarec has 64/32-bit pointer conversion issues
  #CPPFLAGS += -DCPU_X64=1 -DUSE_DYNAREC=1 -DSH2_DYNAREC=1
  #SRC += yabause/sh2_dynarec/linkage_x64.s yabause/sh2_dynarec/sh2_dynarec.c
+ ifeq ($(ENV), linux)
+  # works around the pointer issues on Linux by keeping everything below 2GB, since
+  # generated code & linkage_x64.s address globals with 32-bit absolute addresses
+  CFLAGS_CODEGEN += -fno-pie
+  LDFLAGS += -no-pie
+  CPPFLAGS += -DCPU_X64=1 \
+  -DUSE_DYNAREC=1 \
+  -DSH2_DYNAREC=1
+  SRC += yabause/sh2_dynarec/linkage_x64.s \
+  yabause/sh2_dynarec/sh2_dynarec.c
+ endif
 else ifeq ($(ARCH), x86)
  CPPFLAGS += -DCPU_X86=1 \
  -DUSE_DYNAREC=1 \
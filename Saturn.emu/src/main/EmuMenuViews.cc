@@ -25,6 +25,72 @@ namespace EmuEx
 
 static constexpr unsigned MAX_SH2_CORES = 4;
 
+class CustomVideoOptionView : public VideoOptionView
+{
+	TextMenuItem vdp2ThreadsItem[MAX_VDP2_THREADS]
+	{
+		{"1", &defaultFace(), [](){ setVDP2ThreadsOption(1); }},
+		{"2", &defaultFace(), [](){ setVDP2ThreadsOption(2); }},
+		{"3", &defaultFace(), [](){ setVDP2ThreadsOption(3); }},
+		{"4", &defaultFace(), [](){ setVDP2ThreadsOption(4); }},
+		{"5", &defaultFace(), [](){ setVDP2ThreadsOption(5); }},
+	};
+
+	static void setVDP2ThreadsOption(int threads)
+	{
+		optionVDP2Threads = threads;
+		if(EmuSystem::gameIsRunning())
+		{
+			setVDP2Threads(threads);
+		}
+	}
+
+	MultiChoiceMenuItem vdp2Threads
+	{
+		"VDP2 Render Threads", &defaultFace(),
+		std::clamp((int)optionVDP2Threads, 1, (int)MAX_VDP2_THREADS) - 1,
+		vdp2ThreadsItem
+	};
+
+	BoolMenuItem vdp2Timing
+	{
+		"Log VDP2 Screen Timings", &defaultFace(),
+		(bool)optionVDP2Timing,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionVDP2Timing = item.flipBoolValue(*this);
+			if(EmuSystem::gameIsRunning())
+			{
+				setVDP2Timing(optionVDP2Timing);
+			}
+		}
+	};
+
+	BoolMenuItem vdp1Thread
+	{
+		"Threaded VDP1 Rendering", &defaultFace(),
+		(bool)optionVDP1Thread,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionVDP1Thread = item.flipBoolValue(*this);
+			if(EmuSystem::gameIsRunning())
+			{
+				setVDP1Thread(optionVDP1Thread);
+			}
+		}
+	};
+
+public:
+	CustomVideoOptionView(ViewAttachParams attach): VideoOptionView{attach, true}
+	{
+		loadStockItems();
+		item.emplace_back(&systemSpecificHeading);
+		item.emplace_back(&vdp1Thread);
+		item.emplace_back(&vdp2Threads);
+		item.emplace_back(&vdp2Timing);
+	}
+};
+
 class CustomSystemOptionView : public SystemOptionView
 {
 	TextMenuItem biosPath
@@ -92,6 +158,7 @@ std::unique_ptr<View> EmuApp::makeCustomView(ViewAttachParams attach, ViewID id)
 {
 	switch(id)
 	{
+		case ViewID::VIDEO_OPTIONS: return std::make_unique<CustomVideoOptionView>(attach);
 		case ViewID::SYSTEM_OPTIONS: return std::make_unique<CustomSystemOptionView>(attach);
 		default: return nullptr;
 	}
@@ -19,9 +19,14 @@
 #include <emuframework/EmuAudio.hh>
 #include <emuframework/EmuVideo.hh>
 #include "internal.hh"
+#include "WorkerPool.hh"
+#include "WorkerThread.hh"
 #include <imagine/fs/FS.hh>
 #include <imagine/util/format.hh>
 #include <imagine/util/string.h>
+#include <imagine/io/MapIO.hh>
+#include <imagine/io/FileStream.hh>
+#include <emuframework/StateWriteIO.hh>
 
 extern "C"
 {
@@ -40,7 +45,7 @@ extern "C"
 // from sh2_dynarec.c
 #define SH2CORE_DYNAREC 2
 extern const int defaultSH2CoreID =
-#ifdef SH2_DYNAREC
+#if defined SH2_DYNAREC && !defined CPU_X64 // x86_64 dynarec is opt-in
 SH2CORE_DYNAREC;
 #else
 SH2CORE_INTERPRETER;
@@ -271,6 +276,38 @@ void EmuSystem::loadState(IG::CStringView path)
 		throwFileReadError();
 }
 
+static int saveStateToBuffer(std::span<uint8_t> buff)
+{
+	IG::FileStream<StateWriteIO> stream{StateWriteIO{buff}, "wb"};
+	auto size = YabSaveStateStream(stream.filePtr());
+	if(fflush(stream.filePtr()) != 0 || ferror(stream.filePtr()))
+		return -1;
+	return size;
+}
+
+size_t EmuSystem::stateSize()
+{
+	auto size = saveStateToBuffer({});
+	if(size < 0)
+		throwFileWriteError();
+	return size;
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	auto size = saveStateToBuffer(buff);
+	if(size < 0)
+		throwFileWriteError();
+	return size;
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	IG::FileStream<IG::MapIO> stream{IG::MapIO{IG::ByteBuffer{{const_cast<uint8_t*>(buff.data()), buff.size()}}}, "rb"};
+	if(YabLoadStateStream(stream.filePtr()) != 0)
+		throwFileReadError();
+}
+
 void EmuSystem::saveBackupMem(IG::ApplicationContext)
 {
 	if(gameIsRunning())
@@ -281,6 +318,63 @@ void EmuSystem::saveBackupMem(IG::ApplicationContext)
 }
 
 static bool yabauseIsInit = 0;
+static std::unique_ptr<WorkerPool> vdp2Workers;
+
+void setVDP2Threads(int threads)
+{
+	if(threads <= 1)
+	{
+		VIDSoftVdp2RunTasks = nullptr;
+		vdp2Workers.reset();
+		return;
+	}
+	if(vdp2Workers && vdp2Workers->threads() == threads)
+		return;
+	VIDSoftVdp2RunTasks = nullptr;
+	vdp2Workers = std::make_unique<WorkerPool>(threads);
+	VIDSoftVdp2RunTasks = [](void (*func)(int), int tasks){ vdp2Workers->run(func, tasks); };
+}
+
+static std::unique_ptr<WorkerThread> vdp1Worker;
+
+void setVDP1Thread(bool on)
+{
+	if(on == bool(vdp1Worker))
+		return;
+	VIDSoftVdp1Sync();
+	VIDSoftVdp1StartThread = nullptr;
+	VIDSoftVdp1WaitThread = nullptr;
+	if(!on)
+	{
+		vdp1Worker.reset();
+		return;
+	}
+	vdp1Worker = std::make_unique<WorkerThread>();
+	VIDSoftVdp1StartThread = [](void (*func)()){ vdp1Worker->start(func); };
+	VIDSoftVdp1WaitThread = [](){ vdp1Worker->wait(); };
+}
+
+void setVDP2Timing(bool on)
+{
+	VIDSoftVdp2EnableTiming(on);
+}
+
+static void logVDP2Timing()
+{
+	static unsigned frames{};
+	if(++frames < 60)
+		return;
+	frames = 0;
+	VIDSoftVdp2Timing timing;
+	VIDSoftVdp2TakeTiming(&timing);
+	if(!timing.frames)
+		return;
+	auto avgUSecs = [&](u64 ticks){ return unsigned(ticks * 1000000 / yabsys.tickfreq / timing.frames); };
+	logMsg("VDP2 avg usecs over %u frames: NBG0:%u NBG1:%u NBG2:%u NBG3:%u RBG0:%u total:%u",
+		(unsigned)timing.frames, avgUSecs(timing.screenticks[0]), avgUSecs(timing.screenticks[1]),
+		avgUSecs(timing.screenticks[2]), avgUSecs(timing.screenticks[3]), avgUSecs(timing.screenticks[4]),
+		avgUSecs(timing.totalticks));
+}
 
 void EmuSystem::closeSystem(IG::ApplicationContext)
 {
@@ -289,6 +383,8 @@ void EmuSystem::closeSystem(IG::ApplicationContext)
 		YabauseDeInit();
 		yabauseIsInit = 0;
 	}
+	setVDP2Threads(1);
+	setVDP1Thread(false);
 }
 
 void EmuSystem::loadGame(IG::ApplicationContext ctx, IO &, EmuSystemCreateParams, OnLoadProgressDelegate)
@@ -306,6 +402,9 @@ void EmuSystem::loadGame(IG::ApplicationContext ctx, IO &, EmuSystemCreateParams
 	pad[0] = PerPadAdd(&PORTDATA1);
 	pad[1] = PerPadAdd(&PORTDATA2);
 	ScspSetFrameAccurate(1);
+	setVDP2Threads(optionVDP2Threads);
+	setVDP2Timing(optionVDP2Timing);
+	setVDP1Thread(optionVDP1Thread);
 }
 
 void EmuSystem::configAudioRate(IG::FloatSeconds frameTime, uint32_t rate)
@@ -321,6 +420,8 @@ void EmuSystem::runFrame(EmuSystemTaskContext taskCtx, EmuVideo *video, EmuAudio
 	SNDImagine.UpdateAudio = audio ? SNDImagineUpdateAudio : SNDImagineUpdateAudioNull;
 	YabauseEmulate();
 	emuAudio = {};
+	if(optionVDP2Timing) [[unlikely]]
+		logVDP2Timing();
 }
 
 void EmuApp::onCustomizeNavView(EmuApp::NavView &view)
@@ -0,0 +1,91 @@
+/*  This file is part of Saturn.emu.
+
+	Saturn.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Saturn.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Saturn.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "WorkerPool"
+#include <emuframework/EmuApp.hh>
+#include "WorkerPool.hh"
+#include <imagine/thread/Thread.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <span>
+
+namespace EmuEx
+{
+
+WorkerPool::WorkerPool(int threads):
+	worker{std::make_unique<Worker[]>(std::max(threads - 1, 0))},
+	workers{std::max(threads - 1, 0)}
+{
+	for(auto &w : std::span{worker.get(), size_t(workers)})
+	{
+		w.thread = IG::makeThreadSync(EmuApp::emuThreadAttributes(),
+			[this, &w](std::binary_semaphore &sem)
+			{
+				sem.release();
+				while(true)
+				{
+					w.start.acquire();
+					if(exiting)
+						return;
+					runTasks();
+					if(busyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+						finished.release();
+				}
+			});
+	}
+	logMsg("started %d worker threads", workers);
+}
+
+WorkerPool::~WorkerPool()
+{
+	exiting = true;
+	for(auto &w : std::span{worker.get(), size_t(workers)})
+	{
+		w.start.release();
+		w.thread.join();
+	}
+}
+
+void WorkerPool::run(TaskFunc func_, int tasks_)
+{
+	func = func_;
+	tasks = tasks_;
+	nextTask.store(0, std::memory_order_relaxed);
+	// no point waking more workers than there are tasks for besides the caller
+	int wakeWorkers = std::min(workers, tasks_ - 1);
+	if(wakeWorkers <= 0)
+	{
+		runTasks();
+		return;
+	}
+	busyWorkers.store(wakeWorkers, std::memory_order_relaxed);
+	for(auto &w : std::span{worker.get(), size_t(wakeWorkers)})
+	{
+		w.start.release();
+	}
+	runTasks();
+	finished.acquire();
+}
+
+void WorkerPool::runTasks()
+{
+	for(int task = nextTask.fetch_add(1, std::memory_order_relaxed); task < tasks;
+		task = nextTask.fetch_add(1, std::memory_order_relaxed))
+	{
+		func(task);
+	}
+}
+
+}
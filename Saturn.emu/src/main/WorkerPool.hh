@@ -0,0 +1,57 @@
+#pragma once
+
+/*  This file is part of Saturn.emu.
+
+	Saturn.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Saturn.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Saturn.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/thread/Semaphore.hh>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace EmuEx
+{
+
+// Runs a batch of independent tasks on a fixed set of threads, the calling thread included
+class WorkerPool
+{
+public:
+	using TaskFunc = void (*)(int task);
+
+	WorkerPool(int threads);
+	~WorkerPool();
+	// calls func for each task from 0 to tasks - 1, returning once all finish
+	void run(TaskFunc func, int tasks);
+	int threads() const { return workers + 1; }
+
+private:
+	struct Worker
+	{
+		std::thread thread;
+		std::binary_semaphore start{0};
+	};
+
+	std::unique_ptr<Worker[]> worker;
+	int workers{};
+	TaskFunc func{};
+	int tasks{};
+	std::atomic_int nextTask{};
+	std::atomic_int busyWorkers{};
+	std::binary_semaphore finished{0};
+	bool exiting{};
+
+	void runTasks();
+};
+
+}
@@ -0,0 +1,71 @@
+/*  This file is part of Saturn.emu.
+
+	Saturn.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Saturn.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Saturn.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "WorkerThread"
+#include <emuframework/EmuApp.hh>
+#include "WorkerThread.hh"
+#include <imagine/thread/Thread.hh>
+#include <imagine/logger/logger.h>
+#include <cassert>
+
+namespace EmuEx
+{
+
+WorkerThread::WorkerThread():
+	thread
+	{
+		IG::makeThreadSync(EmuApp::emuThreadAttributes(),
+			[this](std::binary_semaphore &sem)
+			{
+				sem.release();
+				while(true)
+				{
+					startSem.acquire();
+					if(exiting)
+						return;
+					func();
+					finishedSem.release();
+				}
+			})
+	}
+{
+	logMsg("started worker thread");
+}
+
+WorkerThread::~WorkerThread()
+{
+	wait();
+	exiting = true;
+	startSem.release();
+	thread.join();
+}
+
+void WorkerThread::start(Func func_)
+{
+	assert(!running);
+	func = func_;
+	running = true;
+	startSem.release();
+}
+
+void WorkerThread::wait()
+{
+	if(!running)
+		return;
+	finishedSem.acquire();
+	running = false;
+}
+
+}
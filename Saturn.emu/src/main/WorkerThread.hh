@@ -0,0 +1,46 @@
+#pragma once
+
+/*  This file is part of Saturn.emu.
+
+	Saturn.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Saturn.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Saturn.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/thread/Semaphore.hh>
+#include <thread>
+
+namespace EmuEx
+{
+
+// Runs one function at a time on its own thread while the caller continues
+class WorkerThread
+{
+public:
+	using Func = void (*)();
+
+	WorkerThread();
+	~WorkerThread();
+	// the previously started function must have been waited on
+	void start(Func);
+	// returns once the last started function finishes
+	void wait();
+
+private:
+	std::binary_semaphore startSem{0};
+	std::binary_semaphore finishedSem{0};
+	Func func{};
+	bool running{};
+	bool exiting{};
+	std::thread thread; // started last, after the members it uses
+};
+
+}
@@ -20,12 +20,20 @@ extern SH2Interface_struct *SH2CoreList[];
 namespace EmuEx
 {
 
+static constexpr uint8_t MAX_VDP2_THREADS = 5; // one per VDP2 screen
+
 extern Byte1Option optionSH2Core;
+extern Byte1Option optionVDP2Threads;
+extern Byte1Option optionVDP2Timing;
+extern Byte1Option optionVDP1Thread;
 extern FS::PathString biosPath;
 extern unsigned SH2Cores;
 extern yabauseinit_struct yinit;
 extern PerPad_struct *pad[2];
 
 bool hasBIOSExtension(std::string_view name);
+void setVDP2Threads(int threads);
+void setVDP2Timing(bool on);
+void setVDP1Thread(bool on);
 
 }
@@ -36,7 +36,9 @@ namespace EmuEx
 
 enum
 {
-	CFGKEY_BIOS_PATH = 279, CFGKEY_SH2_CORE = 280
+	CFGKEY_BIOS_PATH = 279, CFGKEY_SH2_CORE = 280,
+	CFGKEY_VDP2_THREADS = 281, CFGKEY_VDP2_TIMING = 282,
+	CFGKEY_VDP1_THREAD = 283
 };
 
 static bool OptionSH2CoreIsValid(uint8_t val)
@@ -55,6 +57,9 @@ static bool OptionSH2CoreIsValid(uint8_t val)
 
 const char *EmuSystem::configFilename = "SaturnEmu.config";
 Byte1Option optionSH2Core{CFGKEY_SH2_CORE, (uint8_t)defaultSH2CoreID, false, OptionSH2CoreIsValid};
+Byte1Option optionVDP2Threads{CFGKEY_VDP2_THREADS, 1, false, optionIsValidWithMinMax<1, MAX_VDP2_THREADS>};
+Byte1Option optionVDP2Timing{CFGKEY_VDP2_TIMING, 0};
+Byte1Option optionVDP1Thread{CFGKEY_VDP1_THREAD, 0};
 const AspectRatioInfo EmuSystem::aspectRatioInfo[] =
 {
 		{"4:3 (Original)", 4, 3},
@@ -87,6 +92,9 @@ bool EmuSystem::readConfig(IO &io, unsigned key, unsigned readSize)
 		bcase CFGKEY_BIOS_PATH:
 			readStringOptionValue<FS::PathString>(io, readSize, [](auto &path){biosPath = path;});
 		bcase CFGKEY_SH2_CORE: optionSH2Core.readFromIO(io, readSize);
+		bcase CFGKEY_VDP2_THREADS: optionVDP2Threads.readFromIO(io, readSize);
+		bcase CFGKEY_VDP2_TIMING: optionVDP2Timing.readFromIO(io, readSize);
+		bcase CFGKEY_VDP1_THREAD: optionVDP1Thread.readFromIO(io, readSize);
 	}
 	return 1;
 }
@@ -95,6 +103,9 @@ void EmuSystem::writeConfig(IO &io)
 {
 	writeStringOptionValue(io, CFGKEY_BIOS_PATH, biosPath);
 	optionSH2Core.writeWithKeyIfNotDefault(io);
+	optionVDP2Threads.writeWithKeyIfNotDefault(io);
+	optionVDP2Timing.writeWithKeyIfNotDefault(io);
+	optionVDP1Thread.writeWithKeyIfNotDefault(io);
 }
 
 }
@@ -404,6 +404,8 @@ void FormatBackupRam(void *mem, u32 size);
 
 int YabSaveState(const char *filename);
 int YabLoadState(const char *filename);
+int YabSaveStateStream(FILE *fp); // returns the state size in bytes or a negative value on error
+int YabLoadStateStream(FILE *fp);
 int YabSaveStateSlot(const char *dirpath, u8 slot);
 int YabLoadStateSlot(const char *dirpath, u8 slot);
 
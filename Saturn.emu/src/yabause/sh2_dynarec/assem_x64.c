@@ -2976,8 +2976,7 @@ void save_regs(u32 reglist)
       }
     }
   }
-  if(slave) emit_addimm64(ESP,-(6-count)*8,ESP); // slave has master's return address on stack
-  else emit_addimm64(ESP,-(7-count)*8,ESP);
+  emit_addimm64(ESP,-(6-count)*8,ESP); // master & slave both have master's return address on stack
 }
 // Restore registers after function call
 void restore_regs(u32 reglist)
@@ -2985,8 +2984,7 @@ void restore_regs(u32 reglist)
   reglist&=0xC7; // only save the caller-save registers, %eax, %ecx, %edx, %esi, %edi
   int hr;
   int count=count_bits(reglist);
-  if(slave) emit_addimm64(ESP,(6-count)*8,ESP);
-  else emit_addimm64(ESP,(7-count)*8,ESP);
+  emit_addimm64(ESP,(6-count)*8,ESP);
   if(count) {
     for(hr=HOST_REGS-1;hr>=0;hr--) {
       if(hr!=EXCLUDE_REG) {
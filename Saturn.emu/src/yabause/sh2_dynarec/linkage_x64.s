@@ -59,7 +59,7 @@ YabauseDynarecOneFrameExec:
    m68kcenticycles (68/60)
    m68kcycles (72/64)
    space for alignment (80/72)
-   ret address/master_ip (88/80) (alternate rsp at call)
+   master_ip (88/80) (rsp in master & slave code)
    save %rax (96/88)
    save %rcx (104/96)
    save %rdx (112/104)
@@ -105,7 +105,7 @@ newline:
 	jne	master_handle_interrupts
 	mov	master_cc, %esi
 	sub	%ebx, %esi
-	ret	/* jmp master_ip */
+	jmp	*(%rsp) /* jmp master_ip */
 	.size	YabauseDynarecOneFrameExec, .-YabauseDynarecOneFrameExec
 
 .globl master_handle_interrupts
@@ -118,12 +118,14 @@ master_handle_interrupts:
 	mov	master_cc, %esi
 	mov	%rax,-80(%rbp) /* overwrite return address */
 	sub	%ebx, %esi
-	ret	/* jmp master_ip */
+	jmp	*%rax /* jmp master_ip */
 	.size	master_handle_interrupts, .-master_handle_interrupts
 
 .globl slave_entry
 	.type	slave_entry, @function
 slave_entry:
+	pop	%rax /* master's return address, keep the stack aligned for slave code */
+	mov	%rax, (%rsp)
 	mov	28(%rsp), %ebx /* sh2cycles */
 	mov	%esi, master_cc
 	mov	%ebx, %edi
@@ -184,7 +186,7 @@ cc_interrupt_master:
 	cmpl	$0, (%rax, %rcx)
 	jne	master_handle_interrupts
 	sub	%ebx, %esi
-	ret	/* jmp master_ip */	
+	jmp	*(%rsp) /* jmp master_ip */
 .A2:
 	call	Vdp2HBlankIN
 	jmp	.A1
@@ -645,13 +647,15 @@ macl:
 	mov	%eax, %r13d /* MACL */
 	mov	%ebp, %r14d
 	mov	%edi, %r15d
+	add	$-8, %rsp /* Align stack */
 	call	MappedMemoryReadLong
-	mov	%eax, %esi
+	mov	%eax, (%rsp) /* %esi isn't preserved across calls */
 	mov	%r14d, %edi
 	call	MappedMemoryReadLong
 	lea	4(%r14), %ebp
 	lea	4(%r15), %edi
-	imul	%esi
+	imull	(%rsp)
+	add	$8, %rsp /* Align stack */
 	add	%r13d, %eax /* MACL */
 	adc	%r12d, %edx /* MACH */
 	test	$0x2, %bl
@@ -683,14 +687,17 @@ macw:
 	mov	%eax, %r13d /* MACL */
 	mov	%ebp, %r14d
 	mov	%edi, %r15d
+	add	$-8, %rsp /* Align stack */
 	call	MappedMemoryReadWord
-	movswl	%ax, %esi
+	movswl	%ax, %eax
+	mov	%eax, (%rsp) /* %esi isn't preserved across calls */
 	mov	%r14d, %edi
 	call	MappedMemoryReadWord
 	movswl	%ax, %eax
 	lea	2(%r14), %ebp
 	lea	2(%r15), %edi
-	imul	%esi
+	imull	(%rsp)
+	add	$8, %rsp /* Align stack */
 	test	$0x2, %bl
 	jne	macw_saturation
 	add	%r13d, %eax /* MACL */
@@ -715,7 +722,7 @@ macw_saturation:
 .globl master_handle_bios
 	.type	master_handle_bios, @function
 master_handle_bios:
-	mov	(%rsp), %rdx /* get return address */
+	pop	%rdx /* get return address */
 	mov	%eax, master_pc
 	mov	%esi, master_cc
 	mov	%rdx, master_ip
@@ -723,8 +730,7 @@ master_handle_bios:
 	call	BiosHandleFunc
 	mov	master_ip, %rdx
 	mov	master_cc, %esi
-	mov	%rdx, (%rsp)
-	ret	/* jmp *master_ip */
+	jmp	*%rdx /* jmp *master_ip */
 	.size	master_handle_bios, .-master_handle_bios
 
 .globl slave_handle_bios
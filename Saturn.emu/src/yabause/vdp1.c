@@ -501,21 +501,27 @@ void Vdp1NoDraw(void) {
 //////////////////////////////////////////////////////////////////////////////
 
 void FASTCALL Vdp1ReadCommand(vdp1cmd_struct *cmd, u32 addr) {
-   cmd->CMDCTRL = T1ReadWord(Vdp1Ram, addr);
-   cmd->CMDLINK = T1ReadWord(Vdp1Ram, addr + 0x2);
-   cmd->CMDPMOD = T1ReadWord(Vdp1Ram, addr + 0x4);
-   cmd->CMDCOLR = T1ReadWord(Vdp1Ram, addr + 0x6);
-   cmd->CMDSRCA = T1ReadWord(Vdp1Ram, addr + 0x8);
-   cmd->CMDSIZE = T1ReadWord(Vdp1Ram, addr + 0xA);
-   cmd->CMDXA = T1ReadWord(Vdp1Ram, addr + 0xC);
-   cmd->CMDYA = T1ReadWord(Vdp1Ram, addr + 0xE);
-   cmd->CMDXB = T1ReadWord(Vdp1Ram, addr + 0x10);
-   cmd->CMDYB = T1ReadWord(Vdp1Ram, addr + 0x12);
-   cmd->CMDXC = T1ReadWord(Vdp1Ram, addr + 0x14);
-   cmd->CMDYC = T1ReadWord(Vdp1Ram, addr + 0x16);
-   cmd->CMDXD = T1ReadWord(Vdp1Ram, addr + 0x18);
-   cmd->CMDYD = T1ReadWord(Vdp1Ram, addr + 0x1A);
-   cmd->CMDGRDA = T1ReadWord(Vdp1Ram, addr + 0x1C);
+   Vdp1ReadCommandRam(cmd, Vdp1Ram, addr);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FASTCALL Vdp1ReadCommandRam(vdp1cmd_struct *cmd, u8 *ram, u32 addr) {
+   cmd->CMDCTRL = T1ReadWord(ram, addr);
+   cmd->CMDLINK = T1ReadWord(ram, addr + 0x2);
+   cmd->CMDPMOD = T1ReadWord(ram, addr + 0x4);
+   cmd->CMDCOLR = T1ReadWord(ram, addr + 0x6);
+   cmd->CMDSRCA = T1ReadWord(ram, addr + 0x8);
+   cmd->CMDSIZE = T1ReadWord(ram, addr + 0xA);
+   cmd->CMDXA = T1ReadWord(ram, addr + 0xC);
+   cmd->CMDYA = T1ReadWord(ram, addr + 0xE);
+   cmd->CMDXB = T1ReadWord(ram, addr + 0x10);
+   cmd->CMDYB = T1ReadWord(ram, addr + 0x12);
+   cmd->CMDXC = T1ReadWord(ram, addr + 0x14);
+   cmd->CMDYC = T1ReadWord(ram, addr + 0x16);
+   cmd->CMDXD = T1ReadWord(ram, addr + 0x18);
+   cmd->CMDYD = T1ReadWord(ram, addr + 0x1A);
+   cmd->CMDGRDA = T1ReadWord(ram, addr + 0x1C);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -150,6 +150,7 @@ void FASTCALL	Vdp1WriteLong(u32, u32);
 void Vdp1Draw(void);
 void Vdp1NoDraw(void);
 void FASTCALL Vdp1ReadCommand(vdp1cmd_struct *cmd, u32 addr);
+void FASTCALL Vdp1ReadCommandRam(vdp1cmd_struct *cmd, u8 *ram, u32 addr);
 
 int Vdp1SaveState(FILE *fp);
 int Vdp1LoadState(FILE *fp, int version, int size);
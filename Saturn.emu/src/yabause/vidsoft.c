@@ -38,6 +38,7 @@
 
 #include <stdlib.h>
 #include <limits.h>
+#include <string.h>
 
 #if defined(__APPLE__)
 // malloc pointers always 16-byte aligned
@@ -163,6 +164,36 @@ static int outputheight;
 static int resxratio;
 static int resyratio;
 
+void (*VIDSoftVdp2RunTasks)(void (*func)(int task), int tasks) = NULL;
+static int vdp2taskscreens[VIDSOFT_VDP2_SCREENS][VIDSOFT_VDP2_SCREENS];
+static int vdp2tasksize[VIDSOFT_VDP2_SCREENS];
+static int vdp2timingenabled = 0;
+static VIDSoftVdp2Timing vdp2timing;
+
+// the VDP1 state read while drawing, either the live one or a copy being drawn asynchronously
+static u8 *vdp1ram;
+static Vdp1 *vdp1regs;
+static u16 vdp1spctl;
+
+#define VDP1_MAX_ASYNC_COMMANDS 2000 // Vdp1Draw()'s limit
+
+typedef struct
+{
+   void (*func)(void);
+   u32 addr;
+} vdp1asynccmd_struct;
+
+void (*VIDSoftVdp1StartThread)(void (*func)(void)) = NULL;
+void (*VIDSoftVdp1WaitThread)(void) = NULL;
+static vdp1asynccmd_struct vdp1asynccmds[VDP1_MAX_ASYNC_COMMANDS];
+static int vdp1asynccmdcount;
+static u8 *vdp1asyncram = NULL;
+static Vdp1 vdp1asyncregs;
+static u16 vdp1asyncspctl;
+static int vdp1asyncerase;
+static int vdp1recording = 0;
+static int vdp1drawing = 0;
+
 typedef struct { s16 x; s16 y; } vdp1vertex;
 
 typedef struct
@@ -642,6 +673,23 @@ static u8 FASTCALL GetAlpha(vdp2draw_struct * info, u32 color)
 
 //////////////////////////////////////////////////////////////////////////////
 
+// filled by VIDSoftInit() since screens may be drawn from several threads
+static int mosaic_table[16][1024];
+
+static void InitMosaicTable(void)
+{
+   int i, j;
+
+   for (i = 0; i < 16; i++)
+   {
+      int m = i + 1;
+      for (j = 0; j < 1024; j++)
+         mosaic_table[i][j] = j / m * m;
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info)
 {
    int i, j;
@@ -667,22 +715,8 @@ static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info)
    ReadLineWindowData(&info->islinewindow, info->wctl, &linewnd0addr, &linewnd1addr);
    /* color calculation window: in => no color calc, out => color calc */
    ReadWindowData(Vdp2Regs->WCTLD >> 8, colorcalcwindow);
-   {
-	   static int tables_initialized = 0;
-	   static int mosaic_table[16][1024];
-	   if(!tables_initialized)
-	   {
-		   tables_initialized = 1;
-			for(i=0;i<16;i++)
-			{
-				int m = i+1;
-				for(j=0;j<1024;j++)
-					mosaic_table[i][j] = j/m*m;
-			}
-	   }
-	   mosaic_x = mosaic_table[info->mosaicxmask-1];
-	   mosaic_y = mosaic_table[info->mosaicymask-1];
-   }
+   mosaic_x = mosaic_table[info->mosaicxmask-1];
+   mosaic_y = mosaic_table[info->mosaicymask-1];
 
    for (j = 0; j < vdp2height; j++)
    {
@@ -1697,6 +1731,8 @@ int VIDSoftInit(void)
    if (TitanInit() == -1)
       return -1;
 
+   InitMosaicTable();
+
    if ((dispbuffer = (pixel_t *)memalign(8, sizeof(pixel_t) * 704 * 512)) == NULL)
       return -1;
 
@@ -1734,6 +1770,13 @@ int VIDSoftInit(void)
 
 void VIDSoftDeInit(void)
 {
+   VIDSoftVdp1Sync();
+   if (vdp1asyncram)
+   {
+      free(vdp1asyncram);
+      vdp1asyncram = NULL;
+   }
+
    if (dispbuffer)
    {
       free(dispbuffer);
@@ -1782,6 +1825,7 @@ int VIDSoftIsFullscreen(void) {
 
 int VIDSoftVdp1Reset(void)
 {
+   VIDSoftVdp1Sync();
    vdp1clipxstart = 0;
    vdp1clipxend = 512;
    vdp1clipystart = 0;
@@ -1792,15 +1836,15 @@ int VIDSoftVdp1Reset(void)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void VIDSoftVdp1DrawStart(void)
+static void Vdp1SetupDraw(int erase)
 {
-   if (Vdp1Regs->FBCR & 8)
+   if (vdp1regs->FBCR & 8)
       vdp1interlace = 2;
    else
       vdp1interlace = 1;
-   if (Vdp1Regs->TVMR & 0x1)
+   if (vdp1regs->TVMR & 0x1)
    {
-      if (Vdp1Regs->TVMR & 0x2)
+      if (vdp1regs->TVMR & 0x2)
       {
          // Rotation 8-bit
          vdp1width = 512;
@@ -1823,25 +1867,135 @@ void VIDSoftVdp1DrawStart(void)
       vdp1pixelsize = 2;
    }
 
-   VIDSoftVdp1EraseFrameBuffer();
+   if (erase)
+      VIDSoftVdp1EraseFrameBuffer();
 
-   vdp1clipxstart = Vdp1Regs->userclipX1 = Vdp1Regs->systemclipX1 = 0;
-   vdp1clipystart = Vdp1Regs->userclipY1 = Vdp1Regs->systemclipY1 = 0;
-   vdp1clipxend = Vdp1Regs->userclipX2 = Vdp1Regs->systemclipX2 = vdp1width;
-   vdp1clipyend = Vdp1Regs->userclipY2 = Vdp1Regs->systemclipY2 = vdp1height;
+   vdp1clipxstart = vdp1regs->userclipX1 = vdp1regs->systemclipX1 = 0;
+   vdp1clipystart = vdp1regs->userclipY1 = vdp1regs->systemclipY1 = 0;
+   vdp1clipxend = vdp1regs->userclipX2 = vdp1regs->systemclipX2 = vdp1width;
+   vdp1clipyend = vdp1regs->userclipY2 = vdp1regs->systemclipY2 = vdp1height;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static int Vdp1StartRecording(int erase)
+{
+   if (vdp1asyncram == NULL && (vdp1asyncram = (u8 *)malloc(0x80000)) == NULL)
+      return 0;
+
+   memcpy(vdp1asyncram, Vdp1Ram, 0x80000);
+   vdp1asyncregs = *Vdp1Regs;
+   vdp1asyncspctl = vdp1spctl;
+   vdp1asyncerase = erase;
+   vdp1asynccmdcount = 0;
+   vdp1recording = 1;
+   return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void Vdp1DrawRecorded(void)
+{
+   int i;
+
+   vdp1ram = vdp1asyncram;
+   vdp1regs = &vdp1asyncregs;
+   vdp1spctl = vdp1asyncspctl;
+   Vdp1SetupDraw(vdp1asyncerase);
+
+   for (i = 0; i < vdp1asynccmdcount; i++)
+   {
+      vdp1regs->addr = vdp1asynccmds[i].addr;
+      vdp1asynccmds[i].func();
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void Vdp1StartAsyncDraw(void)
+{
+   vdp1recording = 0;
+   vdp1drawing = 1;
+   VIDSoftVdp1StartThread(Vdp1DrawRecorded);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1Sync(void)
+{
+   // a draw aborted without Vdp1DrawEnd() may still be recording
+   if (vdp1recording)
+      Vdp1StartAsyncDraw();
+
+   if (vdp1drawing)
+   {
+      VIDSoftVdp1WaitThread();
+      vdp1drawing = 0;
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void Vdp1RunCommand(void (*func)(void), int draws)
+{
+   if (vdp1recording)
+   {
+      if (vdp1asynccmdcount < VDP1_MAX_ASYNC_COMMANDS)
+      {
+         vdp1asynccmds[vdp1asynccmdcount].func = func;
+         vdp1asynccmds[vdp1asynccmdcount].addr = Vdp1Regs->addr;
+         vdp1asynccmdcount++;
+      }
+
+      // clipping & local coordinates still update the registers right away
+      if (draws)
+         return;
+   }
+   else
+      VIDSoftVdp1Sync();
+
+   vdp1ram = Vdp1Ram;
+   vdp1regs = Vdp1Regs;
+   func();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1DrawStart(void)
+{
+   int erase;
+
+   VIDSoftVdp1Sync();
+
+   erase = ((Vdp1Regs->FBCR & 2) == 0) || Vdp1External.manualerase;
+   Vdp1External.manualerase = 0;
+   vdp1ram = Vdp1Ram;
+   vdp1regs = Vdp1Regs;
+   vdp1spctl = Vdp2Regs->SPCTL;
+
+   if (VIDSoftVdp1StartThread && Vdp1StartRecording(erase))
+   {
+      // the framebuffer is erased on the drawing thread
+      Vdp1SetupDraw(0);
+      return;
+   }
+
+   Vdp1SetupDraw(erase);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void VIDSoftVdp1DrawEnd(void)
 {
+   if (vdp1recording)
+      Vdp1StartAsyncDraw();
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 static INLINE u16  Vdp1ReadPattern16( u32 base, u32 offset ) {
 
-  u16 dot = T1ReadByte(Vdp1Ram, ( base + (offset>>1)) & 0x7FFFF);
+  u16 dot = T1ReadByte(vdp1ram, ( base + (offset>>1)) & 0x7FFFF);
   if ((offset & 0x1) == 0) dot >>= 4; // Even pixel
   else dot &= 0xF; // Odd pixel
   return dot;
@@ -1849,22 +2003,22 @@ static INLINE u16  Vdp1ReadPattern16( u32 base, u32 offset ) {
 
 static INLINE u16  Vdp1ReadPattern64( u32 base, u32 offset ) {
 
-  return T1ReadByte(Vdp1Ram, ( base + offset ) & 0x7FFFF) & 0x3F;
+  return T1ReadByte(vdp1ram, ( base + offset ) & 0x7FFFF) & 0x3F;
 }
 
 static INLINE u16  Vdp1ReadPattern128( u32 base, u32 offset ) {
 
-  return T1ReadByte(Vdp1Ram, ( base + offset ) & 0x7FFFF) & 0x7F;
+  return T1ReadByte(vdp1ram, ( base + offset ) & 0x7FFFF) & 0x7F;
 }
 
 static INLINE u16  Vdp1ReadPattern256( u32 base, u32 offset ) {
 
-  return T1ReadByte(Vdp1Ram, ( base + offset ) & 0x7FFFF) & 0xFF;
+  return T1ReadByte(vdp1ram, ( base + offset ) & 0x7FFFF) & 0xFF;
 }
 
 static INLINE u16  Vdp1ReadPattern64k( u32 base, u32 offset ) {
 
-  return T1ReadWord(Vdp1Ram, ( base + 2*offset) & 0x7FFFF);
+  return T1ReadWord(vdp1ram, ( base + 2*offset) & 0x7FFFF);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1958,7 +2112,7 @@ static int getpixel(int linenumber, int currentlineindex) {
 			if(isTextured && endcodesEnabled && currentPixel == endcode)
 				return 1;
 			if (!(currentPixel == 0 && !SPD))
-				currentPixel = T1ReadWord(Vdp1Ram, (currentPixel * 2 + colorlut) & 0x7FFFF);
+				currentPixel = T1ReadWord(vdp1ram, (currentPixel * 2 + colorlut) & 0x7FFFF);
 			currentPixelIsVisible = 0xffff;
 			break;
 		case 0x2://8pp bank (64 color)
@@ -2106,7 +2260,7 @@ static void putpixel(int x, int y) {
 		if (clipped) return;
 	}
 
-	if ((cmd.CMDPMOD & (1 << 15)) && ((Vdp2Regs->SPCTL & 0x10) == 0))
+	if ((cmd.CMDPMOD & (1 << 15)) && ((vdp1spctl & 0x10) == 0))
 	{
 		if (currentPixel) {
 			*iPix |= 0x8000;
@@ -2345,14 +2499,14 @@ static void gouraudTable(void)
 {
 	int gouraudTableAddress;
 
-	Vdp1ReadCommand(&cmd, Vdp1Regs->addr);
+	Vdp1ReadCommandRam(&cmd, vdp1ram, vdp1regs->addr);
 
 	gouraudTableAddress = (((unsigned int)cmd.CMDGRDA) << 3);
 
-	gouraudA.value = T1ReadWord(Vdp1Ram,gouraudTableAddress);
-	gouraudB.value = T1ReadWord(Vdp1Ram,gouraudTableAddress+2);
-	gouraudC.value = T1ReadWord(Vdp1Ram,gouraudTableAddress+4);
-	gouraudD.value = T1ReadWord(Vdp1Ram,gouraudTableAddress+6);
+	gouraudA.value = T1ReadWord(vdp1ram,gouraudTableAddress);
+	gouraudB.value = T1ReadWord(vdp1ram,gouraudTableAddress+2);
+	gouraudC.value = T1ReadWord(vdp1ram,gouraudTableAddress+4);
+	gouraudD.value = T1ReadWord(vdp1ram,gouraudTableAddress+6);
 }
 
 int xleft[1000];
@@ -2391,7 +2545,7 @@ static void drawQuad(s16 tl_x, s16 tl_y, s16 bl_x, s16 bl_y, s16 tr_x, s16 tr_y,
 	//a lookup table for the gouraud colors
 	COLOR colors[4];
 
-	Vdp1ReadCommand(&cmd, Vdp1Regs->addr);
+	Vdp1ReadCommandRam(&cmd, vdp1ram, vdp1regs->addr);
 	characterWidth = ((cmd.CMDSIZE >> 8) & 0x3F) * 8;
 	characterHeight = cmd.CMDSIZE & 0xFF;
 
@@ -2496,15 +2650,15 @@ static void drawQuad(s16 tl_x, s16 tl_y, s16 bl_x, s16 bl_y, s16 tr_x, s16 tr_y,
 	}
 }
 
-void VIDSoftVdp1NormalSpriteDraw() {
+static void Vdp1NormalSpriteDraw(void) {
 
 	s16 topLeftx,topLefty,topRightx,topRighty,bottomRightx,bottomRighty,bottomLeftx,bottomLefty;
 	int spriteWidth;
 	int spriteHeight;
-	Vdp1ReadCommand(&cmd, Vdp1Regs->addr);
+	Vdp1ReadCommandRam(&cmd, vdp1ram, vdp1regs->addr);
 
-	topLeftx = cmd.CMDXA + Vdp1Regs->localX;
-	topLefty = cmd.CMDYA + Vdp1Regs->localY;
+	topLeftx = cmd.CMDXA + vdp1regs->localX;
+	topLefty = cmd.CMDYA + vdp1regs->localY;
 	spriteWidth = ((cmd.CMDSIZE >> 8) & 0x3F) * 8;
 	spriteHeight = cmd.CMDSIZE & 0xFF;
 
@@ -2518,21 +2672,21 @@ void VIDSoftVdp1NormalSpriteDraw() {
 	drawQuad(topLeftx,topLefty,bottomLeftx,bottomLefty,topRightx,topRighty,bottomRightx,bottomRighty);
 }
 
-void VIDSoftVdp1ScaledSpriteDraw(){
+static void Vdp1ScaledSpriteDraw(void){
 
 	s32 topLeftx,topLefty,topRightx,topRighty,bottomRightx,bottomRighty,bottomLeftx,bottomLefty;
 	int x0,y0,x1,y1;
-	Vdp1ReadCommand(&cmd, Vdp1Regs->addr);
+	Vdp1ReadCommandRam(&cmd, vdp1ram, vdp1regs->addr);
 
-	x0 = cmd.CMDXA + Vdp1Regs->localX;
-	y0 = cmd.CMDYA + Vdp1Regs->localY;
+	x0 = cmd.CMDXA + vdp1regs->localX;
+	y0 = cmd.CMDYA + vdp1regs->localY;
 
 	switch ((cmd.CMDCTRL >> 8) & 0xF)
 	{
 	case 0x0: // Only two coordinates
 	default:
-		x1 = ((int)cmd.CMDXC) - x0 + Vdp1Regs->localX + 1;
-		y1 = ((int)cmd.CMDYC) - y0 + Vdp1Regs->localY + 1;
+		x1 = ((int)cmd.CMDXC) - x0 + vdp1regs->localX + 1;
+		y1 = ((int)cmd.CMDYC) - y0 + vdp1regs->localY + 1;
 		break;
 	case 0x5: // Upper-left
 		x1 = ((int)cmd.CMDXB) + 1;
@@ -2615,23 +2769,23 @@ void VIDSoftVdp1ScaledSpriteDraw(){
 	drawQuad(topLeftx,topLefty,bottomLeftx,bottomLefty,topRightx,topRighty,bottomRightx,bottomRighty);
 }
 
-void VIDSoftVdp1DistortedSpriteDraw() {
+static void Vdp1DistortedSpriteDraw(void) {
 
 	s32 xa,ya,xb,yb,xc,yc,xd,yd;
 
-	Vdp1ReadCommand(&cmd, Vdp1Regs->addr);
+	Vdp1ReadCommandRam(&cmd, vdp1ram, vdp1regs->addr);
 
-    xa = (s32)(cmd.CMDXA + Vdp1Regs->localX);
-    ya = (s32)(cmd.CMDYA + Vdp1Regs->localY);
+    xa = (s32)(cmd.CMDXA + vdp1regs->localX);
+    ya = (s32)(cmd.CMDYA + vdp1regs->localY);
 
-    xb = (s32)(cmd.CMDXB + Vdp1Regs->localX);
-    yb = (s32)(cmd.CMDYB + Vdp1Regs->localY);
+    xb = (s32)(cmd.CMDXB + vdp1regs->localX);
+    yb = (s32)(cmd.CMDYB + vdp1regs->localY);
 
-    xc = (s32)(cmd.CMDXC + Vdp1Regs->localX);
-    yc = (s32)(cmd.CMDYC + Vdp1Regs->localY);
+    xc = (s32)(cmd.CMDXC + vdp1regs->localX);
+    yc = (s32)(cmd.CMDYC + vdp1regs->localY);
 
-    xd = (s32)(cmd.CMDXD + Vdp1Regs->localX);
-    yd = (s32)(cmd.CMDYD + Vdp1Regs->localY);
+    xd = (s32)(cmd.CMDXD + vdp1regs->localX);
+    yd = (s32)(cmd.CMDYD + vdp1regs->localY);
 
 	drawQuad(xa,ya,xd,yd,xb,yb,xc,yc);
 }
@@ -2649,23 +2803,23 @@ static void gouraudLineSetup(double * redstep, double * greenstep, double * blue
 	leftColumnColor.b = table1.b;
 }
 
-void VIDSoftVdp1PolylineDraw(void)
+static void Vdp1PolylineDraw(void)
 {
 	int X[4];
 	int Y[4];
 	double redstep = 0, greenstep = 0, bluestep = 0;
 	int length;
 
-	Vdp1ReadCommand(&cmd, Vdp1Regs->addr);
+	Vdp1ReadCommandRam(&cmd, vdp1ram, vdp1regs->addr);
 
-	X[0] = (int)Vdp1Regs->localX + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x0C));
-	Y[0] = (int)Vdp1Regs->localY + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x0E));
-	X[1] = (int)Vdp1Regs->localX + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x10));
-	Y[1] = (int)Vdp1Regs->localY + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x12));
-	X[2] = (int)Vdp1Regs->localX + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x14));
-	Y[2] = (int)Vdp1Regs->localY + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x16));
-	X[3] = (int)Vdp1Regs->localX + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x18));
-	Y[3] = (int)Vdp1Regs->localY + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x1A));
+	X[0] = (int)vdp1regs->localX + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x0C));
+	Y[0] = (int)vdp1regs->localY + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x0E));
+	X[1] = (int)vdp1regs->localX + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x10));
+	Y[1] = (int)vdp1regs->localY + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x12));
+	X[2] = (int)vdp1regs->localX + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x14));
+	Y[2] = (int)vdp1regs->localY + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x16));
+	X[3] = (int)vdp1regs->localX + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x18));
+	Y[3] = (int)vdp1regs->localY + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x1A));
 
 	length = iterateOverLine(X[0], Y[0], X[1], Y[1], 1, NULL, NULL);
 	gouraudLineSetup(&redstep,&greenstep,&bluestep,length, gouraudA, gouraudB);
@@ -2684,18 +2838,18 @@ void VIDSoftVdp1PolylineDraw(void)
 	DrawLine(X[0], Y[0], X[3], Y[3], 0, 0,0,redstep,greenstep,bluestep);
 }
 
-void VIDSoftVdp1LineDraw(void)
+static void Vdp1LineDraw(void)
 {
 	int x1, y1, x2, y2;
 	double redstep = 0, greenstep = 0, bluestep = 0;
 	int length;
 
-	Vdp1ReadCommand(&cmd, Vdp1Regs->addr);
+	Vdp1ReadCommandRam(&cmd, vdp1ram, vdp1regs->addr);
 
-	x1 = (int)Vdp1Regs->localX + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x0C));
-	y1 = (int)Vdp1Regs->localY + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x0E));
-	x2 = (int)Vdp1Regs->localX + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x10));
-	y2 = (int)Vdp1Regs->localY + (int)((s16)T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x12));
+	x1 = (int)vdp1regs->localX + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x0C));
+	y1 = (int)vdp1regs->localY + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x0E));
+	x2 = (int)vdp1regs->localX + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x10));
+	y2 = (int)vdp1regs->localY + (int)((s16)T1ReadWord(vdp1ram, vdp1regs->addr + 0x12));
 
 	length = iterateOverLine(x1, y1, x2, y2, 1, NULL, NULL);
 	gouraudLineSetup(&redstep,&bluestep,&greenstep,length, gouraudA, gouraudB);
@@ -2704,39 +2858,39 @@ void VIDSoftVdp1LineDraw(void)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void VIDSoftVdp1UserClipping(void)
+static void Vdp1UserClipping(void)
 {
-   Vdp1Regs->userclipX1 = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0xC);
-   Vdp1Regs->userclipY1 = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0xE);
-   Vdp1Regs->userclipX2 = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x14);
-   Vdp1Regs->userclipY2 = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x16);
+   vdp1regs->userclipX1 = T1ReadWord(vdp1ram, vdp1regs->addr + 0xC);
+   vdp1regs->userclipY1 = T1ReadWord(vdp1ram, vdp1regs->addr + 0xE);
+   vdp1regs->userclipX2 = T1ReadWord(vdp1ram, vdp1regs->addr + 0x14);
+   vdp1regs->userclipY2 = T1ReadWord(vdp1ram, vdp1regs->addr + 0x16);
 
 #if 0
-   vdp1clipxstart = Vdp1Regs->userclipX1;
-   vdp1clipxend = Vdp1Regs->userclipX2;
-   vdp1clipystart = Vdp1Regs->userclipY1;
-   vdp1clipyend = Vdp1Regs->userclipY2;
+   vdp1clipxstart = vdp1regs->userclipX1;
+   vdp1clipxend = vdp1regs->userclipX2;
+   vdp1clipystart = vdp1regs->userclipY1;
+   vdp1clipyend = vdp1regs->userclipY2;
 
    // This needs work
-   if (vdp1clipxstart > Vdp1Regs->systemclipX1)
-      vdp1clipxstart = Vdp1Regs->userclipX1;
+   if (vdp1clipxstart > vdp1regs->systemclipX1)
+      vdp1clipxstart = vdp1regs->userclipX1;
    else
-      vdp1clipxstart = Vdp1Regs->systemclipX1;
+      vdp1clipxstart = vdp1regs->systemclipX1;
 
-   if (vdp1clipxend < Vdp1Regs->systemclipX2)
-      vdp1clipxend = Vdp1Regs->userclipX2;
+   if (vdp1clipxend < vdp1regs->systemclipX2)
+      vdp1clipxend = vdp1regs->userclipX2;
    else
-      vdp1clipxend = Vdp1Regs->systemclipX2;
+      vdp1clipxend = vdp1regs->systemclipX2;
 
-   if (vdp1clipystart > Vdp1Regs->systemclipY1)
-      vdp1clipystart = Vdp1Regs->userclipY1;
+   if (vdp1clipystart > vdp1regs->systemclipY1)
+      vdp1clipystart = vdp1regs->userclipY1;
    else
-      vdp1clipystart = Vdp1Regs->systemclipY1;
+      vdp1clipystart = vdp1regs->systemclipY1;
 
-   if (vdp1clipyend < Vdp1Regs->systemclipY2)
-      vdp1clipyend = Vdp1Regs->userclipY2;
+   if (vdp1clipyend < vdp1regs->systemclipY2)
+      vdp1clipyend = vdp1regs->userclipY2;
    else
-      vdp1clipyend = Vdp1Regs->systemclipY2;
+      vdp1clipyend = vdp1regs->systemclipY2;
 #endif
 }
 
@@ -2750,64 +2904,120 @@ static void PushUserClipping(int mode)
       return;
    }
 
-   vdp1clipxstart = Vdp1Regs->userclipX1;
-   vdp1clipxend = Vdp1Regs->userclipX2;
-   vdp1clipystart = Vdp1Regs->userclipY1;
-   vdp1clipyend = Vdp1Regs->userclipY2;
+   vdp1clipxstart = vdp1regs->userclipX1;
+   vdp1clipxend = vdp1regs->userclipX2;
+   vdp1clipystart = vdp1regs->userclipY1;
+   vdp1clipyend = vdp1regs->userclipY2;
 
    // This needs work
-   if (vdp1clipxstart > Vdp1Regs->systemclipX1)
-      vdp1clipxstart = Vdp1Regs->userclipX1;
+   if (vdp1clipxstart > vdp1regs->systemclipX1)
+      vdp1clipxstart = vdp1regs->userclipX1;
    else
-      vdp1clipxstart = Vdp1Regs->systemclipX1;
+      vdp1clipxstart = vdp1regs->systemclipX1;
 
-   if (vdp1clipxend < Vdp1Regs->systemclipX2)
-      vdp1clipxend = Vdp1Regs->userclipX2;
+   if (vdp1clipxend < vdp1regs->systemclipX2)
+      vdp1clipxend = vdp1regs->userclipX2;
    else
-      vdp1clipxend = Vdp1Regs->systemclipX2;
+      vdp1clipxend = vdp1regs->systemclipX2;
 
-   if (vdp1clipystart > Vdp1Regs->systemclipY1)
-      vdp1clipystart = Vdp1Regs->userclipY1;
+   if (vdp1clipystart > vdp1regs->systemclipY1)
+      vdp1clipystart = vdp1regs->userclipY1;
    else
-      vdp1clipystart = Vdp1Regs->systemclipY1;
+      vdp1clipystart = vdp1regs->systemclipY1;
 
-   if (vdp1clipyend < Vdp1Regs->systemclipY2)
-      vdp1clipyend = Vdp1Regs->userclipY2;
+   if (vdp1clipyend < vdp1regs->systemclipY2)
+      vdp1clipyend = vdp1regs->userclipY2;
    else
-      vdp1clipyend = Vdp1Regs->systemclipY2;
+      vdp1clipyend = vdp1regs->systemclipY2;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 static void PopUserClipping(void)
 {
-   vdp1clipxstart = Vdp1Regs->systemclipX1;
-   vdp1clipxend = Vdp1Regs->systemclipX2;
-   vdp1clipystart = Vdp1Regs->systemclipY1;
-   vdp1clipyend = Vdp1Regs->systemclipY2;
+   vdp1clipxstart = vdp1regs->systemclipX1;
+   vdp1clipxend = vdp1regs->systemclipX2;
+   vdp1clipystart = vdp1regs->systemclipY1;
+   vdp1clipyend = vdp1regs->systemclipY2;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void VIDSoftVdp1SystemClipping(void)
+static void Vdp1SystemClipping(void)
+{
+   vdp1regs->systemclipX1 = 0;
+   vdp1regs->systemclipY1 = 0;
+   vdp1regs->systemclipX2 = T1ReadWord(vdp1ram, vdp1regs->addr + 0x14);
+   vdp1regs->systemclipY2 = T1ReadWord(vdp1ram, vdp1regs->addr + 0x16);
+
+   vdp1clipxstart = vdp1regs->systemclipX1;
+   vdp1clipxend = vdp1regs->systemclipX2;
+   vdp1clipystart = vdp1regs->systemclipY1;
+   vdp1clipyend = vdp1regs->systemclipY2;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void Vdp1LocalCoordinate(void)
+{
+   vdp1regs->localX = T1ReadWord(vdp1ram, vdp1regs->addr + 0xC);
+   vdp1regs->localY = T1ReadWord(vdp1ram, vdp1regs->addr + 0xE);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1NormalSpriteDraw(void)
+{
+   Vdp1RunCommand(Vdp1NormalSpriteDraw, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1ScaledSpriteDraw(void)
 {
-   Vdp1Regs->systemclipX1 = 0;
-   Vdp1Regs->systemclipY1 = 0;
-   Vdp1Regs->systemclipX2 = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x14);
-   Vdp1Regs->systemclipY2 = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0x16);
+   Vdp1RunCommand(Vdp1ScaledSpriteDraw, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1DistortedSpriteDraw(void)
+{
+   Vdp1RunCommand(Vdp1DistortedSpriteDraw, 1);
+}
 
-   vdp1clipxstart = Vdp1Regs->systemclipX1;
-   vdp1clipxend = Vdp1Regs->systemclipX2;
-   vdp1clipystart = Vdp1Regs->systemclipY1;
-   vdp1clipyend = Vdp1Regs->systemclipY2;
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1PolylineDraw(void)
+{
+   Vdp1RunCommand(Vdp1PolylineDraw, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1LineDraw(void)
+{
+   Vdp1RunCommand(Vdp1LineDraw, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1UserClipping(void)
+{
+   Vdp1RunCommand(Vdp1UserClipping, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp1SystemClipping(void)
+{
+   Vdp1RunCommand(Vdp1SystemClipping, 0);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void VIDSoftVdp1LocalCoordinate(void)
 {
-   Vdp1Regs->localX = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0xC);
-   Vdp1Regs->localY = T1ReadWord(Vdp1Ram, Vdp1Regs->addr + 0xE);
+   Vdp1RunCommand(Vdp1LocalCoordinate, 0);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -2846,6 +3056,8 @@ void VIDSoftVdp2DrawEnd(void)
    int wctl;
    clipping_struct colorcalcwindow[2];
 
+   VIDSoftVdp1Sync();
+
    // Figure out whether to draw vdp1 framebuffer or vdp2 framebuffer pixels
    // based on priority
    if (Vdp1External.disptoggle && (Vdp2Regs->TVMD & 0x8000))
@@ -3101,42 +3313,10 @@ void VIDSoftVdp2DrawEnd(void)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void VIDSoftVdp2DrawScreens(void)
+static void Vdp2DrawScreenNum(int screen)
 {
-   int i;
-
-   VIDSoftVdp2SetResolution(Vdp2Regs->TVMD);
-   VIDSoftVdp2SetPriorityNBG0(Vdp2Regs->PRINA & 0x7);
-   VIDSoftVdp2SetPriorityNBG1((Vdp2Regs->PRINA >> 8) & 0x7);
-   VIDSoftVdp2SetPriorityNBG2(Vdp2Regs->PRINB & 0x7);
-   VIDSoftVdp2SetPriorityNBG3((Vdp2Regs->PRINB >> 8) & 0x7);
-   VIDSoftVdp2SetPriorityRBG0(Vdp2Regs->PRIR & 0x7);
-
-   for (i = 7; i > 0; i--)
-   {   
-      if (nbg3priority == i)
-         Vdp2DrawNBG3();
-      if (nbg2priority == i)
-         Vdp2DrawNBG2();
-      if (nbg1priority == i)
-         Vdp2DrawNBG1();
-      if (nbg0priority == i)
-         Vdp2DrawNBG0();
-      if (rbg0priority == i)
-         Vdp2DrawRBG0();
-   }
-}
-
-//////////////////////////////////////////////////////////////////////////////
+   u64 start = vdp2timingenabled ? YabauseGetTicks() : 0;
 
-void VIDSoftVdp2DrawScreen(int screen)
-{
-   VIDSoftVdp2SetResolution(Vdp2Regs->TVMD);
-   VIDSoftVdp2SetPriorityNBG0(Vdp2Regs->PRINA & 0x7);
-   VIDSoftVdp2SetPriorityNBG1((Vdp2Regs->PRINA >> 8) & 0x7);
-   VIDSoftVdp2SetPriorityNBG2(Vdp2Regs->PRINB & 0x7);
-   VIDSoftVdp2SetPriorityNBG3((Vdp2Regs->PRINB >> 8) & 0x7);
-   VIDSoftVdp2SetPriorityRBG0(Vdp2Regs->PRIR & 0x7);
    switch(screen)
    {
       case 0:
@@ -3155,10 +3335,122 @@ void VIDSoftVdp2DrawScreen(int screen)
          Vdp2DrawRBG0();
          break;
    }
+
+   // each screen is drawn by only one task so this doesn't need synchronizing
+   if (vdp2timingenabled)
+      vdp2timing.screenticks[screen] += YabauseGetTicks() - start;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void Vdp2DrawTask(int task)
+{
+   int i;
+
+   for (i = 0; i < vdp2tasksize[task]; i++)
+      Vdp2DrawScreenNum(vdp2taskscreens[task][i]);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void VIDSoftVdp2SetPriorities(void)
+{
+   VIDSoftVdp2SetResolution(Vdp2Regs->TVMD);
+   VIDSoftVdp2SetPriorityNBG0(Vdp2Regs->PRINA & 0x7);
+   VIDSoftVdp2SetPriorityNBG1((Vdp2Regs->PRINA >> 8) & 0x7);
+   VIDSoftVdp2SetPriorityNBG2(Vdp2Regs->PRINB & 0x7);
+   VIDSoftVdp2SetPriorityNBG3((Vdp2Regs->PRINB >> 8) & 0x7);
+   VIDSoftVdp2SetPriorityRBG0(Vdp2Regs->PRIR & 0x7);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp2DrawScreens(void)
+{
+   // screens of the same priority in the order they're drawn
+   static const int draworder[VIDSOFT_VDP2_SCREENS] = { 3, 2, 1, 0, 4 };
+   int priority[VIDSOFT_VDP2_SCREENS];
+   int prioritytask[8];
+   int tasks = 0;
+   int sequential;
+   u64 start;
+   int i, j;
+
+   start = vdp2timingenabled ? YabauseGetTicks() : 0;
+   VIDSoftVdp2SetPriorities();
+   priority[0] = nbg0priority;
+   priority[1] = nbg1priority;
+   priority[2] = nbg2priority;
+   priority[3] = nbg3priority;
+   priority[4] = rbg0priority;
+
+   // Each priority has its own Titan buffer so only screens sharing one are
+   // order-dependent. RBG0 & NBG0 in RBG1 mode can both write the rotation line
+   // color screens, keep them on one thread as well.
+   sequential = VIDSoftVdp2RunTasks == NULL ||
+      ((Vdp2Regs->BGON & 0x30) == 0x30 && nbg0priority && rbg0priority);
+
+   for (i = 0; i < 8; i++)
+      prioritytask[i] = -1;
+
+   for (i = 7; i > 0; i--)
+   {
+      for (j = 0; j < VIDSOFT_VDP2_SCREENS; j++)
+      {
+         int screen = draworder[j];
+         int key = sequential ? 0 : i;
+         int task;
+
+         if (priority[screen] != i)
+            continue;
+         if (prioritytask[key] == -1)
+         {
+            prioritytask[key] = tasks++;
+            vdp2tasksize[prioritytask[key]] = 0;
+         }
+         task = prioritytask[key];
+         vdp2taskscreens[task][vdp2tasksize[task]++] = screen;
+      }
+   }
+
+   if (tasks > 1)
+      VIDSoftVdp2RunTasks(Vdp2DrawTask, tasks);
+   else if (tasks)
+      Vdp2DrawTask(0);
+
+   if (vdp2timingenabled)
+   {
+      vdp2timing.totalticks += YabauseGetTicks() - start;
+      vdp2timing.frames++;
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp2DrawScreen(int screen)
+{
+   VIDSoftVdp2SetPriorities();
+   Vdp2DrawScreenNum(screen);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp2EnableTiming(int enable)
+{
+   vdp2timingenabled = enable;
+   memset(&vdp2timing, 0, sizeof(vdp2timing));
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
+void VIDSoftVdp2TakeTiming(VIDSoftVdp2Timing *timing)
+{
+   *timing = vdp2timing;
+   memset(&vdp2timing, 0, sizeof(vdp2timing));
+}
+
+//////
+
 void VIDSoftVdp2SetResolution(u16 TVMD)
 {
    // This needs some work
@@ -3286,30 +3578,26 @@ void VIDSoftVdp1EraseFrameBuffer(void)
    int i,i2;
    int w,h;
 
-   if (((Vdp1Regs->FBCR & 2) == 0) || Vdp1External.manualerase)
-   {
-      h = (Vdp1Regs->EWRR & 0x1FF) + 1;
-      if (h > vdp1height) h = vdp1height;
-      w = ((Vdp1Regs->EWRR >> 6) & 0x3F8) + 8;
-      if (w > vdp1width) w = vdp1width;
+   h = (vdp1regs->EWRR & 0x1FF) + 1;
+   if (h > vdp1height) h = vdp1height;
+   w = ((vdp1regs->EWRR >> 6) & 0x3F8) + 8;
+   if (w > vdp1width) w = vdp1width;
 
-      if (vdp1pixelsize == 2)
+   if (vdp1pixelsize == 2)
+   {
+      for (i2 = (vdp1regs->EWLR & 0x1FF); i2 < h; i2++)
       {
-         for (i2 = (Vdp1Regs->EWLR & 0x1FF); i2 < h; i2++)
-         {
-            for (i = ((Vdp1Regs->EWLR >> 6) & 0x1F8); i < w; i++)
-               ((u16 *)vdp1backframebuffer)[(i2 * vdp1width) + i] = Vdp1Regs->EWDR;
-         }
+         for (i = ((vdp1regs->EWLR >> 6) & 0x1F8); i < w; i++)
+            ((u16 *)vdp1backframebuffer)[(i2 * vdp1width) + i] = vdp1regs->EWDR;
       }
-      else
+   }
+   else
+   {
+      for (i2 = (vdp1regs->EWLR & 0x1FF); i2 < h; i2++)
       {
-         for (i2 = (Vdp1Regs->EWLR & 0x1FF); i2 < h; i2++)
-         {
-            for (i = ((Vdp1Regs->EWLR >> 6) & 0x1F8); i < w; i++)
-               vdp1backframebuffer[(i2 * vdp1width) + i] = Vdp1Regs->EWDR & 0xFF;
-         }
+         for (i = ((vdp1regs->EWLR >> 6) & 0x1F8); i < w; i++)
+            vdp1backframebuffer[(i2 * vdp1width) + i] = vdp1regs->EWDR & 0xFF;
       }
-      Vdp1External.manualerase = 0;
    }
 }
 
@@ -30,4 +30,32 @@ extern VideoInterface_struct VIDSoft;
 
 void VIDSoftVdp2DrawScreen(int screen);
 
+#define VIDSOFT_VDP2_SCREENS 5
+
+/* Set by the port to draw VDP2 screens of different priorities in parallel. It must
+   call func for each task from 0 to tasks - 1 & return once they've all finished.
+   When NULL the screens are drawn in sequence. */
+extern void (*VIDSoftVdp2RunTasks)(void (*func)(int task), int tasks);
+
+typedef struct
+{
+   u64 screenticks[VIDSOFT_VDP2_SCREENS]; /* NBG0-3 & RBG0 */
+   u64 totalticks;
+   u32 frames;
+} VIDSoftVdp2Timing;
+
+/* Timings are in YabauseGetTicks() units, accumulated until taken */
+void VIDSoftVdp2EnableTiming(int enable);
+void VIDSoftVdp2TakeTiming(VIDSoftVdp2Timing *timing);
+
+/* Set by the port to draw VDP1 command lists on another thread. Start must run func
+   there & return right away, Wait must block until it returns. The command table &
+   VDP1 RAM are copied when drawing starts while the registers & interrupts update as
+   usual, the framebuffer being finished before VDP2 uses it at VBlankIN. */
+extern void (*VIDSoftVdp1StartThread)(void (*func)(void));
+extern void (*VIDSoftVdp1WaitThread)(void);
+
+/* Waits for any VDP1 drawing on the other thread, call before changing the above */
+void VIDSoftVdp1Sync(void);
+
 #endif
@@ -539,6 +539,63 @@ static void UnfreezeStructFromCopy (void *base, FreezeData *fields, int num_fiel
 
 static int UnfreezeBlockCopy (STREAM stream, const char *name, uint8** block, int size);
 
+// When memSnapshot is active the stream functions below read/write its buffer
+// instead of the STREAM argument, a NULL data pointer only counts bytes written
+static struct
+{
+    uint8 *data;
+    uint32 size;
+    uint32 pos;
+    bool8 active;
+    bool8 overflow;
+} memSnapshot;
+
+static int SnapshotRead (void *p, int l, STREAM s)
+{
+    if (!memSnapshot.active)
+		return (READ_STREAM (p, l, s));
+    int avail = memSnapshot.size - memSnapshot.pos;
+    if (l > avail)
+		l = avail;
+    memcpy (p, memSnapshot.data + memSnapshot.pos, l);
+    memSnapshot.pos += l;
+    return (l);
+}
+
+static int SnapshotWrite (const void *p, int l, STREAM s)
+{
+    if (!memSnapshot.active)
+		return (WRITE_STREAM (p, l, s));
+    if (memSnapshot.data)
+    {
+		if ((uint32) l > memSnapshot.size - memSnapshot.pos)
+		{
+			memSnapshot.overflow = TRUE;
+			return (0);
+		}
+		memcpy (memSnapshot.data + memSnapshot.pos, p, l);
+    }
+    memSnapshot.pos += l;
+    return (l);
+}
+
+static long SnapshotTell (STREAM s)
+{
+    if (!memSnapshot.active)
+		return (FIND_STREAM (s));
+    return (memSnapshot.pos);
+}
+
+static void SnapshotSeek (STREAM s, long offset)
+{
+    if (!memSnapshot.active)
+    {
+		REVERT_STREAM (s, offset, 0);
+		return;
+    }
+    memSnapshot.pos = offset;
+}
+
 bool8 Snapshot (const char *filename)
 {
     return (S9xFreezeGame (filename));
@@ -627,6 +684,42 @@ bool8 S9xUnfreezeGame (const char *filename)
     return (FALSE);
 }
 
+uint32 S9xFreezeSize ()
+{
+    memSnapshot.data = NULL;
+    memSnapshot.size = 0;
+    memSnapshot.pos = 0;
+    memSnapshot.overflow = FALSE;
+    memSnapshot.active = TRUE;
+    S9xFreezeToStream (NULL);
+    memSnapshot.active = FALSE;
+    return (memSnapshot.pos);
+}
+
+uint32 S9xFreezeGameMem (uint8 *buf, uint32 bufSize)
+{
+    memSnapshot.data = buf;
+    memSnapshot.size = bufSize;
+    memSnapshot.pos = 0;
+    memSnapshot.overflow = FALSE;
+    memSnapshot.active = TRUE;
+    S9xFreezeToStream (NULL);
+    memSnapshot.active = FALSE;
+    return (memSnapshot.overflow ? 0 : memSnapshot.pos);
+}
+
+int S9xUnfreezeGameMem (const uint8 *buf, uint32 bufSize)
+{
+    memSnapshot.data = (uint8 *) buf;
+    memSnapshot.size = bufSize;
+    memSnapshot.pos = 0;
+    memSnapshot.overflow = FALSE;
+    memSnapshot.active = TRUE;
+    int result = S9xUnfreezeFromStream (NULL);
+    memSnapshot.active = FALSE;
+    return (result);
+}
+
 void S9xFreezeToStream (STREAM stream)
 {
     char buffer [1024];
@@ -647,10 +740,10 @@ void S9xFreezeToStream (STREAM stream)
 		SoundData.channels [i].previous16 [1] = (int16) SoundData.channels [i].previous [1];
     }
     sprintf (buffer, "%s:%04d\n", SNAPSHOT_MAGIC, SNAPSHOT_VERSION);
-    WRITE_STREAM (buffer, strlen (buffer), stream);
+    SnapshotWrite (buffer, strlen (buffer), stream);
     sprintf (buffer, "NAM:%06d:%s%c", (int)strlen (Memory.ROMFilename) + 1,
 		Memory.ROMFilename, 0);
-    WRITE_STREAM (buffer, strlen (buffer) + 1, stream);
+    SnapshotWrite (buffer, strlen (buffer) + 1, stream);
     FreezeStruct (stream, "CPU", &CPU, SnapCPU, COUNT (SnapCPU));
     FreezeStruct (stream, "REG", &Registers, SnapRegisters, COUNT (SnapRegisters));
     FreezeStruct (stream, "PPU", &PPU, SnapPPU, COUNT (SnapPPU));
@@ -720,7 +813,7 @@ int S9xUnfreezeFromStream (STREAM stream)
 	
     int version;
     int len = strlen (SNAPSHOT_MAGIC) + 1 + 4 + 1;
-    if (READ_STREAM (buffer, len, stream) != len)
+    if (SnapshotRead (buffer, len, stream) != len)
 		return (WRONG_FORMAT);
     if (strncmp (buffer, SNAPSHOT_MAGIC, strlen (SNAPSHOT_MAGIC)) != 0)
 		return (WRONG_FORMAT);
@@ -1062,8 +1155,8 @@ static void FreezeBlock (STREAM stream, const char *name, uint8 *block, int size
 {
     char buffer [512];
     sprintf (buffer, "%s:%06d:", name, size);
-    WRITE_STREAM (buffer, strlen (buffer), stream);
-    WRITE_STREAM (block, size, stream);
+    SnapshotWrite (buffer, strlen (buffer), stream);
+    SnapshotWrite (block, size, stream);
     
 }
 
@@ -1167,11 +1260,11 @@ static int UnfreezeBlock (STREAM stream, const char *name, uint8 *block, int siz
     int len = 0;
     int rem = 0;
     int rew_len;
-    if (READ_STREAM (buffer, 11, stream) != 11 ||
+    if (SnapshotRead (buffer, 11, stream) != 11 ||
 		strncmp (buffer, name, 3) != 0 || buffer [3] != ':' ||
 		(len = atoi (&buffer [4])) == 0)
     {
-		REVERT_STREAM(stream, FIND_STREAM(stream)-11, 0);
+		SnapshotSeek (stream, SnapshotTell (stream)-11);
 		return (WRONG_FORMAT);
     }
 
@@ -1180,15 +1273,15 @@ static int UnfreezeBlock (STREAM stream, const char *name, uint8 *block, int siz
 		rem = len - size;
 		len = size;
     }
-    if ((rew_len=READ_STREAM (block, len, stream)) != len)
+    if ((rew_len=SnapshotRead (block, len, stream)) != len)
 	{
-		REVERT_STREAM(stream, FIND_STREAM(stream)-11-rew_len, 0);
+		SnapshotSeek (stream, SnapshotTell (stream)-11-rew_len);
 		return (WRONG_FORMAT);
 	}
     if (rem)
     {
 		char *junk = new char [rem];
-		READ_STREAM (junk, rem, stream);
+		SnapshotRead (junk, rem, stream);
 		delete [] junk;
     }
 	
@@ -110,6 +110,9 @@ bool8 S9xLoadSnapshot (const char *filename);
 bool8 S9xSPCDump (const char *filename);
 void S9xFreezeToStream (STREAM);
 int S9xUnfreezeFromStream (STREAM);
+uint32 S9xFreezeSize ();
+uint32 S9xFreezeGameMem (uint8 *buf, uint32 bufSize); // returns the state size, or 0 if bufSize is too small
+int S9xUnfreezeGameMem (const uint8 *buf, uint32 bufSize);
 END_EXTERN_C
 
 #endif
@@ -126,6 +126,39 @@ void EmuSystem::loadState(IG::CStringView path)
 		return throwFileReadError();
 }
 
+size_t EmuSystem::stateSize()
+{
+	#ifndef SNES9X_VERSION_1_4
+	return S9xFreezeSize() + 1; // memStream truncates silently, so 1 unused byte detects it
+	#else
+	return S9xFreezeSize();
+	#endif
+}
+
+size_t EmuSystem::saveState(std::span<uint8_t> buff)
+{
+	// freeze directly into the buffer, its size comes from stateSize()
+	#ifndef SNES9X_VERSION_1_4
+	memStream stream{buff.data(), buff.size()};
+	S9xFreezeToStream(&stream);
+	size_t size = stream.pos();
+	if(size == buff.size())
+		throw std::runtime_error("State buffer too small");
+	#else
+	size_t size = S9xFreezeGameMem(buff.data(), buff.size());
+	if(!size)
+		throw std::runtime_error("State buffer too small");
+	#endif
+	return size;
+}
+
+void EmuSystem::loadState(std::span<const uint8_t> buff)
+{
+	if(S9xUnfreezeGameMem(buff.data(), buff.size()) != SUCCESS)
+		throw std::runtime_error("Invalid state data");
+	IPPU.RenderThisFrame = TRUE;
+}
+
 void EmuSystem::saveBackupMem(IG::ApplicationContext ctx)
 {
 	if(gameIsRunning())
@@ -73,7 +73,9 @@ struct Format
 		return framesToBytes(timeToFrames(time));
 	}
 
+	// converts & applies volume with the instruction set named by simdName(), int16 output saturates
 	void *copyFrames(void *dest, const void *src, unsigned frames, Format srcFormat, float volume = 1.f) const;
+	static const char *simdName();
 };
 
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/audio/Format.hh>
+#include <vector>
+#include <cstdint>
+
+namespace IG::Audio
+{
+
+enum class ResamplerQuality : uint8_t
+{
+	FAST,   // nearest neighbor
+	MEDIUM, // 8-tap windowed sinc
+	HIGH,   // 32-tap windowed sinc
+};
+
+// Converts a block of frames to a different number of frames, used when audio
+// must be shortened for fast-forward, fit a full buffer, or be rate corrected.
+// The sinc qualities use a polyphase filter table with the cutoff lowered and the
+// taps widened for the decimation ratio. Consecutive blocks are treated as one
+// stream: the newest source frames are kept as filter history for the next call,
+// which delays the output by half the quality's widest filter. Once the history is filled,
+// equal sized blocks are copied through that same delay so the stream stays
+// continuous. Call reset() when the next block doesn't follow the previous one.
+// Only 16-bit integer & float samples in 1 or 2 channels are supported.
+class Resampler
+{
+public:
+	static constexpr ResamplerQuality DEFAULT_QUALITY = ResamplerQuality::MEDIUM;
+
+	constexpr Resampler() = default;
+	void setQuality(ResamplerQuality);
+	ResamplerQuality quality() const { return quality_; }
+	// writes exactly destFrames frames to dest, src & dest use the same format
+	void resample(void *dest, uint32_t destFrames, const void *src, uint32_t srcFrames, Format);
+	void reset() { hasHistory_ = false; }
+	// true if the output is delayed by filter history, so even equal sized blocks must go through resample()
+	bool hasHistory() const { return hasHistory_; }
+	static const char *simdName();
+	// switches every Resampler between the kernels named by simdName() & the scalar ones,
+	// used to verify the SIMD kernels, not thread-safe while resampling
+	static void setUseSIMD(bool on);
+
+protected:
+	std::vector<float> coeffs{}; // [phase][tap * channels], duplicated per channel
+	std::vector<float> input{}; // history frames followed by the source frames as float
+	std::vector<float> output{};
+	float cutoff{};
+	uint16_t taps{};
+	uint8_t coeffChannels{};
+	uint8_t historyChannels{};
+	bool hasHistory_{};
+	ResamplerQuality quality_{DEFAULT_QUALITY};
+
+	void makeCoefficients(unsigned taps, float cutoff, unsigned channels);
+};
+
+}
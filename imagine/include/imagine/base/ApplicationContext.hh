@@ -178,6 +178,7 @@ public:
 	UniqueFileDescriptor openFileUriFd(IG::CStringView uri, IODefs::OpenFlags oFlags = {}) const;
 	bool fileUriExists(IG::CStringView uri) const;
 	std::string fileUriFormatLastWriteTimeLocal(IG::CStringView uri) const;
+	FS::file_time_type fileUriLastWriteTime(IG::CStringView uri) const;
 	FS::FileString fileUriDisplayName(IG::CStringView uri) const;
 	bool removeFileUri(IG::CStringView uri) const;
 	bool renameFileUri(IG::CStringView oldUri, IG::CStringView newUri) const;
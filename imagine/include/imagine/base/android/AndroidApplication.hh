@@ -84,6 +84,7 @@ public:
 	UniqueFileDescriptor openFileUriFd(JNIEnv *, jobject baseActivity, IG::CStringView uri, IODefs::OpenFlags oFlags = {}) const;
 	bool fileUriExists(JNIEnv *, jobject baseActivity, IG::CStringView uri) const;
 	std::string fileUriFormatLastWriteTimeLocal(JNIEnv *, jobject baseActivity, IG::CStringView uri) const;
+	FS::file_time_type fileUriLastWriteTime(JNIEnv *, jobject baseActivity, IG::CStringView uri) const;
 	FS::FileString fileUriDisplayName(JNIEnv *, jobject baseActivity, IG::CStringView uri) const;
 	bool removeFileUri(JNIEnv *, jobject baseActivity, IG::CStringView uri, bool isDir) const;
 	bool renameFileUri(JNIEnv *, jobject baseActivity, IG::CStringView oldUri, IG::CStringView newUri) const;
@@ -122,6 +123,7 @@ private:
 	JNI::InstMethod<jint(jstring, jint)> openUriFd{};
 	JNI::InstMethod<jboolean(jstring)> uriExists{};
 	JNI::InstMethod<jstring(jstring)> uriLastModified{};
+	JNI::InstMethod<jlong(jstring)> uriLastModifiedTime{};
 	JNI::InstMethod<jstring(jstring)> uriDisplayName{};
 	JNI::InstMethod<jboolean(jstring, jboolean)> deleteUri{};
 	JNI::InstMethod<jboolean(jlong, jstring)> listUriFiles{};
@@ -50,6 +50,9 @@ struct ApplicationInitParams
 	}
 };
 
+// Called with each evdev key event before it's dispatched to the windows, returns true to consume it
+using DirectKeyInputDelegate = DelegateFunc<bool (const Input::KeyEvent &)>;
+
 class LinuxApplication : public BaseApplication
 {
 public:
@@ -61,9 +64,12 @@ public:
 	void setAcceptIPC(bool on, const char *name);
 	FS::PathString appPath() const;
 	void setAppPath(FS::PathString);
+	void setOnDirectKeyInput(DirectKeyInputDelegate);
+	bool dispatchDirectKeyInput(const Input::KeyEvent &);
 
 protected:
 	FDEventSource evdevSrc{};
+	DirectKeyInputDelegate onDirectKeyInput{};
 	#ifdef CONFIG_BASE_DBUS
 	GDBusConnection *gbus{};
 	unsigned openPathSub{};
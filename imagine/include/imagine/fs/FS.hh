@@ -66,6 +66,7 @@ bool access(IG::CStringView path, acc type);
 bool remove(IG::CStringView path);
 bool create_directory(IG::CStringView path);
 bool rename(IG::CStringView oldPath, IG::CStringView newPath);
+bool last_write_time(IG::CStringView path, file_time_type time);
 
 PathString makeAppPathFromLaunchCommand(IG::CStringView launchPath);
 FileString basename(IG::CStringView path);
@@ -82,7 +82,9 @@ protected:
 	uint16_t lines = 0;
 	uint16_t maxLines = NO_MAX_LINES;
 
-	void drawSpan(RendererCommands &cmds, float xPos, float yPos, ProjectionPlane projP, std::u16string_view strView, std::array<TexVertex, 4> &vArr) const;
+	struct GlyphBatch;
+
+	void drawSpan(RendererCommands &cmds, float xPos, float yPos, ProjectionPlane projP, std::u16string_view strView, GlyphBatch &) const;
 	bool hasText() const;
 };
 
@@ -19,7 +19,9 @@
 #include <imagine/font/Font.hh>
 #include <imagine/gfx/PixmapTexture.hh>
 #include <imagine/util/container/VMemArray.hh>
+#include <deque>
 #include <system_error>
+#include <vector>
 
 namespace IG
 {
@@ -35,10 +37,26 @@ static constexpr auto glyphCommonTextureSampler = CommonTextureSampler::NO_MIP_C
 
 struct GlyphEntry
 {
-	Gfx::PixmapTexture glyph_{};
+	TextureSpan glyph_{}; // region of an atlas page
 	IG::GlyphMetrics metrics{};
 
-	constexpr const Gfx::PixmapTexture &glyph() const { return glyph_; }
+	constexpr TextureSpan glyph() const { return glyph_; }
+};
+
+// Texture holding many glyphs packed into shelves, rows as tall as the first
+// glyph placed in them & filled left to right
+struct GlyphAtlasPage
+{
+	struct Shelf
+	{
+		int y{};
+		int height{};
+		int x{};
+	};
+
+	Gfx::PixmapTexture texture{};
+	std::vector<Shelf> shelves{};
+	int nextShelfY{};
 };
 
 class GlyphTextureSet
@@ -57,12 +75,14 @@ public:
 	}
 	GlyphEntry *glyphEntry(Renderer &r, int c, bool allowCache = true);
 	uint32_t nominalHeight() const;
+	size_t atlasPageCount() const { return atlasPages.size(); }
 	void freeCaches(uint32_t rangeToFreeBits);
 	void freeCaches() { freeCaches(~0); }
 
 private:
 	IG::Font font{};
 	IG::VMemArray<GlyphEntry> glyphTable{};
+	std::deque<GlyphAtlasPage> atlasPages{}; // deque keeps the textures referenced by glyph entries in place
 	IG::FontSettings settings{};
 	IG::FontSize faceSize{};
 	uint32_t nominalHeight_ = 0;
@@ -71,6 +91,8 @@ private:
 	void calcNominalHeight(Renderer &r);
 	void resetGlyphTable();
 	std::errc cacheChar(Renderer &r, int c, int tableIdx);
+	TextureSpan addToAtlas(Renderer &r, IG::Pixmap glyphPix);
+	int atlasPageSize(IG::WP glyphSize) const;
 };
 
 }
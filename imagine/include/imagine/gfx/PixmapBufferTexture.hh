@@ -42,6 +42,9 @@ public:
 	IG::ErrorCode setFormat(IG::PixmapDesc desc, ColorSpace c = {}, const TextureSampler *compatSampler = {});
 	void write(IG::Pixmap pixmap, uint32_t writeFlags = 0);
 	void writeAligned(IG::Pixmap pixmap, uint8_t assumedDataAlignment, uint32_t writeFlags = 0);
+	// true if part of the texture can be updated without uploading the whole pixel buffer
+	bool canWriteSubRegion() const;
+	void writeSubRegion(IG::Pixmap pixmap, IG::WP destPos, uint32_t writeFlags = 0);
 	void clear();
 	LockedTextureBuffer lock(uint32_t bufferFlags = 0);
 	void unlock(LockedTextureBuffer lockBuff, uint32_t writeFlags = 0);
@@ -73,6 +73,9 @@ struct DrawableConfigDesc
 class Renderer : public RendererImpl
 {
 public:
+	// nice level of the thread running the main task
+	static constexpr int DRAW_THREAD_PRIORITY = -4;
+
 	using RendererImpl::RendererImpl;
 	Renderer(ApplicationContext);
 	~Renderer();
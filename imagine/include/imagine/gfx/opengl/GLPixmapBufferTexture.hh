@@ -34,6 +34,8 @@ public:
 	LockedTextureBuffer makeLockedBuffer(void *data, int pitchBytes, uint32_t bufferFlags);
 	virtual IG::ErrorCode setFormat(IG::PixmapDesc, ColorSpace, const TextureSampler *compatSampler) = 0;
 	virtual void writeAligned(IG::Pixmap pixmap, uint8_t assumeAlign, uint32_t writeFlags = 0);
+	virtual bool canWriteSubRegion() const;
+	virtual void writeSubRegion(IG::Pixmap pixmap, IG::WP destPos, uint32_t writeFlags = 0);
 	virtual LockedTextureBuffer lock(uint32_t bufferFlags = 0) = 0;
 	virtual void unlock(LockedTextureBuffer lockBuff, uint32_t writeFlags = 0) = 0;
 	virtual void setCompatTextureSampler(const TextureSampler &compatSampler);
@@ -73,6 +75,8 @@ public:
 	GLTextureStorage &operator=(GLTextureStorage &&o);
 	IG::ErrorCode setFormat(IG::PixmapDesc, ColorSpace, const TextureSampler *compatSampler) final;
 	void writeAligned(IG::Pixmap pixmap, uint8_t assumeAlign, uint32_t writeFlags = 0) final;
+	bool canWriteSubRegion() const final;
+	void writeSubRegion(IG::Pixmap pixmap, IG::WP destPos, uint32_t writeFlags = 0) final;
 	LockedTextureBuffer lock(uint32_t bufferFlags = 0) final;
 	void unlock(LockedTextureBuffer lockBuff, uint32_t writeFlags = 0) final;
 	bool isSingleBuffered() const;
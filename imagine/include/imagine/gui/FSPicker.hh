@@ -23,6 +23,9 @@
 #include <imagine/gui/ViewStack.hh>
 #include <imagine/util/DelegateFunc.hh>
 #include <imagine/util/string/CStringView.hh>
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
 #include <system_error>
 
@@ -47,6 +50,7 @@ public:
 
 	FSPicker(ViewAttachParams attach, Gfx::TextureSpan backRes, Gfx::TextureSpan closeRes,
 			FilterFunc filter = {}, Mode mode = Mode::FILE, Gfx::GlyphTextureSet *face = {});
+	~FSPicker();
 	void place() override;
 	bool inputEvent(const Input::Event &) override;
 	void prepareDraw() override;
@@ -58,6 +62,10 @@ public:
 	void onLeftNavBtn(const Input::Event &);
 	void onRightNavBtn(const Input::Event &);
 	void setEmptyPath();
+	// Directories are listed on a separate thread, filtered with FilterFunc there, and
+	// merged into the table in sorted batches. The sorted result is cached so revisiting
+	// a recent directory shows it immediately while it's listed again to pick up changes.
+	// Errors found while listing are shown in the view instead of returned.
 	std::error_code setPath(IG::CStringView path, FS::RootPathInfo, const Input::Event &);
 	std::error_code setPath(IG::CStringView path, FS::RootPathInfo);
 	std::error_code setPath(IG::CStringView path, const Input::Event &);
@@ -70,6 +78,17 @@ public:
 	void pushFileLocationsView(const Input::Event &);
 	void setShowHiddenFiles(bool);
 
+	struct FileRecord
+	{
+		std::string path{};
+		std::string name{};
+		bool isDir{};
+
+		bool operator==(const FileRecord &) const = default;
+	};
+
+	struct DirectoryListing;
+
 protected:
 	struct FileEntry
 	{
@@ -84,12 +103,24 @@ protected:
 	OnSelectFileDelegate onSelectFile_{};
 	OnCloseDelegate onClose_;
 	std::vector<FileEntry> dir{};
+	std::shared_ptr<DirectoryListing> listing{};
+	std::vector<FileRecord> listedRecords{};
 	FS::RootedPath root{};
 	Gfx::Text msgText{};
 	Mode mode_{};
 	bool showHiddenFiles_{};
+	bool usingCachedRecords{};
+	bool highlightFirstCell{};
+	bool closeWhenListed{};
 
 	std::error_code changeDirByInput(IG::CStringView path, FS::RootPathInfo, const Input::Event &);
+	void startListing(IG::CStringView path);
+	void cancelListing();
+	void onListingUpdate();
+	void addRecords(std::span<FileRecord>);
+	void setRecords(std::span<const FileRecord>);
+	void updateEmptyMessage(std::error_code);
+	void onSelectEntry(size_t idx, const Input::Event &);
 	bool isAtRoot() const;
 	Gfx::GlyphTextureSet &face();
 	TableView &fileTableView();
@@ -20,6 +20,7 @@
 #include <imagine/gfx/defs.hh>
 #include <imagine/gui/ScrollView.hh>
 #include <iterator>
+#include <utility>
 
 namespace IG::Input
 {
@@ -64,6 +65,8 @@ public:
 	void draw(Gfx::RendererCommands &cmds) override;
 	void place() override;
 	void setScrollableIfNeeded(bool yes);
+	// lay out item text only when a cell becomes visible, for tables with many items
+	void setCompileVisibleCellsOnly(bool on);
 	void scrollToFocusRect();
 	void resetScroll();
 	bool inputEvent(const Input::Event &) override;
@@ -88,12 +91,15 @@ protected:
 	int yCellSize = 0;
 	int selected = -1;
 	int visibleCells = 0;
+	std::pair<int, int> compiledCells{}; // [start, end) cells compiled since the last place()
 	_2DOrigin align{LC2DO};
 	bool onlyScrollIfNeeded = false;
+	bool compileVisibleCellsOnly = false;
 	bool selectedIsActivated = false;
 	bool hasFocus = true;
 
 	void setYCellSize(int s);
+	void compileVisibleCells(int cells);
 	IG::WindowRect focusRect();
 	void onSelectElement(const Input::Event &, size_t i, MenuItem &);
 	bool elementIsSelectable(MenuItem &item);
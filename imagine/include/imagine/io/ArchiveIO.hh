@@ -95,15 +95,29 @@ public:
 	ArchiveIO(ArchiveEntry entry);
 	ArchiveEntry releaseArchive();
 	std::string_view name() const;
+	uint32_t crc32() const;
+	// Keep decompressed data in a spill buffer so seeks in any direction don't restart
+	// decompression, only decompressing up to the furthest offset accessed so far.
+	// The buffer is a file created in spillDir & mapped into memory, or anonymous
+	// memory if spillDir is empty or the file can't be created. Call before reading.
+	bool setRandomAccess(IG::CStringView spillDir = "");
+	bool isRandomAccess() const { return (bool)spillBuff; }
 	ssize_t read(void *buff, size_t bytes) final;
+	ssize_t readAtPos(void *buff, size_t bytes, off_t offset) final;
 	ssize_t write(const void *buff, size_t bytes) final;
 	off_t seek(off_t offset, SeekMode mode) final;
+	std::span<uint8_t> map() final;
 	size_t size() final;
 	bool eof() final;
 	explicit operator bool() const final;
 
 protected:
 	ArchiveEntry entry{};
+	IG::ByteBuffer spillBuff{};
+	size_t decodedBytes{};
+	off_t spillPos{};
+
+	bool decodeTo(size_t offset);
 };
 
 }
@@ -16,6 +16,13 @@ typedef uint8_t LoggerSeverity;
 CLINK void logger_setLogDirectoryPrefix(const char *dirStr) __attribute__((cold));
 CLINK void logger_setEnabled(bool enable);
 CLINK bool logger_isEnabled();
+// when set, messages are queued per-thread & written by a background thread
+CLINK void logger_setAsync(bool async);
+CLINK bool logger_isAsync();
+// writes any queued messages before returning
+CLINK void logger_flush();
+// number of queued messages lost because a thread's queue was full
+CLINK uint32_t logger_droppedMessages();
 CLINK void logger_printf(LoggerSeverity severity, const char* msg, ...) __attribute__((format (printf, 2, 3)));
 CLINK void logger_vprintf(LoggerSeverity severity, const char* msg, va_list arg);
 
@@ -20,6 +20,7 @@
 #include <imagine/util/rectangle2.h>
 #include <imagine/util/algorithm.h>
 #include <imagine/util/container/array.hh>
+#include <span>
 
 namespace IG
 {
@@ -113,6 +114,13 @@ public:
 	void write(Pixmap pixmap, WP destPos);
 	void writeConverted(Pixmap pixmap);
 	void writeConverted(Pixmap pixmap, WP destPos);
+	// name of the instruction set used by writeConverted() for RGB565, RGBA8888, BGRA8888 & I8
+	static const char *convertSIMDName();
+	// Converts an 8 or 16-bit indexed pixmap with a palette that has an entry for every index used.
+	// Uses SIMD table lookups when available, palettes of 16 entries or less are the fastest.
+	void writeLookup(std::span<const uint16_t> palette, Pixmap pixmap);
+	void writeLookup(std::span<const uint32_t> palette, Pixmap pixmap);
+	static const char *lookupSIMDName();
 	void clear(WP pos, WP size);
 	void clear();
 
@@ -0,0 +1,134 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/thread/Semaphore.hh>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <thread>
+
+namespace IG
+{
+
+static inline void cpuRelax()
+{
+	#if defined __i386__ || defined __x86_64__
+	__builtin_ia32_pause();
+	#elif defined __aarch64__ || (defined __arm__ && __ARM_ARCH >= 7)
+	asm volatile("yield");
+	#endif
+}
+
+// Lock-free message queue between exactly one sending and one receiving thread.
+// The receiver spins briefly when empty, then parks on a semaphore that the
+// sender only signals if the receiver is actually parked, so the common path
+// avoids system calls entirely.
+template<class MsgType, unsigned capacity = 8>
+class SPSCMessagePort
+{
+public:
+	static_assert(std::has_single_bit(capacity), "capacity must be a power of 2");
+
+	constexpr SPSCMessagePort(unsigned spinIterations = 2048):
+		spinIterations{spinIterations} {}
+
+	void send(MsgType msg)
+	{
+		auto w = writeIdx.load(std::memory_order_relaxed);
+		while(w - readIdx.load(std::memory_order_acquire) == capacity) [[unlikely]]
+		{
+			// receiver fell behind, rare since senders usually await a reply
+			std::this_thread::yield();
+		}
+		msgs[w % capacity] = msg;
+		writeIdx.store(w + 1, std::memory_order_seq_cst);
+		if(receiverParked.load(std::memory_order_seq_cst) && receiverParked.exchange(false))
+			parkSem.release();
+	}
+
+	void send(MsgType msg, bool awaitReply)
+	{
+		if(awaitReply)
+		{
+			std::binary_semaphore replySemaphore{0};
+			send(msg, &replySemaphore);
+		}
+		else
+		{
+			send(msg);
+		}
+	}
+
+	void send(MsgType msg, std::binary_semaphore *semPtr)
+	{
+		if(semPtr)
+		{
+			msg.setReplySemaphore(semPtr);
+			send(msg);
+			semPtr->acquire();
+		}
+		else
+		{
+			send(msg);
+		}
+	}
+
+	// blocks until a message is available
+	MsgType receive()
+	{
+		auto r = readIdx.load(std::memory_order_relaxed);
+		for(unsigned spins = 0; writeIdx.load(std::memory_order_acquire) == r;)
+		{
+			if(spins < spinIterations)
+			{
+				spins++;
+				cpuRelax();
+				continue;
+			}
+			park(r);
+		}
+		auto msg = msgs[r % capacity];
+		readIdx.store(r + 1, std::memory_order_release);
+		return msg;
+	}
+
+	bool empty() const
+	{
+		return writeIdx.load(std::memory_order_acquire) == readIdx.load(std::memory_order_relaxed);
+	}
+
+protected:
+	std::array<MsgType, capacity> msgs{};
+	alignas(64) std::atomic_uint writeIdx{};
+	alignas(64) std::atomic_uint readIdx{};
+	std::atomic_bool receiverParked{};
+	std::binary_semaphore parkSem{0};
+	unsigned spinIterations;
+
+	void park(unsigned r)
+	{
+		receiverParked.store(true, std::memory_order_seq_cst);
+		if(writeIdx.load(std::memory_order_seq_cst) != r && receiverParked.exchange(false))
+		{
+			// message arrived before the sender saw the flag, no wake-up pending
+			return;
+		}
+		parkSem.acquire();
+	}
+};
+
+}
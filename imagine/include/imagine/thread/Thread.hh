@@ -93,8 +93,57 @@ using ThreadId = pid_t;
 using ThreadId = uint64_t;
 #endif
 
+using CPUMask = uint64_t; // bit N selects CPU N
+
+enum class ThreadPolicy : uint8_t
+{
+	DEFAULT,     // time-shared using the nice level
+	FIFO,        // real-time, runs until it blocks or a higher priority thread is ready
+	ROUND_ROBIN, // real-time, time-sliced between threads of the same priority
+};
+
+struct ThreadAttributes
+{
+	CPUMask cpuMask{}; // 0 allows all CPUs
+	int nice{}; // also used if a real-time policy can't be set
+	ThreadPolicy policy{};
+	int realTimePriority{1}; // 1 - 99, only used with the real-time policies
+
+	constexpr bool operator ==(ThreadAttributes const &) const = default;
+};
+
 void setThisThreadPriority(int nice);
 int thisThreadPriority();
 ThreadId thisThreadId();
+// Returns false if any attribute couldn't be set, real-time policies
+// usually need elevated privileges. Only supported on Linux.
+bool setThreadAttributes(ThreadId, ThreadAttributes);
+bool setThisThreadAttributes(ThreadAttributes);
+CPUMask threadCPUAffinity(ThreadId);
+int thisThreadCPU();
+unsigned cpuCount();
+// CPUs with the highest & lowest maximum frequency, the same set on symmetric CPUs
+CPUMask performanceCPUMask();
+CPUMask efficiencyCPUMask();
+
+static std::thread makeThreadSync(ThreadAttributes attrs, IG::invocable<std::binary_semaphore&> auto &&f)
+{
+	return makeThreadSync(
+		[attrs, f{IG_forward(f)}](std::binary_semaphore &sem)
+		{
+			setThisThreadAttributes(attrs);
+			f(sem);
+		});
+}
+
+static void makeDetachedThread(ThreadAttributes attrs, IG::invocable auto &&f)
+{
+	makeDetachedThread(
+		[attrs, f{IG_forward(f)}]()
+		{
+			setThisThreadAttributes(attrs);
+			f();
+		});
+}
 
 }
@@ -18,16 +18,28 @@
 #include <imagine/util/algorithm.h>
 #include <imagine/util/math/math.hh>
 #include <cmath>
+#if defined __SSE2__
+#include <immintrin.h>
+#define IG_AUDIO_FORMAT_X86
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define IG_AUDIO_FORMAT_NEON
+#endif
 
 namespace IG::Audio
 {
 
+// Each kernel converts a run of samples scaled by the volume, src & dest never overlap.
+// Conversions to int16 saturate instead of wrapping when the volume boosts past full scale.
+template <class Src, class Dest>
+using SampleFunc = Dest*(*)(Dest * __restrict__ dest, unsigned samples, const Src * __restrict__ src, float volume);
+
 static int16_t clamp16FromFloat(float x)
 {
-	return IG::clampFromFloat<int16_t>(x);
+	return IG::clampFromFloat<int16_t>(x, 16);
 }
 
-static float *convertI16SamplesToFloat(float * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+static float *convertI16SamplesToFloatScalar(float * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
 {
 	return transformN(src, samples, dest,
 		[=](int16_t s)
@@ -36,7 +48,7 @@ static float *convertI16SamplesToFloat(float * __restrict__ dest, unsigned sampl
 		});
 }
 
-static int16_t *convertFloatSamplesToI16(int16_t * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+static int16_t *convertFloatSamplesToI16Scalar(int16_t * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
 {
 	return transformN(src, samples, dest,
 		[=](float s)
@@ -45,6 +57,265 @@ static int16_t *convertFloatSamplesToI16(int16_t * __restrict__ dest, unsigned s
 		});
 }
 
+static int16_t *scaleI16SamplesScalar(int16_t * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+{
+	return transformN(src, samples, dest,
+		[=](int16_t s)
+		{
+			return clamp16FromFloat((s / 32768.f) * volume);
+		});
+}
+
+static float *scaleFloatSamplesScalar(float * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+{
+	return transformN(src, samples, dest,
+		[=](float s)
+		{
+			return s * volume;
+		});
+}
+
+#if defined IG_AUDIO_FORMAT_X86
+
+// sign extend by placing each sample in the upper half & shifting back down
+static __m128 loadI16LoSSE2(__m128i s) { return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)); }
+static __m128 loadI16HiSSE2(__m128i s) { return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16)); }
+
+// values outside the int32 range convert to INT32_MIN, so clamp to the int16 range first,
+// the pack then can't saturate but keeps the int32 -> int16 narrowing in one instruction
+static __m128i packI16SSE2(__m128 lo, __m128 hi)
+{
+	const auto minVal = _mm_set1_ps(-32768.f);
+	const auto maxVal = _mm_set1_ps(32767.f);
+	lo = _mm_min_ps(_mm_max_ps(lo, minVal), maxVal);
+	hi = _mm_min_ps(_mm_max_ps(hi, minVal), maxVal);
+	return _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+}
+
+static float *convertI16SamplesToFloatSSE2(float * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+{
+	const auto scale = _mm_set1_ps(volume / 32768.f);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto s = _mm_loadu_si128((const __m128i*)(src + i));
+		_mm_storeu_ps(dest + i, _mm_mul_ps(loadI16LoSSE2(s), scale));
+		_mm_storeu_ps(dest + i + 4, _mm_mul_ps(loadI16HiSSE2(s), scale));
+	}
+	return convertI16SamplesToFloatScalar(dest + i, samples - i, src + i, volume);
+}
+
+static int16_t *convertFloatSamplesToI16SSE2(int16_t * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+{
+	const auto scale = _mm_set1_ps(volume * 32768.f);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto lo = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+		auto hi = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+		_mm_storeu_si128((__m128i*)(dest + i), packI16SSE2(lo, hi));
+	}
+	return convertFloatSamplesToI16Scalar(dest + i, samples - i, src + i, volume);
+}
+
+static int16_t *scaleI16SamplesSSE2(int16_t * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+{
+	const auto scale = _mm_set1_ps(volume);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto s = _mm_loadu_si128((const __m128i*)(src + i));
+		auto lo = _mm_mul_ps(loadI16LoSSE2(s), scale);
+		auto hi = _mm_mul_ps(loadI16HiSSE2(s), scale);
+		_mm_storeu_si128((__m128i*)(dest + i), packI16SSE2(lo, hi));
+	}
+	return scaleI16SamplesScalar(dest + i, samples - i, src + i, volume);
+}
+
+static float *scaleFloatSamplesSSE2(float * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+{
+	const auto scale = _mm_set1_ps(volume);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(src + i), scale));
+		_mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale));
+	}
+	return scaleFloatSamplesScalar(dest + i, samples - i, src + i, volume);
+}
+
+[[gnu::target("avx2")]]
+static __m256 loadI16AVX2(const int16_t *src)
+{
+	return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)src)));
+}
+
+// packs work within 128-bit lanes, reorder the 64-bit blocks afterwards
+[[gnu::target("avx2")]]
+static __m256i packI16AVX2(__m256 lo, __m256 hi)
+{
+	const auto minVal = _mm256_set1_ps(-32768.f);
+	const auto maxVal = _mm256_set1_ps(32767.f);
+	lo = _mm256_min_ps(_mm256_max_ps(lo, minVal), maxVal);
+	hi = _mm256_min_ps(_mm256_max_ps(hi, minVal), maxVal);
+	auto s = _mm256_packs_epi32(_mm256_cvtps_epi32(lo), _mm256_cvtps_epi32(hi));
+	return _mm256_permute4x64_epi64(s, 0b11011000);
+}
+
+[[gnu::target("avx2")]]
+static float *convertI16SamplesToFloatAVX2(float * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+{
+	const auto scale = _mm256_set1_ps(volume / 32768.f);
+	unsigned i = 0;
+	for(; i + 16 <= samples; i += 16)
+	{
+		_mm256_storeu_ps(dest + i, _mm256_mul_ps(loadI16AVX2(src + i), scale));
+		_mm256_storeu_ps(dest + i + 8, _mm256_mul_ps(loadI16AVX2(src + i + 8), scale));
+	}
+	return convertI16SamplesToFloatScalar(dest + i, samples - i, src + i, volume);
+}
+
+[[gnu::target("avx2")]]
+static int16_t *convertFloatSamplesToI16AVX2(int16_t * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+{
+	const auto scale = _mm256_set1_ps(volume * 32768.f);
+	unsigned i = 0;
+	for(; i + 16 <= samples; i += 16)
+	{
+		auto lo = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+		auto hi = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale);
+		_mm256_storeu_si256((__m256i*)(dest + i), packI16AVX2(lo, hi));
+	}
+	return convertFloatSamplesToI16Scalar(dest + i, samples - i, src + i, volume);
+}
+
+[[gnu::target("avx2")]]
+static int16_t *scaleI16SamplesAVX2(int16_t * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+{
+	const auto scale = _mm256_set1_ps(volume);
+	unsigned i = 0;
+	for(; i + 16 <= samples; i += 16)
+	{
+		auto lo = _mm256_mul_ps(loadI16AVX2(src + i), scale);
+		auto hi = _mm256_mul_ps(loadI16AVX2(src + i + 8), scale);
+		_mm256_storeu_si256((__m256i*)(dest + i), packI16AVX2(lo, hi));
+	}
+	return scaleI16SamplesScalar(dest + i, samples - i, src + i, volume);
+}
+
+[[gnu::target("avx2")]]
+static float *scaleFloatSamplesAVX2(float * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+{
+	const auto scale = _mm256_set1_ps(volume);
+	unsigned i = 0;
+	for(; i + 16 <= samples; i += 16)
+	{
+		_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), scale));
+		_mm256_storeu_ps(dest + i + 8, _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale));
+	}
+	return scaleFloatSamplesScalar(dest + i, samples - i, src + i, volume);
+}
+
+static bool cpuHasAVX2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+static const bool hasAVX2 = cpuHasAVX2();
+
+static const SampleFunc<int16_t, float> convertI16SamplesToFloat =
+	hasAVX2 ? convertI16SamplesToFloatAVX2 : convertI16SamplesToFloatSSE2;
+static const SampleFunc<float, int16_t> convertFloatSamplesToI16 =
+	hasAVX2 ? convertFloatSamplesToI16AVX2 : convertFloatSamplesToI16SSE2;
+static const SampleFunc<int16_t, int16_t> scaleI16Samples =
+	hasAVX2 ? scaleI16SamplesAVX2 : scaleI16SamplesSSE2;
+static const SampleFunc<float, float> scaleFloatSamples =
+	hasAVX2 ? scaleFloatSamplesAVX2 : scaleFloatSamplesSSE2;
+
+const char *Format::simdName() { return hasAVX2 ? "AVX2" : "SSE2"; }
+
+#elif defined IG_AUDIO_FORMAT_NEON
+
+// rounds to nearest by adding 0.5 with the sign of the value before the truncating conversion,
+// which saturates to int32, then narrowing saturates to int16
+static int16x8_t packI16NEON(float32x4_t lo, float32x4_t hi)
+{
+	auto round = [](float32x4_t x)
+	{
+		auto sign = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000));
+		auto half = vreinterpretq_f32_u32(vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(.5f))));
+		return vcvtq_s32_f32(vaddq_f32(x, half));
+	};
+	return vcombine_s16(vqmovn_s32(round(lo)), vqmovn_s32(round(hi)));
+}
+
+static float32x4_t loadI16LoNEON(int16x8_t s) { return vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))); }
+static float32x4_t loadI16HiNEON(int16x8_t s) { return vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))); }
+
+static float *convertI16SamplesToFloat(float * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+{
+	const auto scale = vdupq_n_f32(volume / 32768.f);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto s = vld1q_s16(src + i);
+		vst1q_f32(dest + i, vmulq_f32(loadI16LoNEON(s), scale));
+		vst1q_f32(dest + i + 4, vmulq_f32(loadI16HiNEON(s), scale));
+	}
+	return convertI16SamplesToFloatScalar(dest + i, samples - i, src + i, volume);
+}
+
+static int16_t *convertFloatSamplesToI16(int16_t * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+{
+	const auto scale = vdupq_n_f32(volume * 32768.f);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto lo = vmulq_f32(vld1q_f32(src + i), scale);
+		auto hi = vmulq_f32(vld1q_f32(src + i + 4), scale);
+		vst1q_s16(dest + i, packI16NEON(lo, hi));
+	}
+	return convertFloatSamplesToI16Scalar(dest + i, samples - i, src + i, volume);
+}
+
+static int16_t *scaleI16Samples(int16_t * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
+{
+	const auto scale = vdupq_n_f32(volume);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto s = vld1q_s16(src + i);
+		vst1q_s16(dest + i, packI16NEON(vmulq_f32(loadI16LoNEON(s), scale), vmulq_f32(loadI16HiNEON(s), scale)));
+	}
+	return scaleI16SamplesScalar(dest + i, samples - i, src + i, volume);
+}
+
+static float *scaleFloatSamples(float * __restrict__ dest, unsigned samples, const float * __restrict__ src, float volume)
+{
+	const auto scale = vdupq_n_f32(volume);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		vst1q_f32(dest + i, vmulq_f32(vld1q_f32(src + i), scale));
+		vst1q_f32(dest + i + 4, vmulq_f32(vld1q_f32(src + i + 4), scale));
+	}
+	return scaleFloatSamplesScalar(dest + i, samples - i, src + i, volume);
+}
+
+const char *Format::simdName() { return "NEON"; }
+
+#else
+
+static const SampleFunc<int16_t, float> convertI16SamplesToFloat = convertI16SamplesToFloatScalar;
+static const SampleFunc<float, int16_t> convertFloatSamplesToI16 = convertFloatSamplesToI16Scalar;
+static const SampleFunc<int16_t, int16_t> scaleI16Samples = scaleI16SamplesScalar;
+static const SampleFunc<float, float> scaleFloatSamples = scaleFloatSamplesScalar;
+
+const char *Format::simdName() { return "Scalar"; }
+
+#endif
+
 static int16_t *copyI16Samples(int16_t * __restrict__ dest, unsigned samples, const int16_t * __restrict__ src, float volume)
 {
 	if(volume == 1.f)
@@ -53,11 +324,7 @@ static int16_t *copyI16Samples(int16_t * __restrict__ dest, unsigned samples, co
 	}
 	else
 	{
-		return transformN(src, samples, dest,
-			[=](int16_t s)
-			{
-				return clamp16FromFloat((s / 32768.f) * volume);
-			});
+		return scaleI16Samples(dest, samples, src, volume);
 	}
 }
 
@@ -69,11 +336,7 @@ static float *copyFloatSamples(float * __restrict__ dest, unsigned samples, cons
 	}
 	else
 	{
-		return transformN(src, samples, dest,
-			[=](float s)
-			{
-				return s * volume;
-			});
+		return scaleFloatSamples(dest, samples, src, volume);
 	}
 }
 
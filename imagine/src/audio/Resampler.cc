@@ -0,0 +1,499 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Resampler"
+#include <imagine/audio/Resampler.hh>
+#include <imagine/util/utility.h>
+#include <imagine/util/math/math.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#if defined __SSE2__
+#include <immintrin.h>
+#define IG_RESAMPLER_X86
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define IG_RESAMPLER_NEON
+#endif
+
+namespace IG::Audio
+{
+
+// Filter kernels process taps * channels coefficients per output frame, always a
+// multiple of 8 so no kernel needs a remainder loop
+static constexpr unsigned kernelAlign = 8;
+static constexpr unsigned maxTapMultiplier = 8;
+
+static constexpr unsigned baseTaps(ResamplerQuality q)
+{
+	return q == ResamplerQuality::HIGH ? 32 : 8;
+}
+
+static constexpr unsigned phases(ResamplerQuality q)
+{
+	return q == ResamplerQuality::HIGH ? 64 : 32;
+}
+
+// output lags the input by half the widest filter of the quality level, so the stream
+// stays aligned when the tap count changes with the ratio
+static constexpr unsigned delayFrames(ResamplerQuality q)
+{
+	return baseTaps(q) * maxTapMultiplier / 2;
+}
+
+// keep enough frames between calls for the widest filter centered at the largest delay
+static constexpr unsigned historyFrames = baseTaps(ResamplerQuality::HIGH) * maxTapMultiplier;
+
+struct FilterPos
+{
+	uint32_t frame; // first input frame used by the filter, offset by one
+	uint32_t phase;
+};
+
+static FilterPos filterPos(uint32_t i, double ratio, uint32_t phases)
+{
+	// destination frames are spaced evenly from the block start, and since destFrames * ratio == srcFrames
+	// the next block's first frame lands one step after this block's last frame
+	double pos = i * ratio;
+	auto base = uint32_t(pos);
+	auto phase = uint32_t(std::lround((pos - base) * phases));
+	if(phase == phases)
+	{
+		base++;
+		phase = 0;
+	}
+	return {base + 1, phase};
+}
+
+struct FilterParams
+{
+	float *out;
+	const float *in;
+	const float *coeffs;
+	uint32_t destFrames;
+	uint32_t phases;
+	unsigned taps;
+	unsigned channels;
+	double ratio;
+};
+
+using FilterFunc = void(*)(const FilterParams &);
+using ConvertToFloatFunc = void(*)(float * __restrict__ dest, const int16_t * __restrict__ src, unsigned samples);
+using ConvertFromFloatFunc = void(*)(int16_t * __restrict__ dest, const float * __restrict__ src, unsigned samples);
+
+static void convertI16ToFloatScalar(float * __restrict__ dest, const int16_t * __restrict__ src, unsigned samples)
+{
+	for(unsigned i = 0; i < samples; i++)
+	{
+		dest[i] = src[i] * (1.f / 32768.f);
+	}
+}
+
+static void convertFloatToI16Scalar(int16_t * __restrict__ dest, const float * __restrict__ src, unsigned samples)
+{
+	for(unsigned i = 0; i < samples; i++)
+	{
+		dest[i] = IG::clampFromFloat<int16_t>(src[i], 16);
+	}
+}
+
+static void filterScalar(const FilterParams &p)
+{
+	const unsigned n = p.taps * p.channels;
+	for(uint32_t i = 0; i < p.destFrames; i++)
+	{
+		auto [frame, phase] = filterPos(i, p.ratio, p.phases);
+		auto in = p.in + frame * p.channels;
+		auto c = p.coeffs + phase * n;
+		auto out = p.out + i * p.channels;
+		if(p.channels == 1)
+		{
+			float acc[4]{};
+			for(unsigned t = 0; t < n; t += 4)
+			{
+				acc[0] += in[t] * c[t];
+				acc[1] += in[t + 1] * c[t + 1];
+				acc[2] += in[t + 2] * c[t + 2];
+				acc[3] += in[t + 3] * c[t + 3];
+			}
+			out[0] = (acc[0] + acc[2]) + (acc[1] + acc[3]);
+		}
+		else
+		{
+			float acc[4]{};
+			for(unsigned t = 0; t < n; t += 4)
+			{
+				acc[0] += in[t] * c[t];
+				acc[1] += in[t + 1] * c[t + 1];
+				acc[2] += in[t + 2] * c[t + 2];
+				acc[3] += in[t + 3] * c[t + 3];
+			}
+			out[0] = acc[0] + acc[2];
+			out[1] = acc[1] + acc[3];
+		}
+	}
+}
+
+#if defined IG_RESAMPLER_X86
+
+// lanes alternate L/R for stereo so the even lanes sum to left & the odd lanes to right
+static void storeSSE(__m128 acc, float *out, unsigned channels)
+{
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	if(channels == 1)
+	{
+		acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+		_mm_store_ss(out, acc);
+	}
+	else
+	{
+		_mm_storel_pi((__m64*)out, acc);
+	}
+}
+
+static void filterSSE2(const FilterParams &p)
+{
+	const unsigned n = p.taps * p.channels;
+	for(uint32_t i = 0; i < p.destFrames; i++)
+	{
+		auto [frame, phase] = filterPos(i, p.ratio, p.phases);
+		auto in = p.in + frame * p.channels;
+		auto c = p.coeffs + phase * n;
+		auto acc0 = _mm_setzero_ps();
+		auto acc1 = _mm_setzero_ps();
+		for(unsigned t = 0; t < n; t += 8)
+		{
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(in + t), _mm_loadu_ps(c + t)));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(in + t + 4), _mm_loadu_ps(c + t + 4)));
+		}
+		storeSSE(_mm_add_ps(acc0, acc1), p.out + i * p.channels, p.channels);
+	}
+}
+
+[[gnu::target("avx2,fma")]]
+static void filterAVX2(const FilterParams &p)
+{
+	const unsigned n = p.taps * p.channels;
+	for(uint32_t i = 0; i < p.destFrames; i++)
+	{
+		auto [frame, phase] = filterPos(i, p.ratio, p.phases);
+		auto in = p.in + frame * p.channels;
+		auto c = p.coeffs + phase * n;
+		auto acc = _mm256_setzero_ps();
+		for(unsigned t = 0; t < n; t += 8)
+		{
+			acc = _mm256_fmadd_ps(_mm256_loadu_ps(in + t), _mm256_loadu_ps(c + t), acc);
+		}
+		auto acc4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+		storeSSE(acc4, p.out + i * p.channels, p.channels);
+	}
+}
+
+static void convertI16ToFloat(float * __restrict__ dest, const int16_t * __restrict__ src, unsigned samples)
+{
+	const auto scale = _mm_set1_ps(1.f / 32768.f);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto s = _mm_loadu_si128((const __m128i*)(src + i));
+		// sign extend by placing each sample in the upper half & shifting back down
+		auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+		auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+	convertI16ToFloatScalar(dest + i, src + i, samples - i);
+}
+
+static void convertFloatToI16(int16_t * __restrict__ dest, const float * __restrict__ src, unsigned samples)
+{
+	const auto scale = _mm_set1_ps(32768.f);
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		// values outside the int32 range convert to INT32_MIN, so clamp first
+		auto lo = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), scale);
+		auto hi = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), scale);
+		auto s = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+		_mm_storeu_si128((__m128i*)(dest + i), s);
+	}
+	convertFloatToI16Scalar(dest + i, src + i, samples - i);
+}
+
+static FilterFunc bestFilterFunc()
+{
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return filterAVX2;
+	return filterSSE2;
+}
+
+const char *Resampler::simdName()
+{
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? "AVX2" : "SSE2";
+}
+
+#elif defined IG_RESAMPLER_NEON
+
+static void storeNEON(float32x4_t acc, float *out, unsigned channels)
+{
+	auto acc2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+	if(channels == 1)
+		out[0] = vget_lane_f32(vpadd_f32(acc2, acc2), 0);
+	else
+		vst1_f32(out, acc2);
+}
+
+static void filterNEON(const FilterParams &p)
+{
+	const unsigned n = p.taps * p.channels;
+	for(uint32_t i = 0; i < p.destFrames; i++)
+	{
+		auto [frame, phase] = filterPos(i, p.ratio, p.phases);
+		auto in = p.in + frame * p.channels;
+		auto c = p.coeffs + phase * n;
+		auto acc0 = vdupq_n_f32(0);
+		auto acc1 = vdupq_n_f32(0);
+		for(unsigned t = 0; t < n; t += 8)
+		{
+			acc0 = vmlaq_f32(acc0, vld1q_f32(in + t), vld1q_f32(c + t));
+			acc1 = vmlaq_f32(acc1, vld1q_f32(in + t + 4), vld1q_f32(c + t + 4));
+		}
+		storeNEON(vaddq_f32(acc0, acc1), p.out + i * p.channels, p.channels);
+	}
+}
+
+static void convertI16ToFloat(float * __restrict__ dest, const int16_t * __restrict__ src, unsigned samples)
+{
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		auto s = vld1q_s16(src + i);
+		vst1q_f32(dest + i, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(s)), 15));
+		vst1q_f32(dest + i + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(s)), 15));
+	}
+	convertI16ToFloatScalar(dest + i, src + i, samples - i);
+}
+
+static void convertFloatToI16(int16_t * __restrict__ dest, const float * __restrict__ src, unsigned samples)
+{
+	unsigned i = 0;
+	for(; i + 8 <= samples; i += 8)
+	{
+		// fixed-point conversion saturates to int32, then narrowing saturates to int16
+		auto lo = vcvtq_n_s32_f32(vld1q_f32(src + i), 15);
+		auto hi = vcvtq_n_s32_f32(vld1q_f32(src + i + 4), 15);
+		vst1q_s16(dest + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+	}
+	convertFloatToI16Scalar(dest + i, src + i, samples - i);
+}
+
+static FilterFunc bestFilterFunc() { return filterNEON; }
+
+const char *Resampler::simdName() { return "NEON"; }
+
+#else
+
+static void convertI16ToFloat(float * __restrict__ dest, const int16_t * __restrict__ src, unsigned samples)
+{
+	convertI16ToFloatScalar(dest, src, samples);
+}
+
+static void convertFloatToI16(int16_t * __restrict__ dest, const float * __restrict__ src, unsigned samples)
+{
+	convertFloatToI16Scalar(dest, src, samples);
+}
+
+static FilterFunc bestFilterFunc() { return filterScalar; }
+
+const char *Resampler::simdName() { return "Scalar"; }
+
+#endif
+
+// kernels used by resample(), switched by setUseSIMD()
+static FilterFunc filterFunc = bestFilterFunc();
+static ConvertToFloatFunc convertToFloatFunc = convertI16ToFloat;
+static ConvertFromFloatFunc convertFromFloatFunc = convertFloatToI16;
+
+void Resampler::setUseSIMD(bool on)
+{
+	filterFunc = on ? bestFilterFunc() : filterScalar;
+	convertToFloatFunc = on ? convertI16ToFloat : convertI16ToFloatScalar;
+	convertFromFloatFunc = on ? convertFloatToI16 : convertFloatToI16Scalar;
+}
+
+template<class T>
+static void nearestResample(T * __restrict__ dest, uint32_t destFrames, const T * __restrict__ src, uint32_t srcFrames)
+{
+	double ratio = (double)srcFrames / destFrames;
+	for(uint32_t i = 0; i < destFrames; i++)
+	{
+		auto srcPos = std::min(uint32_t((i + 0.5) * ratio), srcFrames - 1);
+		dest[i] = src[srcPos];
+	}
+}
+
+static void nearestResample(void *dest, uint32_t destFrames, const void *src, uint32_t srcFrames, Format format)
+{
+	switch(format.bytesPerFrame())
+	{
+		case 2: return nearestResample((uint16_t*)dest, destFrames, (const uint16_t*)src, srcFrames);
+		case 4: return nearestResample((uint32_t*)dest, destFrames, (const uint32_t*)src, srcFrames);
+		case 8: return nearestResample((uint64_t*)dest, destFrames, (const uint64_t*)src, srcFrames);
+	}
+	bug_unreachable("bytes per frame == %u", format.bytesPerFrame());
+}
+
+void Resampler::setQuality(ResamplerQuality q)
+{
+	if(q == quality_)
+		return;
+	quality_ = q;
+	coeffs = {};
+	input = {};
+	output = {};
+	taps = 0;
+	hasHistory_ = false;
+}
+
+void Resampler::makeCoefficients(unsigned taps_, float cutoff_, unsigned channels)
+{
+	taps = taps_;
+	cutoff = cutoff_;
+	coeffChannels = channels;
+	const auto phaseCount = phases(quality_);
+	const unsigned n = taps * channels;
+	coeffs.resize(phaseCount * n);
+	const double half = taps / 2.;
+	constexpr double pi = std::numbers::pi;
+	for(unsigned p = 0; p < phaseCount; p++)
+	{
+		const double frac = double(p) / phaseCount;
+		auto c = &coeffs[p * n];
+		std::array<double, baseTaps(ResamplerQuality::HIGH) * maxTapMultiplier> h;
+		double sum{};
+		for(unsigned t = 0; t < taps; t++)
+		{
+			// distance from the output position in source frames, then windowed sinc with Blackman window
+			double d = t - half + 1. - frac;
+			double x = cutoff * d;
+			double sinc = x == 0. ? 1. : std::sin(pi * x) / (pi * x);
+			double w = std::abs(d) >= half ? 0. :
+				0.42 + 0.5 * std::cos(pi * d / half) + 0.08 * std::cos(2. * pi * d / half);
+			h[t] = sinc * w;
+			sum += h[t];
+		}
+		for(unsigned t = 0; t < taps; t++)
+		{
+			// normalize for unity gain at DC
+			for(unsigned ch = 0; ch < channels; ch++)
+			{
+				c[t * channels + ch] = h[t] / sum;
+			}
+		}
+	}
+	logMsg("made filter with %u taps, %u phases, cutoff:%.3f", taps, phaseCount, cutoff);
+}
+
+void Resampler::resample(void *dest, uint32_t destFrames, const void *src, uint32_t srcFrames, Format format)
+{
+	if(!destFrames)
+		return;
+	assumeExpr(format.channels == 1 || format.channels == 2);
+	if(!srcFrames) [[unlikely]]
+	{
+		std::memset(dest, 0, format.framesToBytes(destFrames));
+		return;
+	}
+	if(quality_ == ResamplerQuality::FAST)
+	{
+		if(destFrames == srcFrames)
+			std::memcpy(dest, src, format.framesToBytes(destFrames));
+		else
+			nearestResample(dest, destFrames, src, srcFrames, format);
+		return;
+	}
+	const unsigned channels = format.channels;
+	if(channels != historyChannels)
+	{
+		historyChannels = channels;
+		hasHistory_ = false;
+	}
+	if(destFrames == srcFrames && !hasHistory_)
+	{
+		std::memcpy(dest, src, format.framesToBytes(destFrames));
+		return;
+	}
+	const double ratio = (double)srcFrames / destFrames;
+	if(destFrames != srcFrames)
+	{
+		// widening the filter with the decimation ratio keeps the cost per source frame constant
+		const auto tapMultiplier = std::clamp(unsigned(std::lround(ratio)), 1u, maxTapMultiplier);
+		const unsigned wantedTaps = baseTaps(quality_) * tapMultiplier;
+		static_assert(baseTaps(ResamplerQuality::MEDIUM) % kernelAlign == 0);
+		// small rate corrections keep the full band since their aliasing is negligible,
+		// and with a cutoff of 1 the filter passes the input through unchanged at phase 0
+		const float wantedCutoff = std::min(1., (ratio < 1.1 ? 1. : 0.9) / ratio);
+		if(wantedTaps != taps || channels != coeffChannels || std::abs(wantedCutoff - cutoff) > cutoff * 0.02f)
+		{
+			makeCoefficients(wantedTaps, wantedCutoff, channels);
+		}
+	}
+	// the source frames follow the history, plus one frame the last phase rounding can reach with zero weight
+	input.resize((historyFrames + srcFrames + 1) * channels);
+	auto inputFrames = input.data() + historyFrames * channels;
+	if(format.sample.isFloat())
+		std::memcpy(inputFrames, src, srcFrames * channels * sizeof(float));
+	else
+		convertToFloatFunc(inputFrames, (const int16_t*)src, srcFrames * channels);
+	if(!hasHistory_)
+	{
+		// start a new stream as if its first frame was held
+		for(unsigned i = 0; i < historyFrames; i++)
+		{
+			std::memcpy(&input[i * channels], inputFrames, channels * sizeof(float));
+		}
+		hasHistory_ = true;
+	}
+	auto lastFrame = inputFrames + (srcFrames - 1) * channels;
+	std::memcpy(lastFrame + channels, lastFrame, channels * sizeof(float));
+	const unsigned delay = delayFrames(quality_);
+	float *out = (float*)dest;
+	if(!format.sample.isFloat())
+	{
+		output.resize(destFrames * channels);
+		out = output.data();
+	}
+	if(destFrames == srcFrames)
+	{
+		// same as filtering with a cutoff of 1 at phase 0
+		std::memcpy(out, inputFrames - delay * channels, destFrames * channels * sizeof(float));
+	}
+	else
+	{
+		// the filter for the frame at position 0 starts taps / 2 frames before the delayed position
+		filterFunc({out, inputFrames - (delay + taps / 2) * channels, coeffs.data(),
+			destFrames, phases(quality_), taps, channels, ratio});
+	}
+	if(!format.sample.isFloat())
+		convertFromFloatFunc((int16_t*)dest, output.data(), destFrames * channels);
+	// keep the newest frames as history for the next block
+	std::memmove(input.data(), input.data() + srcFrames * channels, historyFrames * channels * sizeof(float));
+}
+
+}
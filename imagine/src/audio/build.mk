@@ -1,6 +1,8 @@
 ifndef inc_audio
 inc_audio := 1
 
-SRC += audio/Format.cc
+SRC += \
+ audio/Format.cc \
+ audio/Resampler.cc
 
 endif
@@ -302,6 +302,11 @@ FileIO ApplicationContext::openFileUri(IG::CStringView uri, IODefs::OpenFlags op
 	return FS::formatLastWriteTimeLocal(uri);
 }
 
+[[gnu::weak]] FS::file_time_type ApplicationContext::fileUriLastWriteTime(IG::CStringView uri) const
+{
+	return FS::status(uri).lastWriteTime();
+}
+
 [[gnu::weak]] FS::FileString ApplicationContext::fileUriDisplayName(IG::CStringView uri) const
 {
 	return FS::displayName(uri);
@@ -28,6 +28,8 @@
 #endif
 #ifdef __linux__
 #include <sys/resource.h>
+#include <sched.h>
+#include <cstdio>
 #endif
 #ifdef __ANDROID__
 #include <android/log.h>
@@ -171,6 +173,159 @@ ThreadId thisThreadId()
 	#endif
 }
 
+#ifdef __linux__
+static int schedPolicy(ThreadPolicy policy)
+{
+	switch(policy)
+	{
+		case ThreadPolicy::FIFO: return SCHED_FIFO;
+		case ThreadPolicy::ROUND_ROBIN: return SCHED_RR;
+		default: return SCHED_OTHER;
+	}
+}
+#endif
+
+bool setThreadAttributes(ThreadId tid, ThreadAttributes attrs)
+{
+	#ifdef __linux__
+	bool success = true;
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	auto mask = attrs.cpuMask ? attrs.cpuMask : ~CPUMask{};
+	for(unsigned i = 0; i < std::min(cpuCount(), unsigned(CPU_SETSIZE)); i++)
+	{
+		if(i < 64 && (mask & (CPUMask{1} << i)))
+			CPU_SET(i, &cpuSet);
+	}
+	if(sched_setaffinity(tid, sizeof(cpuSet), &cpuSet) == -1)
+	{
+		logErr("error:%s setting thread:%d CPU mask:0x%llX", strerror(errno), tid, (unsigned long long)attrs.cpuMask);
+		success = false;
+	}
+	sched_param param{};
+	if(attrs.policy != ThreadPolicy::DEFAULT)
+		param.sched_priority = std::clamp(attrs.realTimePriority, 1, 99);
+	bool policySet = sched_setscheduler(tid, schedPolicy(attrs.policy), &param) != -1;
+	if(!policySet)
+	{
+		logErr("error:%s setting thread:%d policy:%d priority:%d", strerror(errno), tid,
+			schedPolicy(attrs.policy), param.sched_priority);
+		success = false;
+	}
+	// also used as a fallback when a real-time policy isn't permitted
+	if((attrs.policy == ThreadPolicy::DEFAULT || !policySet) && setpriority(PRIO_PROCESS, tid, attrs.nice) == -1)
+	{
+		logErr("error:%s setting thread:%d nice level:%d", strerror(errno), tid, attrs.nice);
+		success = false;
+	}
+	logMsg("set thread:%d CPU mask:0x%llX policy:%d priority:%d nice:%d", tid, (unsigned long long)attrs.cpuMask,
+		schedPolicy(attrs.policy), param.sched_priority, attrs.nice);
+	return success;
+	#else
+	return false;
+	#endif
+}
+
+bool setThisThreadAttributes(ThreadAttributes attrs)
+{
+	return setThreadAttributes(thisThreadId(), attrs);
+}
+
+CPUMask threadCPUAffinity(ThreadId tid)
+{
+	#ifdef __linux__
+	cpu_set_t cpuSet;
+	if(sched_getaffinity(tid, sizeof(cpuSet), &cpuSet) == -1)
+		return 0;
+	CPUMask mask{};
+	for(unsigned i = 0; i < 64; i++)
+	{
+		if(CPU_ISSET(i, &cpuSet))
+			mask |= CPUMask{1} << i;
+	}
+	return mask;
+	#else
+	return 0;
+	#endif
+}
+
+int thisThreadCPU()
+{
+	#ifdef __linux__
+	return sched_getcpu();
+	#else
+	return -1;
+	#endif
+}
+
+unsigned cpuCount()
+{
+	#if defined __unix__ || defined __APPLE__
+	return std::max(sysconf(_SC_NPROCESSORS_CONF), 1l);
+	#else
+	return std::max(std::thread::hardware_concurrency(), 1u);
+	#endif
+}
+
+#ifdef __linux__
+static unsigned cpuMaxFrequency(unsigned cpu)
+{
+	char path[80];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpufreq/cpuinfo_max_freq", cpu);
+	auto file = fopen(path, "r");
+	if(!file)
+		return 0;
+	unsigned freq{};
+	if(fscanf(file, "%u", &freq) != 1)
+		freq = 0;
+	fclose(file);
+	return freq;
+}
+
+template <class Compare>
+static CPUMask cpuMaskWithFrequency(Compare compare)
+{
+	std::array<unsigned, 64> freqs{};
+	auto cpus = std::min(cpuCount(), 64u);
+	unsigned bestFreq{};
+	for(unsigned i = 0; i < cpus; i++)
+	{
+		freqs[i] = cpuMaxFrequency(i);
+		if(!freqs[i])
+			continue;
+		if(!bestFreq || compare(freqs[i], bestFreq))
+			bestFreq = freqs[i];
+	}
+	if(!bestFreq) // frequencies unavailable, treat all CPUs the same
+		return cpus == 64 ? ~CPUMask{} : (CPUMask{1} << cpus) - 1;
+	CPUMask mask{};
+	for(unsigned i = 0; i < cpus; i++)
+	{
+		if(freqs[i] == bestFreq)
+			mask |= CPUMask{1} << i;
+	}
+	return mask;
+}
+#endif
+
+CPUMask performanceCPUMask()
+{
+	#ifdef __linux__
+	return cpuMaskWithFrequency(std::greater<unsigned>{});
+	#else
+	return 0;
+	#endif
+}
+
+CPUMask efficiencyCPUMask()
+{
+	#ifdef __linux__
+	return cpuMaskWithFrequency(std::less<unsigned>{});
+	#else
+	return 0;
+	#endif
+}
+
 }
 
 #if defined(__has_feature)
@@ -231,6 +386,7 @@ CLINK void bug_doExit(const char *msg, ...)
 	char str[256];
 	vsnprintf(str, sizeof(str), msg, args);
 	logErr("%s", str);
+	logger_flush();
 	__android_log_assert("", "imagine", "%s", str);
 	#else
 	va_list args;
@@ -238,6 +394,7 @@ CLINK void bug_doExit(const char *msg, ...)
 	logger_vprintf(LOG_E, msg, args);
 	va_end(args);
 	logger_printf(LOG_E, "\n");
+	logger_flush();
 	usleep(500000); // TODO: need a way to flush every type of log output
 	abort();
 	#endif
@@ -22,6 +22,7 @@
 #endif
 #include <errno.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <cstdlib>
 #include <cstring>
 #include <system_error>
@@ -365,4 +366,16 @@ bool rename(IG::CStringView oldPath, IG::CStringView newPath)
 	return true;
 }
 
+bool last_write_time(IG::CStringView path, file_time_type time)
+{
+	struct timespec times[2]{{0, UTIME_OMIT}, {time, 0}};
+	if(utimensat(AT_FDCWD, path, times, 0) == -1) [[unlikely]]
+	{
+		if(Config::DEBUG_BUILD)
+			logErr("utimensat(%s) error:%s", path.data(), strerror(errno));
+		return false;
+	}
+	return true;
+}
+
 }
@@ -15,6 +15,7 @@
 
 #include <imagine/gfx/GfxText.hh>
 #include <imagine/gfx/GfxSprite.hh>
+#include <imagine/gfx/GeomQuad.hh>
 #include <imagine/gfx/GlyphTextureSet.hh>
 #include <imagine/gfx/ProjectionPlane.hh>
 #include <imagine/gfx/Renderer.hh>
@@ -27,6 +28,44 @@
 namespace IG::Gfx
 {
 
+// Collects glyph quads until the atlas texture changes or the buffer fills,
+// so a whole text block usually draws in a single call
+struct Text::GlyphBatch
+{
+	static constexpr uint32_t MAX_QUADS = 128;
+	std::array<std::array<TexVertex, 4>, MAX_QUADS> quads;
+	uint32_t size{};
+	const Texture *texture{};
+
+	void add(RendererCommands &cmds, GCRect pos, TextureSpan glyph)
+	{
+		if(glyph.texture() != texture || size == MAX_QUADS)
+		{
+			flush(cmds);
+			texture = glyph.texture();
+		}
+		quads[size++] = makeTexVertArray(pos, glyph);
+	}
+
+	void flush(RendererCommands &cmds)
+	{
+		if(!size)
+			return;
+		static auto quadIdx = []()
+		{
+			std::array<std::array<VertexIndex, 6>, MAX_QUADS> idx;
+			iterateTimes(MAX_QUADS, i)
+			{
+				idx[i] = makeRectIndexArray(i);
+			}
+			return idx;
+		}();
+		cmds.setTexture(*texture);
+		drawQuads(cmds, quads.data(), size, quadIdx.data(), size);
+		size = 0;
+	}
+};
+
 Text::Text(GlyphTextureSet *face): Text{{}, face}
 {}
 
@@ -171,9 +210,7 @@ void Text::draw(RendererCommands &cmds, float xPos, float yPos, _2DOrigin o, Pro
 	//logMsg("drawing with origin: %s,%s", o.toString(o.x), o.toString(o.y));
 	cmds.setBlendMode(BLEND_MODE_ALPHA);
 	cmds.set(glyphCommonTextureSampler);
-	std::array<TexVertex, 4> vArr;
-	cmds.bindTempVertexBuffer();
-	TexVertex::bindAttribs(cmds, vArr.data());
+	GlyphBatch batch;
 	_2DOrigin align = o;
 	xPos = o.adjustX(xPos, xSize, LT2DO);
 	//logMsg("aligned to %f, converted to %d", Gfx::alignYToPixel(yPos), toIYPos(Gfx::alignYToPixel(yPos)));
@@ -198,7 +235,7 @@ void Text::draw(RendererCommands &cmds, float xPos, float yPos, _2DOrigin o, Pro
 			uint32_t charsToDraw = span.chars;
 			xPos = startingXPos(xLineSize);
 			//logMsg("line %d, %d chars", l, charsToDraw);
-			drawSpan(cmds, xPos, yPos, projP, std::u16string_view{s, charsToDraw}, vArr);
+			drawSpan(cmds, xPos, yPos, projP, std::u16string_view{s, charsToDraw}, batch);
 			s += charsToDraw;
 			yPos -= nominalHeight_;
 			yPos = projP.alignYToPixel(yPos);
@@ -209,8 +246,9 @@ void Text::draw(RendererCommands &cmds, float xPos, float yPos, _2DOrigin o, Pro
 		float xLineSize = xSize;
 		xPos = startingXPos(xLineSize);
 		//logMsg("line %d, %d chars", l, charsToDraw);
-		drawSpan(cmds, xPos, yPos, projP, std::u16string_view{textStr}, vArr);
+		drawSpan(cmds, xPos, yPos, projP, std::u16string_view{textStr}, batch);
 	}
+	batch.flush(cmds);
 }
 
 void Text::draw(RendererCommands &cmds, GP p, _2DOrigin o, ProjectionPlane projP) const
@@ -218,7 +256,7 @@ void Text::draw(RendererCommands &cmds, GP p, _2DOrigin o, ProjectionPlane projP
 	draw(cmds, p.x, p.y, o, projP);
 }
 
-void Text::drawSpan(RendererCommands &cmds, float xPos, float yPos, ProjectionPlane projP, std::u16string_view strView, std::array<TexVertex, 4> &vArr) const
+void Text::drawSpan(RendererCommands &cmds, float xPos, float yPos, ProjectionPlane projP, std::u16string_view strView, GlyphBatch &batch) const
 {
 	auto xViewLimit = projP.wHalf();
 	for(auto c : strView)
@@ -242,12 +280,7 @@ void Text::drawSpan(RendererCommands &cmds, float xPos, float yPos, ProjectionPl
 		float xSize = projP.unprojectXSize(gly->metrics.xSize);
 		auto x = xPos + projP.unprojectXSize(gly->metrics.xOffset);
 		auto y = yPos - projP.unprojectYSize(gly->metrics.ySize - gly->metrics.yOffset);
-		auto &glyph = gly->glyph();
-		vArr = makeTexVertArray({{x, y}, {x + xSize, y + projP.unprojectYSize(gly->metrics.ySize)}}, glyph);
-		cmds.vertexBufferData(vArr.data(), sizeof(vArr));
-		cmds.setTexture(glyph);
-		//logMsg("drawing");
-		cmds.drawPrimitives(Primitive::TRIANGLE_STRIP, 0, 4);
+		batch.add(cmds, {{x, y}, {x + xSize, y + projP.unprojectYSize(gly->metrics.ySize)}}, gly->glyph());
 		xPos += projP.unprojectXSize(gly->metrics.xAdvance);
 	}
 }
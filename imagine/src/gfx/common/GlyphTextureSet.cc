@@ -19,8 +19,12 @@
 #include <imagine/gfx/Renderer.hh>
 #include <imagine/gfx/GlyphTextureSet.hh>
 #include <imagine/data-type/image/PixmapSource.hh>
+#include <imagine/util/math/int.hh>
 #include <imagine/logger/logger.h>
+#include <algorithm>
 #include <cstdlib>
+#include <optional>
+#include <ranges>
 
 namespace IG::Gfx
 {
@@ -40,6 +44,12 @@ static constexpr uint32_t unicodeBmpUsedChars = unicodeBmpChars - unicodeBmpPriv
 
 static constexpr uint32_t glyphTableEntries = GlyphTextureSet::supportsUnicode ? unicodeBmpUsedChars : numDrawableAsciiChars;
 
+// atlas pages hold about 16 rows of 16 glyphs at the font's pixel height, within these limits
+static constexpr int minAtlasPageSize = 256;
+static constexpr int maxAtlasPageSize = 1024;
+// blank pixels between glyphs so linear filtering doesn't sample a neighbor
+static constexpr int atlasGlyphPadding = 1;
+
 static std::errc mapCharToTable(uint32_t c, uint32_t &tableIdx);
 
 static int charIsDrawableAscii(int c)
@@ -61,11 +71,12 @@ static int charIsDrawableUnicode(int c)
 
 void GlyphTextureSet::resetGlyphTable()
 {
-	if(!usedGlyphTableBits)
-		return;
-	logMsg("resetting glyph table");
+	// also clears failed glyph marks & pages left by a partial purge, even if no table is in use
+	if(atlasPages.size())
+		logMsg("resetting glyph table & %zu atlas pages", atlasPages.size());
 	usedGlyphTableBits = 0;
 	glyphTable.resetElements();
+	atlasPages.clear();
 }
 
 void GlyphTextureSet::freeCaches(uint32_t purgeBits)
@@ -91,13 +102,19 @@ void GlyphTextureSet::freeCaches(uint32_t purgeBits)
 					//logMsg( "%c not a known drawable character, skipping", c);
 					continue;
 				}
-				glyphTable[i].~GlyphEntry();
+				// the atlas space is reclaimed once no table has glyphs left
+				glyphTable[tableIdx] = {};
 			}
 			usedGlyphTableBits = IG::clearBits(usedGlyphTableBits, IG::bit(i));
 		}
 		tableBits >>= 1;
 		purgeBits >>= 1;
 	}
+	if(!usedGlyphTableBits)
+	{
+		// no glyph references the atlas pages anymore
+		resetGlyphTable();
+	}
 }
 
 GlyphTextureSet::GlyphTextureSet(Renderer &r, IG::Font font, IG::FontSettings set):
@@ -170,13 +187,97 @@ std::errc GlyphTextureSet::cacheChar(Renderer &r, int c, int tableIdx)
 		return ec;
 	}
 	//logMsg("setting up table entry %d", tableIdx);
+	auto glyphSpan = addToAtlas(r, res.image.pixmap());
+	if(!glyphSpan)
+	{
+		glyphTable[tableIdx].metrics.ySize = -1;
+		return std::errc::not_enough_memory;
+	}
 	glyphTable[tableIdx].metrics = res.metrics;
-	glyphTable[tableIdx].glyph_ = r.makePixmapTexture(res.image, &r.make(glyphCommonTextureSampler), false);
+	glyphTable[tableIdx].glyph_ = glyphSpan;
 	usedGlyphTableBits |= IG::bit((c >> 11) & 0x1F); // use upper 5 BMP plane bits to map in range 0-31
 	//logMsg("used table bits 0x%X", usedGlyphTableBits);
 	return {};
 }
 
+int GlyphTextureSet::atlasPageSize(IG::WP glyphSize) const
+{
+	int size = std::clamp(int(IG::roundUpPowOf2(unsigned(settings.pixelHeight()) * 16u)), minAtlasPageSize, maxAtlasPageSize);
+	// a glyph larger than the usual page gets a page of its own size
+	while(size < glyphSize.x + atlasGlyphPadding || size < glyphSize.y + atlasGlyphPadding)
+		size *= 2;
+	return size;
+}
+
+TextureSpan GlyphTextureSet::addToAtlas(Renderer &r, IG::Pixmap glyphPix)
+{
+	// empty glyphs still get a blank pixel so their entry counts as cached
+	IG::WP size{std::max(glyphPix.w(), 1), std::max(glyphPix.h(), 1)};
+	IG::WP paddedSize = size + atlasGlyphPadding;
+	auto findSpace = [&](GlyphAtlasPage &page) -> std::optional<IG::WP>
+	{
+		auto pageSize = page.texture.size(0);
+		if(page.texture.pixmapDesc().format() != glyphPix.format())
+			return {};
+		// use the shortest shelf the glyph fits in
+		GlyphAtlasPage::Shelf *bestShelf{};
+		for(auto &shelf : page.shelves)
+		{
+			if(shelf.height >= paddedSize.y && shelf.x + paddedSize.x <= pageSize.x
+				&& (!bestShelf || shelf.height < bestShelf->height))
+			{
+				bestShelf = &shelf;
+			}
+		}
+		// or start a new shelf if the glyph is much shorter than the ones available
+		if((!bestShelf || bestShelf->height > paddedSize.y * 2)
+			&& page.nextShelfY + paddedSize.y <= pageSize.y && paddedSize.x <= pageSize.x)
+		{
+			bestShelf = &page.shelves.emplace_back(page.nextShelfY, paddedSize.y);
+			page.nextShelfY += paddedSize.y;
+		}
+		if(!bestShelf)
+			return {};
+		IG::WP pos{bestShelf->x, bestShelf->y};
+		bestShelf->x += paddedSize.x;
+		return pos;
+	};
+	GlyphAtlasPage *page{};
+	std::optional<IG::WP> pos;
+	// newest pages are the most likely to have space
+	for(auto &p : atlasPages | std::views::reverse)
+	{
+		pos = findSpace(p);
+		if(pos)
+		{
+			page = &p;
+			break;
+		}
+	}
+	if(!pos)
+	{
+		auto pageSize = atlasPageSize(size);
+		TextureConfig conf{{{pageSize, pageSize}, glyphPix.format()}, &r.make(glyphCommonTextureSampler)};
+		auto tex = r.makePixmapTexture(conf);
+		if(!tex)
+		{
+			logErr("error making %dx%d glyph atlas page", pageSize, pageSize);
+			return {};
+		}
+		tex.clear(0);
+		page = &atlasPages.emplace_back(std::move(tex));
+		logMsg("made %dx%d glyph atlas page %zu", pageSize, pageSize, atlasPages.size());
+		pos = findSpace(*page);
+		assert(pos);
+	}
+	if(glyphPix.w() && glyphPix.h())
+		page->texture.write(0, glyphPix, *pos);
+	auto texSize = page->texture.size(0);
+	FRect uv{{pos->x / float(texSize.x), pos->y / float(texSize.y)},
+		{(pos->x + size.x) / float(texSize.x), (pos->y + size.y) / float(texSize.y)}};
+	return {&page->texture, uv};
+}
+
 static std::errc mapCharToTable(uint32_t c, uint32_t &tableIdx)
 {
 	if(GlyphTextureSet::supportsUnicode)
@@ -160,6 +160,17 @@ void PixmapBufferTexture::write(IG::Pixmap pixmap, uint32_t writeFlags)
 	writeAligned(pixmap, Texture::bestAlignment(pixmap), writeFlags);
 }
 
+bool PixmapBufferTexture::canWriteSubRegion() const
+{
+	return directTex && directTex->canWriteSubRegion();
+}
+
+void PixmapBufferTexture::writeSubRegion(IG::Pixmap pixmap, IG::WP destPos, uint32_t writeFlags)
+{
+	assumeExpr(directTex);
+	directTex->writeSubRegion(pixmap, destPos, writeFlags);
+}
+
 void PixmapBufferTexture::clear()
 {
 	auto lockBuff = lock(Texture::BUFFER_FLAG_CLEARED);
@@ -411,6 +422,22 @@ void GLTextureStorage::writeAligned(IG::Pixmap pixmap, uint8_t assumeAlign, uint
 	}
 }
 
+bool GLTextureStorage::canWriteSubRegion() const
+{
+	// uploads from the source pixmap skip the pixel buffers, leaving the texture as the only copy of the image
+	return renderer().support.hasUnpackRowLength;
+}
+
+void GLTextureStorage::writeSubRegion(IG::Pixmap pixmap, IG::WP destPos, uint32_t writeFlags)
+{
+	if(!texName()) [[unlikely]]
+	{
+		logErr("called writeSubRegion() on uninitialized texture");
+		return;
+	}
+	Texture::writeAligned(0, pixmap, destPos, Texture::bestAlignment(pixmap), writeFlags);
+}
+
 void GLTextureStorage::deinit()
 {
 	if(pbo)
@@ -521,6 +548,16 @@ void TextureBufferStorage::writeAligned(IG::Pixmap pixmap, uint8_t assumeAlign,
 	unlock(lockBuff);
 }
 
+bool TextureBufferStorage::canWriteSubRegion() const
+{
+	return false;
+}
+
+void TextureBufferStorage::writeSubRegion(IG::Pixmap, IG::WP, uint32_t)
+{
+	bug_unreachable("writeSubRegion() not supported by this texture storage");
+}
+
 bool TextureBufferStorage::isExternal() const
 {
 	return Config::Gfx::OPENGL_TEXTURE_TARGET_EXTERNAL && target() == GL_TEXTURE_EXTERNAL_OES;
@@ -72,7 +72,6 @@ void Renderer::initMainTask(Window *initialWindow, DrawableConfig drawableConfig
 		}
 		initialDrawable = (Drawable)winData(*initialWindow).drawable;
 	}
-	constexpr int DRAW_THREAD_PRIORITY = -4;
 	GLTaskConfig conf
 	{
 		.glManagerPtr = &glManager,
@@ -21,16 +21,74 @@
 #include <imagine/gui/NavView.hh>
 #include <imagine/fs/FS.hh>
 #include <imagine/base/ApplicationContext.hh>
+#include <imagine/base/CustomEvent.hh>
 #include <imagine/gfx/RendererCommands.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/time/Time.hh>
 #include <imagine/logger/logger.h>
 #include <imagine/util/math/int.hh>
 #include <imagine/util/format.hh>
 #include <imagine/util/string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <string>
 
 namespace IG
 {
 
+// State shared with a listing thread, which may outlive the picker after being canceled
+struct FSPicker::DirectoryListing
+{
+	std::mutex mutex{};
+	std::vector<FileRecord> records{}; // batch not yet merged by the main thread
+	std::error_code ec{};
+	bool done{};
+	std::atomic_bool canceled{};
+	CustomEvent recordsReady{"FSPicker::recordsReady"};
+};
+
+struct CachedListing
+{
+	FS::PathString path{};
+	FSPicker::FilterFunc filter{};
+	FSPicker::Mode mode{};
+	bool showHiddenFiles{};
+	std::vector<FSPicker::FileRecord> records{}; // sorted
+};
+
+// most recently listed first, only accessed from the main thread
+static std::vector<CachedListing> listingCache{};
+static constexpr size_t MAX_CACHED_LISTINGS = 8;
+static constexpr size_t MAX_CACHED_RECORDS = 1 << 16;
+
+static constexpr size_t LISTING_BATCH_SIZE = 256;
+static constexpr auto LISTING_BATCH_TIME = IG::Milliseconds{50};
+
+static bool fileRecordIsBefore(const auto &e1, const auto &e2)
+{
+	if(e1.isDir && !e2.isDir)
+		return true;
+	else if(!e1.isDir && e2.isDir)
+		return false;
+	else
+		return IG::stringNoCaseLexCompare(e1.path, e2.path);
+}
+
+static CachedListing *findCachedListing(std::string_view path, const FSPicker::FilterFunc &filter,
+	FSPicker::Mode mode, bool showHiddenFiles)
+{
+	auto it = std::ranges::find_if(listingCache, [&](const CachedListing &c)
+	{
+		return std::string_view{c.path} == path && c.filter == filter && c.mode == mode && c.showHiddenFiles == showHiddenFiles;
+	});
+	if(it == listingCache.end())
+		return nullptr;
+	// move to front
+	std::rotate(listingCache.begin(), it, it + 1);
+	return &listingCache.front();
+}
+
 FSPicker::FSPicker(ViewAttachParams attach, Gfx::TextureSpan backRes, Gfx::TextureSpan closeRes,
 	FilterFunc filter, Mode mode, Gfx::GlyphTextureSet *face_):
 	View{attach},
@@ -80,9 +138,20 @@ FSPicker::FSPicker(ViewAttachParams attach, Gfx::TextureSpan backRes, Gfx::Textu
 	controller.push(makeView<TableView>([&d = dir](const TableView &) { return d.size(); },
 		[&d = dir](const TableView &, size_t idx) -> MenuItem& { return d[idx].text; }));
 	controller.navView()->showLeftBtn(true);
+	fileTableView().setCompileVisibleCellsOnly(true);
+	fileTableView().setOnSelectElement(
+		[this](const Input::Event &e, int i, MenuItem &)
+		{
+			onSelectEntry(i, e);
+		});
 	dir.reserve(16); // start with some initial capacity to avoid small reallocations
 }
 
+FSPicker::~FSPicker()
+{
+	cancelListing();
+}
+
 void FSPicker::place()
 {
 	controller.place(viewRect(), projP);
@@ -194,6 +263,7 @@ void FSPicker::onAddedToController(ViewController *, const Input::Event &e)
 void FSPicker::setEmptyPath()
 {
 	logMsg("setting empty path");
+	cancelListing();
 	root = {};
 	dir.clear();
 	msgText.setString("No folder is set");
@@ -215,28 +285,105 @@ std::error_code FSPicker::setPath(IG::CStringView path, FS::RootPathInfo rootInf
 		return {};
 	}
 	auto prevPath = root.path;
-	auto ctx = appContext();
-	std::error_code ec{};
-	try
+	root.path = path;
+	highlightFirstCell = e.keyEvent();
+	closeWhenListed = false;
+	startListing(path);
+	if(highlightFirstCell && dir.size())
+		fileTableView().highlightCell(0);
+	else
+		fileTableView().resetScroll();
+	auto pathLen = path.size();
+	// verify root info
+	if(rootInfo.length && rootInfo.length > pathLen)
+	{
+		logWarn("invalid root length:%zu with path length:%zu", rootInfo.length, pathLen);
+		rootInfo.length = 0;
+	}
+	// if the path is a URI and no root info is provided, root at the URI itself
+	bool isUri = IG::isUri(path);
+	if(!rootInfo.length && isUri)
+	{
+		rootInfo = {appContext().fileUriDisplayName(path), path.size()};
+	}
+	FS::PathString rootedPath{};
+	if(rootInfo.length)
+	{
+		logMsg("root info:%d:%s", (int)rootInfo.length, rootInfo.name.data());
+		root.info = rootInfo;
+		if(pathLen > rootInfo.length)
+			rootedPath = IG::format<FS::PathString>("{}{}", rootInfo.name, &path[rootInfo.length]);
+		else
+			rootedPath = rootInfo.name;
+	}
+	else
+	{
+		logMsg("no root info");
+		root.info = {};
+		rootedPath = root.path;
+	}
+	if(isUri)
+	{
+		rootedPath = IG::decodeUri<FS::PathString>(rootedPath);
+	}
+	fileTableView().setName(rootedPath);
+	onChangePath_.callSafe(*this, prevPath, e);
+	return {};
+}
+
+void FSPicker::startListing(IG::CStringView path)
+{
+	cancelListing();
+	dir.clear();
+	listedRecords.clear();
+	if(auto cached = findCachedListing(path, filter, mode_, showHiddenFiles_);
+		cached)
 	{
-		root.path = path;
-		dir.clear();
-		ctx.forEachInDirectoryUri(path,
-			[this](auto &entry)
+		logMsg("using %zu cached entries for:%s", cached->records.size(), path.data());
+		setRecords(cached->records);
+		usingCachedRecords = true;
+	}
+	else
+	{
+		usingCachedRecords = false;
+		msgText.setString("Loading...");
+	}
+	listing = std::make_shared<DirectoryListing>();
+	listing->recordsReady.attach([this](){ onListingUpdate(); });
+	IG::makeDetachedThread(
+		[ctx = appContext(), listing = listing, path = FS::PathString{path},
+			filter = filter, mode = mode_, showHiddenFiles = showHiddenFiles_]()
+		{
+			std::vector<FileRecord> batch;
+			auto lastBatchTime = IG::steadyClockTimestamp();
+			auto sendBatch = [&](bool done, std::error_code ec = {})
 			{
-				//logMsg("entry:%s", entry.path().data());
+				{
+					std::scoped_lock lock{listing->mutex};
+					std::ranges::move(batch, std::back_inserter(listing->records));
+					listing->done = done;
+					listing->ec = ec;
+				}
+				batch.clear();
+				lastBatchTime = IG::steadyClockTimestamp();
+				listing->recordsReady.notify();
+			};
+			auto addEntry = [&](const FS::directory_entry &entry)
+			{
+				if(listing->canceled.load(std::memory_order_relaxed))
+					return false;
 				bool isDir = entry.type() == FS::file_type::directory;
-				if(mode_ == Mode::DIR) // filter non-directories
+				if(mode == Mode::DIR) // filter non-directories
 				{
 					if(!isDir)
 						return true;
 				}
-				else if(mode_ == Mode::FILE_IN_DIR) // filter directories
+				else if(mode == Mode::FILE_IN_DIR) // filter directories
 				{
 					if(isDir)
 						return true;
 				}
-				if(!showHiddenFiles_ && entry.name().starts_with('.'))
+				if(!showHiddenFiles && entry.name().starts_with('.'))
 				{
 					return true;
 				}
@@ -244,97 +391,157 @@ std::error_code FSPicker::setPath(IG::CStringView path, FS::RootPathInfo rootInf
 				{
 					return true;
 				}
-				dir.emplace_back(FileEntry{std::string{entry.path()}, isDir, {entry.name(), &face(), nullptr}});
+				batch.emplace_back(std::string{entry.path()}, std::string{entry.name()}, isDir);
+				if(batch.size() == LISTING_BATCH_SIZE
+					|| IG::steadyClockTimestamp() - lastBatchTime >= LISTING_BATCH_TIME)
+				{
+					sendBatch(false);
+				}
 				return true;
-			});
-		std::sort(dir.begin(), dir.end(),
-			[](const FileEntry &e1, const FileEntry &e2)
+			};
+			try
 			{
-				if(e1.isDir && !e2.isDir)
-					return true;
-				else if(!e1.isDir && e2.isDir)
-					return false;
-				else
-					return IG::stringNoCaseLexCompare(e1.path, e2.path);
-			});
-		if(dir.size())
-		{
-			for(auto &d : dir)
+				ctx.forEachInDirectoryUri(path, [&addEntry](auto &entry){ return addEntry(entry); });
+				sendBatch(true);
+			}
+			catch(std::system_error &err)
 			{
-				if(d.isDir)
-				{
-					d.text.setOnSelect(
-						[this, &dirPath = d.path](const Input::Event &e)
-						{
-							assert(!isSingleDirectoryMode());
-							auto path = std::move(dirPath);
-							logMsg("entering dir:%s", path.data());
-							changeDirByInput(path, root.info, e);
-						});
-				}
-				else
-				{
-					d.text.setOnSelect(
-						[this, &dirPath = d.path](const Input::Event &e)
-						{
-							onSelectFile_.callCopy(*this, dirPath, appContext().fileUriDisplayName(dirPath), e);
-						});
-				}
+				logErr("can't open %s", path.data());
+				sendBatch(true, err.code());
 			}
-			msgText.setString({});
+		});
+}
+
+void FSPicker::cancelListing()
+{
+	if(!listing)
+		return;
+	listing->canceled.store(true, std::memory_order_relaxed);
+	listing->recordsReady.detach();
+	listing.reset();
+}
+
+void FSPicker::onListingUpdate()
+{
+	if(!listing)
+		return;
+	std::vector<FileRecord> records;
+	bool done;
+	std::error_code ec;
+	{
+		std::scoped_lock lock{listing->mutex};
+		records = std::move(listing->records);
+		listing->records.clear();
+		done = listing->done;
+		ec = listing->ec;
+	}
+	// records from a cached listing are only replaced once the new listing is complete
+	if(!usingCachedRecords && records.size())
+	{
+		addRecords(records);
+	}
+	std::ranges::move(records, std::back_inserter(listedRecords));
+	if(!done)
+		return;
+	logMsg("listed %zu entries in:%s", listedRecords.size(), root.path.data());
+	cancelListing();
+	if(!ec)
+	{
+		std::ranges::sort(listedRecords, [](auto &e1, auto &e2){ return fileRecordIsBefore(e1, e2); });
+		auto cached = findCachedListing(root.path, filter, mode_, showHiddenFiles_);
+		if(usingCachedRecords && cached && cached->records != listedRecords)
+		{
+			logMsg("directory changed since cached listing");
+			setRecords(listedRecords);
 		}
-		else // no entries, show a message instead
+		if(!cached && listedRecords.size() <= MAX_CACHED_RECORDS)
 		{
-			msgText.setString("Empty Directory");
+			if(listingCache.size() == MAX_CACHED_LISTINGS)
+				listingCache.pop_back();
+			listingCache.emplace(listingCache.begin(), root.path, filter, mode_, showHiddenFiles_, std::vector<FileRecord>{});
+			cached = &listingCache.front();
 		}
+		if(cached)
+			cached->records = std::move(listedRecords);
 	}
-	catch(std::system_error &err)
+	listedRecords = {};
+	usingCachedRecords = false;
+	updateEmptyMessage(ec);
+	if(closeWhenListed && !ec)
 	{
-		logErr("can't open %s", path.data());
-		ec = err.code();
-		std::string_view extraMsg = mode_ == Mode::FILE_IN_DIR ? "" : "\nPick a path from the top bar";
-		msgText.setString(fmt::format("Can't open directory:\n{}{}", ec.message(), extraMsg));
+		closeWhenListed = false;
+		onClose_.callCopy(*this, appContext().defaultInputEvent());
+		return;
 	}
-	if(e.keyEvent())
-		static_cast<TableView*>(&controller.top())->highlightCell(0);
-	else
-		static_cast<TableView*>(&controller.top())->resetScroll();
-	auto pathLen = path.size();
-	// verify root info
-	if(rootInfo.length && rootInfo.length > pathLen)
+	closeWhenListed = false;
+	place();
+	postDraw();
+}
+
+void FSPicker::addRecords(std::span<FileRecord> records)
+{
+	std::ranges::sort(records, [](auto &e1, auto &e2){ return fileRecordIsBefore(e1, e2); });
+	bool wasEmpty = dir.empty();
+	auto prevSize = dir.size();
+	dir.reserve(prevSize + records.size());
+	for(const auto &r : records)
 	{
-		logWarn("invalid root length:%zu with path length:%zu", rootInfo.length, pathLen);
-		rootInfo.length = 0;
+		dir.emplace_back(r.path, r.isDir, TextMenuItem{r.name, &face(), nullptr});
 	}
-	// if the path is a URI and no root info is provided, root at the URI itself
-	bool isUri = IG::isUri(path);
-	if(!rootInfo.length && isUri)
+	std::inplace_merge(dir.begin(), dir.begin() + prevSize, dir.end(),
+		[](auto &e1, auto &e2){ return fileRecordIsBefore(e1, e2); });
+	msgText.setString({});
+	fileTableView().place();
+	if(wasEmpty && highlightFirstCell)
+		fileTableView().highlightCell(0);
+	postDraw();
+}
+
+void FSPicker::setRecords(std::span<const FileRecord> records)
+{
+	dir.clear();
+	dir.reserve(records.size());
+	for(const auto &r : records)
 	{
-		rootInfo = {appContext().fileUriDisplayName(path), path.size()};
+		dir.emplace_back(r.path, r.isDir, TextMenuItem{r.name, &face(), nullptr});
 	}
-	FS::PathString rootedPath{};
-	if(rootInfo.length)
+	msgText.setString({});
+	fileTableView().place();
+	postDraw();
+}
+
+void FSPicker::updateEmptyMessage(std::error_code ec)
+{
+	if(ec)
 	{
-		logMsg("root info:%d:%s", (int)rootInfo.length, rootInfo.name.data());
-		root.info = rootInfo;
-		if(pathLen > rootInfo.length)
-			rootedPath = IG::format<FS::PathString>("{}{}", rootInfo.name, &path[rootInfo.length]);
-		else
-			rootedPath = rootInfo.name;
+		if(dir.size())
+			return;
+		std::string_view extraMsg = mode_ == Mode::FILE_IN_DIR ? "" : "\nPick a path from the top bar";
+		msgText.setString(fmt::format("Can't open directory:\n{}{}", ec.message(), extraMsg));
 	}
-	else
+	else if(dir.empty())
 	{
-		logMsg("no root info");
-		root.info = {};
-		rootedPath = root.path;
+		msgText.setString("Empty Directory");
 	}
-	if(isUri)
+}
+
+void FSPicker::onSelectEntry(size_t idx, const Input::Event &e)
+{
+	if(idx >= dir.size()) [[unlikely]]
+		return;
+	auto &entry = dir[idx];
+	if(entry.isDir)
 	{
-		rootedPath = IG::decodeUri<FS::PathString>(rootedPath);
+		assert(!isSingleDirectoryMode());
+		auto path = entry.path; // entries are cleared when the path changes
+		logMsg("entering dir:%s", path.data());
+		changeDirByInput(path, root.info, e);
+	}
+	else
+	{
+		auto path = entry.path;
+		onSelectFile_.callCopy(*this, path, appContext().fileUriDisplayName(path), e);
 	}
-	fileTableView().setName(rootedPath);
-	onChangePath_.callSafe(*this, prevPath, e);
-	return ec;
 }
 
 std::error_code FSPicker::setPath(IG::CStringView path, FS::RootPathInfo rootInfo)
@@ -442,9 +649,9 @@ void FSPicker::pushFileLocationsView(const Input::Event &e)
 					[this, &view](IG::CStringView uri, IG::CStringView displayName)
 					{
 						view.dismiss();
-						auto ec = changeDirByInput(uri, appContext().rootPathInfo(uri), appContext().defaultInputEvent());
-						if(mode_ == Mode::DIR && !ec)
-							onClose_.callCopy(*this, appContext().defaultInputEvent());
+						changeDirByInput(uri, appContext().rootPathInfo(uri), appContext().defaultInputEvent());
+						if(mode_ == Mode::DIR)
+							closeWhenListed = true; // close if the folder can be listed
 					});
 			});
 	}
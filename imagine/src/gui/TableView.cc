@@ -68,6 +68,9 @@ void TableView::prepareDraw()
 	int cells_ = items(*this);
 	if(!cells_)
 		return;
+	// text layout runs here on the main thread so draw() only issues draw calls
+	if(compileVisibleCellsOnly)
+		compileVisibleCells(cells_);
 	int startYCell = std::min(scrollOffset() / yCellSize, cells_);
 	size_t endYCell = std::clamp(startYCell + visibleCells, 0, cells_);
 	if(startYCell < 0)
@@ -171,10 +174,20 @@ void TableView::draw(Gfx::RendererCommands &cmds)
 void TableView::place()
 {
 	auto cells_ = items(*this);
-	iterateTimes(cells_, i)
+	compiledCells = {};
+	if(compileVisibleCellsOnly)
 	{
-		//logMsg("compile item %d", i);
-		item(*this, i).compile(renderer(), projP);
+		// the first cell sets the size of all cells, the rest are compiled in prepareDraw()
+		if(cells_)
+			item(*this, 0).compile(renderer(), projP);
+	}
+	else
+	{
+		iterateTimes(cells_, i)
+		{
+			//logMsg("compile item %d", i);
+			item(*this, i).compile(renderer(), projP);
+		}
 	}
 	if(cells_)
 	{
@@ -186,6 +199,24 @@ void TableView::place()
 		visibleCells = 0;
 }
 
+void TableView::compileVisibleCells(int cells_)
+{
+	if(!yCellSize)
+		return;
+	int startYCell = std::clamp(scrollOffset() / yCellSize, 0, cells_);
+	int endYCell = std::clamp(startYCell + visibleCells, 0, cells_);
+	if(startYCell == compiledCells.first && endYCell == compiledCells.second)
+		return;
+	// cells still in the previously compiled range don't need to be compiled again
+	for(int i = startYCell; i < endYCell; i++)
+	{
+		if(i >= compiledCells.first && i < compiledCells.second)
+			continue;
+		item(*this, i).compile(renderer(), projP);
+	}
+	compiledCells = {startYCell, endYCell};
+}
+
 void TableView::onShow()
 {
 	ScrollView::onShow();
@@ -222,6 +253,11 @@ void TableView::setScrollableIfNeeded(bool on)
 	onlyScrollIfNeeded = on;
 }
 
+void TableView::setCompileVisibleCellsOnly(bool on)
+{
+	compileVisibleCellsOnly = on;
+}
+
 void TableView::scrollToFocusRect()
 {
 	if(selected < 0)
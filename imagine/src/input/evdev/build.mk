@@ -3,6 +3,8 @@ inc_input_evdev := 1
 
 include $(imagineSrcDir)/input/build.mk
 
+configDefs += CONFIG_INPUT_EVDEV
+
 SRC += input/evdev/evdev.cc
 
 endif
@@ -30,6 +30,7 @@
 #include <sys/inotify.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <time.h>
 #include <vector>
 
 #define DEV_NODE_PATH "/dev/input"
@@ -139,6 +140,8 @@ void EvdevInputDevice::processInputEvents(LinuxApplication &app, input_event *ev
 				//logMsg("got key event code:0x%X value:%d", ev.code, ev.value);
 				auto key = toSysKey(ev.code);
 				KeyEvent event{Map::SYSTEM, key, key, ev.value ? Action::PUSHED : Action::RELEASED, 0, 0, Source::GAMEPAD, time, this};
+				if(app.dispatchDirectKeyInput(event))
+					continue;
 				app.dispatchRepeatableKeyInputEvent(event);
 			}
 			bcase EV_ABS:
@@ -304,6 +307,12 @@ static bool processDevNode(LinuxApplication &app, IG::CStringView path, int id,
 		close(fd);
 		return false;
 	}
+	// use the same clock as other event & frame times instead of wall time
+	int clockId = CLOCK_MONOTONIC;
+	if(ioctl(fd, EVIOCSCLOCKID, &clockId) < 0)
+	{
+		logWarn("unable to set event clock");
+	}
 	std::array<char, 80> nameStr{"Unknown"};
 	if(ioctl(fd, EVIOCGNAME(sizeof(nameStr)), nameStr.data()) < 0)
 	{
@@ -332,6 +341,16 @@ static bool processDevNodeName(IG::CStringView name, uint32_t &id)
 namespace IG
 {
 
+void LinuxApplication::setOnDirectKeyInput(DirectKeyInputDelegate del)
+{
+	onDirectKeyInput = del;
+}
+
+bool LinuxApplication::dispatchDirectKeyInput(const Input::KeyEvent &e)
+{
+	return onDirectKeyInput && onDirectKeyInput(e);
+}
+
 void LinuxApplication::initEvdev(EventLoop loop)
 {
 	logMsg("setting up inotify for hotplug");
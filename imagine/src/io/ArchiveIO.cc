@@ -22,6 +22,9 @@
 #include "utils.hh"
 #include <archive.h>
 #include <archive_entry.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
 
 namespace IG
 {
@@ -43,6 +46,8 @@ static FS::file_type makeEntryType(int type)
 }
 
 static constexpr size_t bufferedIoSize = 32 * 1024;
+// minimum amount to decompress at a time in random access mode
+static constexpr size_t minSpillDecodeSize = 256 * 1024;
 
 struct ArchiveControlBlockWithBuffer : public ArchiveControlBlock
 {
@@ -240,6 +245,9 @@ ArchiveIO::ArchiveIO(ArchiveEntry entry):
 
 ArchiveEntry ArchiveIO::releaseArchive()
 {
+	spillBuff = {};
+	decodedBytes = 0;
+	spillPos = 0;
 	return std::move(entry);
 }
 
@@ -248,12 +256,105 @@ std::string_view ArchiveIO::name() const
 	return entry.name();
 }
 
+uint32_t ArchiveIO::crc32() const
+{
+	return entry.crc32();
+}
+
+static constexpr auto unmapSpillBuffer = [](const uint8_t *ptr, size_t size)
+{
+	if(munmap((void*)ptr, size) == -1)
+	{
+		if(Config::DEBUG_BUILD)
+			logErr("munmap(%p, %zu) error:%s", ptr, size, strerror(errno));
+	}
+};
+
+static IG::ByteBuffer makeSpillBuffer(size_t size, IG::CStringView spillDir)
+{
+	if(spillDir.size())
+	{
+		auto path = IG::format<FS::PathString>("{}/ArchiveIO.XXXXXX", spillDir);
+		if(int fd = mkstemp(path.data());
+			fd != -1)
+		{
+			// the mapping keeps the data accessible after the file is unlinked & closed
+			unlink(path.data());
+			void *data = MAP_FAILED;
+			if(ftruncate(fd, size) == 0)
+				data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close(fd);
+			if(data != MAP_FAILED)
+			{
+				logMsg("spilling %zu bytes to file in:%s", size, spillDir.data());
+				return {{(uint8_t*)data, size}, unmapSpillBuffer};
+			}
+			logErr("error mapping spill file in:%s", spillDir.data());
+		}
+		else
+		{
+			logErr("error creating spill file in:%s", spillDir.data());
+		}
+	}
+	void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if(data == MAP_FAILED)
+	{
+		logErr("error mapping %zu bytes for spill buffer", size);
+		return {};
+	}
+	logMsg("spilling %zu bytes to memory", size);
+	return {{(uint8_t*)data, size}, unmapSpillBuffer};
+}
+
+bool ArchiveIO::setRandomAccess(IG::CStringView spillDir)
+{
+	if(!*this) [[unlikely]]
+		return false;
+	if(isRandomAccess())
+		return true;
+	auto entrySize = entry.size();
+	if(!entrySize)
+		return false;
+	spillBuff = makeSpillBuffer(entrySize, spillDir);
+	decodedBytes = 0;
+	spillPos = 0;
+	return isRandomAccess();
+}
+
+bool ArchiveIO::decodeTo(size_t offset)
+{
+	if(offset <= decodedBytes)
+		return true;
+	offset = std::min(std::max(offset, decodedBytes + minSpillDecodeSize), spillBuff.size());
+	while(decodedBytes < offset)
+	{
+		auto bytesRead = archive_read_data(entry.archive(), spillBuff.data() + decodedBytes, offset - decodedBytes);
+		if(bytesRead <= 0)
+		{
+			if(bytesRead < 0)
+				logErr("error decompressing at offset %zu:%s", decodedBytes, archive_error_string(entry.archive()));
+			else
+				logErr("entry ended at offset %zu of %zu", decodedBytes, spillBuff.size());
+			return false;
+		}
+		decodedBytes += bytesRead;
+	}
+	return true;
+}
+
 ssize_t ArchiveIO::read(void *buff, size_t bytes)
 {
 	if(!*this) [[unlikely]]
 	{
 		return -1;
 	}
+	if(isRandomAccess())
+	{
+		auto bytesRead = readAtPos(buff, bytes, spillPos);
+		if(bytesRead > 0)
+			spillPos += bytesRead;
+		return bytesRead;
+	}
 	int bytesRead = archive_read_data(entry.archive(), buff, bytes);
 	if(bytesRead < 0)
 	{
@@ -262,6 +363,19 @@ ssize_t ArchiveIO::read(void *buff, size_t bytes)
 	return bytesRead;
 }
 
+ssize_t ArchiveIO::readAtPos(void *buff, size_t bytes, off_t offset)
+{
+	if(!isRandomAccess())
+		return IO::readAtPos(buff, bytes, offset);
+	if(offset < 0 || (size_t)offset > spillBuff.size()) [[unlikely]]
+		return -1;
+	bytes = std::min(bytes, spillBuff.size() - offset);
+	if(!decodeTo(offset + bytes)) [[unlikely]]
+		return -1;
+	memcpy(buff, spillBuff.data() + offset, bytes);
+	return bytes;
+}
+
 ssize_t ArchiveIO::write(const void* buff, size_t bytes)
 {
 	return -1;
@@ -273,6 +387,18 @@ off_t ArchiveIO::seek(off_t offset, IO::SeekMode mode)
 	{
 		return -1;
 	}
+	if(isRandomAccess())
+	{
+		// decompression happens on the next read
+		auto newPos = transformOffsetToAbsolute(mode, offset, 0, spillBuff.size(), spillPos);
+		if(newPos < 0 || (size_t)newPos > spillBuff.size())
+		{
+			logErr("illegal seek position");
+			return -1;
+		}
+		spillPos = newPos;
+		return newPos;
+	}
 	long newPos = archive_seek_data(entry.archive(), offset, (int)mode);
 	if(newPos < 0)
 	{
@@ -282,6 +408,13 @@ off_t ArchiveIO::seek(off_t offset, IO::SeekMode mode)
 	return newPos;
 }
 
+std::span<uint8_t> ArchiveIO::map()
+{
+	if(!isRandomAccess() || !decodeTo(spillBuff.size()))
+		return {};
+	return spillBuff;
+}
+
 size_t ArchiveIO::size()
 {
 	return entry.size();
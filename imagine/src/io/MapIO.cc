@@ -19,6 +19,7 @@
 #include "utils.hh"
 #include <errno.h>
 #include <cstring>
+#include <algorithm>
 #if defined __linux__ || defined __APPLE__
 #include <sys/mman.h>
 #include <imagine/util/system/pagesize.h>
@@ -54,8 +55,19 @@ std::span<uint8_t> MapIO::map()
 
 ssize_t MapIO::write(const void *buff, size_t bytes)
 {
-	// TODO
-	return -1;
+	// writes are clipped to the existing buffer, it's never resized
+	assert(currPos >= data());
+	if(currPos >= dataEnd())
+	{
+		if(!data()) [[unlikely]]
+			return -1;
+		else
+			return 0;
+	}
+	size_t bytesToWrite = std::min(bytes, size_t(dataEnd() - currPos));
+	memcpy(currPos, buff, bytesToWrite);
+	currPos += bytesToWrite;
+	return bytesToWrite;
 }
 
 off_t MapIO::seek(off_t offset, IO::SeekMode mode)
@@ -0,0 +1,630 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include "asyncLogger.hh"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace IG::Log
+{
+
+enum class ArgType : uint8_t
+{
+	NONE, INT, UINT, DOUBLE, STRING, POINTER, WRITE_COUNT
+};
+
+enum class ArgLength : uint8_t
+{
+	DEFAULT, CHAR, SHORT, LONG, LONG_LONG, SIZE, INTMAX, PTRDIFF, LONG_DOUBLE
+};
+
+// one printf conversion, parsed when capturing the arguments and again when formatting them
+struct FormatSpec
+{
+	const char *start{}; // the '%'
+	const char *lengthStart{}; // the length modifier, or conversion if there's none
+	const char *end{}; // one past the conversion
+	ArgType type{};
+	ArgLength length{};
+	uint8_t stars{}; // int arguments for '*' width & precision
+	bool precisionStar{}; // precision is the last '*' argument
+	int precision{-1}; // when given as digits
+	char conversion{};
+};
+
+static const char *parseSpec(const char *p, FormatSpec &spec)
+{
+	spec = {.start = p};
+	p++;
+	while(*p && strchr("-+ #0'", *p))
+		p++;
+	auto skipWidth = [&]()
+	{
+		if(*p == '*')
+		{
+			spec.stars++;
+			p++;
+		}
+		else
+		{
+			while(*p >= '0' && *p <= '9')
+				p++;
+		}
+	};
+	skipWidth();
+	if(*p == '.')
+	{
+		p++;
+		if(*p == '*')
+		{
+			spec.precisionStar = true;
+			skipWidth();
+		}
+		else
+		{
+			spec.precision = 0;
+			while(*p >= '0' && *p <= '9')
+				spec.precision = std::min(spec.precision * 10 + (*p++ - '0'), 0xFFFF);
+		}
+	}
+	spec.lengthStart = p;
+	switch(*p)
+	{
+		case 'h':
+			spec.length = *(++p) == 'h' ? (p++, ArgLength::CHAR) : ArgLength::SHORT;
+			break;
+		case 'l':
+			spec.length = *(++p) == 'l' ? (p++, ArgLength::LONG_LONG) : ArgLength::LONG;
+			break;
+		case 'q': spec.length = ArgLength::LONG_LONG; p++; break;
+		case 'z': spec.length = ArgLength::SIZE; p++; break;
+		case 'j': spec.length = ArgLength::INTMAX; p++; break;
+		case 't': spec.length = ArgLength::PTRDIFF; p++; break;
+		case 'L': spec.length = ArgLength::LONG_DOUBLE; p++; break;
+	}
+	spec.conversion = *p;
+	if(!*p) // truncated specifier
+	{
+		spec.end = p;
+		return p;
+	}
+	spec.end = p + 1;
+	switch(*p)
+	{
+		case 'd': case 'i': case 'c':
+			spec.type = ArgType::INT; break;
+		case 'o': case 'u': case 'x': case 'X':
+			spec.type = ArgType::UINT; break;
+		case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+			spec.type = ArgType::DOUBLE; break;
+		case 's':
+			// wide strings are only shown as pointers
+			spec.type = spec.length == ArgLength::LONG ? ArgType::POINTER : ArgType::STRING; break;
+		case 'p':
+			spec.type = ArgType::POINTER; break;
+		case 'n':
+			spec.type = ArgType::WRITE_COUNT; break;
+	}
+	return spec.end;
+}
+
+static int64_t readIntArg(ArgLength length, va_list &args)
+{
+	switch(length)
+	{
+		case ArgLength::LONG: return va_arg(args, long);
+		case ArgLength::LONG_LONG: return va_arg(args, long long);
+		case ArgLength::SIZE: return va_arg(args, std::make_signed_t<size_t>);
+		case ArgLength::INTMAX: return va_arg(args, intmax_t);
+		case ArgLength::PTRDIFF: return va_arg(args, ptrdiff_t);
+		default: return va_arg(args, int);
+	}
+}
+
+static uint64_t readUIntArg(ArgLength length, va_list &args)
+{
+	switch(length)
+	{
+		case ArgLength::LONG: return va_arg(args, unsigned long);
+		case ArgLength::LONG_LONG: return va_arg(args, unsigned long long);
+		case ArgLength::SIZE: return va_arg(args, size_t);
+		case ArgLength::INTMAX: return va_arg(args, uintmax_t);
+		case ArgLength::PTRDIFF: return va_arg(args, std::make_unsigned_t<ptrdiff_t>);
+		default: return va_arg(args, unsigned);
+	}
+}
+
+struct RecordHeader
+{
+	uint32_t size{}; // including the header, a multiple of the record alignment
+	uint16_t msgSize{}; // format string length
+	uint8_t severity{};
+	bool isPadding{}; // fills the end of the ring when a record doesn't fit there
+	uint64_t seq{};
+};
+
+static constexpr size_t recordAlign = sizeof(RecordHeader);
+static constexpr size_t maxRecordSize = 1024;
+static constexpr size_t maxStringArgSize = 255;
+static_assert(sizeof(RecordHeader) == 16);
+
+static constexpr size_t alignSize(size_t size, size_t align) { return (size + align - 1) & ~(align - 1); }
+
+// Record payload: the NUL terminated format string padded to 8 bytes, then 8 bytes per
+// argument, with string arguments stored as their length followed by the padded characters
+class RecordWriter
+{
+public:
+	RecordWriter(std::byte *data): data{data} {}
+
+	bool write(const void *src, size_t bytes)
+	{
+		auto padded = alignSize(bytes, 8);
+		if(size + padded > maxRecordSize)
+			return false;
+		memcpy(data + size, src, bytes);
+		memset(data + size + bytes, 0, padded - bytes);
+		size += padded;
+		return true;
+	}
+
+	bool write64(uint64_t val) { return write(&val, sizeof(val)); }
+
+	bool writeString(const char *str, size_t len)
+	{
+		return write64(len) && writeWithTerminator(str, len);
+	}
+
+	bool writeWithTerminator(const char *str, size_t len)
+	{
+		auto padded = alignSize(len + 1, 8);
+		if(size + padded > maxRecordSize)
+			return false;
+		memcpy(data + size, str, len);
+		memset(data + size + len, 0, padded - len);
+		size += padded;
+		return true;
+	}
+
+	std::byte *data;
+	size_t size{sizeof(RecordHeader)};
+};
+
+// returns the record size or 0 if it doesn't fit
+static size_t captureRecord(std::byte *data, LoggerSeverity severity, const char *msg, va_list &args)
+{
+	RecordWriter writer{data};
+	auto msgSize = strlen(msg);
+	if(msgSize > UINT16_MAX || !writer.writeWithTerminator(msg, msgSize))
+		return 0;
+	for(auto p = strchr(msg, '%'); p; p = strchr(p, '%'))
+	{
+		FormatSpec spec;
+		p = parseSpec(p, spec);
+		int precision = spec.precision;
+		for(auto i = 0; i < spec.stars; i++)
+		{
+			precision = va_arg(args, int);
+			if(!writer.write64(precision))
+				return 0;
+		}
+		if(!spec.precisionStar)
+			precision = spec.precision;
+		bool fits = true;
+		switch(spec.type)
+		{
+			case ArgType::NONE: break;
+			case ArgType::INT: fits = writer.write64(readIntArg(spec.length, args)); break;
+			case ArgType::UINT: fits = writer.write64(readUIntArg(spec.length, args)); break;
+			case ArgType::DOUBLE:
+			{
+				double val = spec.length == ArgLength::LONG_DOUBLE ? va_arg(args, long double) : va_arg(args, double);
+				fits = writer.write(&val, sizeof(val));
+				break;
+			}
+			case ArgType::STRING:
+			{
+				auto str = va_arg(args, const char*);
+				if(!str)
+					str = "(null)";
+				// the string may not be terminated within its precision, as with %.*s & a string_view
+				auto maxLen = precision >= 0 ? std::min(size_t(precision), maxStringArgSize) : maxStringArgSize;
+				fits = writer.writeString(str, strnlen(str, maxLen));
+				break;
+			}
+			case ArgType::POINTER: fits = writer.write64(uintptr_t(va_arg(args, void*))); break;
+			case ArgType::WRITE_COUNT: va_arg(args, void*); break; // never written to
+		}
+		if(!fits)
+			return 0;
+	}
+	auto size = alignSize(writer.size, recordAlign);
+	memset(data + writer.size, 0, size - writer.size);
+	RecordHeader header{.size = uint32_t(size), .msgSize = uint16_t(msgSize), .severity = severity};
+	memcpy(data, &header, sizeof(header));
+	return size;
+}
+
+class RecordReader
+{
+public:
+	RecordReader(const std::byte *data): data{data} {}
+
+	uint64_t read64()
+	{
+		uint64_t val;
+		memcpy(&val, data, sizeof(val));
+		data += 8;
+		return val;
+	}
+
+	double readDouble()
+	{
+		double val;
+		memcpy(&val, data, sizeof(val));
+		data += 8;
+		return val;
+	}
+
+	const char *readString(size_t len)
+	{
+		auto str = reinterpret_cast<const char*>(data);
+		data += alignSize(len + 1, 8);
+		return str;
+	}
+
+	const std::byte *data;
+};
+
+template <class T>
+static void appendFormatted(std::string &out, const char *spec, const int *stars, int starCount, T val)
+{
+	char buff[512];
+	int len{};
+	switch(starCount)
+	{
+		case 0: len = snprintf(buff, sizeof(buff), spec, val); break;
+		case 1: len = snprintf(buff, sizeof(buff), spec, stars[0], val); break;
+		default: len = snprintf(buff, sizeof(buff), spec, stars[0], stars[1], val); break;
+	}
+	if(len > 0)
+		out.append(buff, std::min(size_t(len), sizeof(buff) - 1));
+}
+
+static void formatRecord(std::string &out, const std::byte *data)
+{
+	RecordHeader header;
+	memcpy(&header, data, sizeof(header));
+	RecordReader reader{data + sizeof(header)};
+	auto msg = reader.readString(header.msgSize);
+	const char *literalStart = msg;
+	for(auto p = strchr(msg, '%'); p; p = strchr(p, '%'))
+	{
+		out.append(literalStart, p);
+		FormatSpec spec;
+		p = parseSpec(p, spec);
+		literalStart = p;
+		int stars[2]{};
+		for(auto i = 0; i < spec.stars; i++)
+		{
+			stars[i] = int(reader.read64());
+		}
+		// rebuild the specifier with the length of the stored argument
+		char specStr[32];
+		size_t prefixLen = std::min(size_t(spec.lengthStart - spec.start), sizeof(specStr) - 4);
+		memcpy(specStr, spec.start, prefixLen);
+		auto specEnd = specStr + prefixLen;
+		auto endSpec = [&](const char *suffix) { strcpy(specEnd, suffix); };
+		switch(spec.type)
+		{
+			case ArgType::NONE:
+				if(spec.conversion == '%')
+					out += '%';
+				else
+					out.append(spec.start, spec.end);
+				break;
+			case ArgType::INT:
+				if(spec.conversion == 'c')
+				{
+					endSpec("c");
+					appendFormatted(out, specStr, stars, spec.stars, int(reader.read64()));
+				}
+				else
+				{
+					char suffix[]{'l', 'l', spec.conversion, 0};
+					endSpec(suffix);
+					appendFormatted(out, specStr, stars, spec.stars, (long long)reader.read64());
+				}
+				break;
+			case ArgType::UINT:
+			{
+				char suffix[]{'l', 'l', spec.conversion, 0};
+				endSpec(suffix);
+				appendFormatted(out, specStr, stars, spec.stars, (unsigned long long)reader.read64());
+				break;
+			}
+			case ArgType::DOUBLE:
+			{
+				char suffix[]{spec.conversion, 0};
+				endSpec(suffix);
+				appendFormatted(out, specStr, stars, spec.stars, reader.readDouble());
+				break;
+			}
+			case ArgType::STRING:
+			{
+				endSpec("s");
+				auto len = reader.read64();
+				appendFormatted(out, specStr, stars, spec.stars, reader.readString(len));
+				break;
+			}
+			case ArgType::POINTER:
+				endSpec("p");
+				appendFormatted(out, specStr, stars, spec.stars, (void*)uintptr_t(reader.read64()));
+				break;
+			case ArgType::WRITE_COUNT:
+				break;
+		}
+	}
+	out.append(literalStart);
+}
+
+struct ThreadRing
+{
+	static constexpr uint32_t capacity = 32 * 1024; // power of 2
+
+	alignas(64) std::atomic_uint32_t writePos{}; // free running byte offsets
+	alignas(64) std::atomic_uint32_t readPos{};
+	std::atomic_uint32_t dropped{};
+	std::atomic_bool orphaned{}; // owning thread exited, freed once drained
+	alignas(recordAlign) std::byte data[capacity];
+
+	uint32_t usedBytes() const
+	{
+		return writePos.load(std::memory_order_relaxed) - readPos.load(std::memory_order_relaxed);
+	}
+
+	// only called by the owning thread
+	bool push(const std::byte *record, uint32_t size)
+	{
+		auto w = writePos.load(std::memory_order_relaxed);
+		auto r = readPos.load(std::memory_order_acquire);
+		auto contiguous = capacity - (w % capacity);
+		auto padding = size > contiguous ? contiguous : 0;
+		if(size + padding > capacity - (w - r))
+			return false;
+		if(padding)
+		{
+			RecordHeader header{.size = padding, .isPadding = true};
+			memcpy(data + (w % capacity), &header, sizeof(header));
+			w += padding;
+		}
+		memcpy(data + (w % capacity), record, size);
+		writePos.store(w + size, std::memory_order_release);
+		return true;
+	}
+};
+
+// set when the logger is destroyed at exit, any later messages are written synchronously
+constinit static std::atomic_bool asyncStopped{};
+
+class AsyncLogger
+{
+public:
+	~AsyncLogger()
+	{
+		stop();
+	}
+
+	ThreadRing *registerThread()
+	{
+		std::lock_guard lock{mutex};
+		if(!thread.joinable())
+		{
+			thread = std::thread{[this](){ run(); }};
+		}
+		auto ring = new ThreadRing;
+		rings.push_back(ring);
+		return ring;
+	}
+
+	uint64_t nextSeq() { return seq.fetch_add(1, std::memory_order_relaxed); }
+
+	void wake()
+	{
+		if(!wakePending.exchange(true, std::memory_order_relaxed))
+			wakeSem.release();
+	}
+
+	void flush()
+	{
+		std::lock_guard lock{mutex};
+		flushLocked();
+	}
+
+	// writes a message that doesn't fit in a record after the queued ones, while holding
+	// the flusher's lock since the output shares state like the log line buffer
+	void writeUnqueued(LoggerSeverity severity, const char *str)
+	{
+		std::lock_guard lock{mutex};
+		flushLocked();
+		writeFormatted(severity, str);
+	}
+
+	void stop()
+	{
+		if(asyncStopped.exchange(true))
+			return;
+		if(thread.joinable())
+		{
+			running.store(false, std::memory_order_relaxed);
+			wake();
+			thread.join();
+		}
+		flush();
+	}
+
+	uint32_t droppedMessages() const { return totalDropped.load(std::memory_order_relaxed); }
+
+private:
+	std::mutex mutex; // guards the ring list, the consumer side of each ring & writeFormatted()
+	std::vector<ThreadRing*> rings;
+	std::vector<std::pair<uint64_t, const std::byte*>> pending;
+	std::vector<uint32_t> ringEnds;
+	std::string line;
+	std::thread thread;
+	std::binary_semaphore wakeSem{0};
+	std::atomic_uint64_t seq{};
+	std::atomic_uint32_t totalDropped{};
+	std::atomic_bool wakePending{};
+	std::atomic_bool running{true};
+
+	void flushLocked()
+	{
+		pending.clear();
+		ringEnds.clear();
+		for(auto ring : rings)
+		{
+			auto r = ring->readPos.load(std::memory_order_relaxed);
+			auto w = ring->writePos.load(std::memory_order_acquire);
+			ringEnds.push_back(w);
+			while(r != w)
+			{
+				auto recordPtr = ring->data + (r % ThreadRing::capacity);
+				RecordHeader header;
+				memcpy(&header, recordPtr, sizeof(header));
+				if(!header.isPadding)
+					pending.emplace_back(header.seq, recordPtr);
+				r += header.size;
+			}
+		}
+		std::sort(pending.begin(), pending.end(), [](auto &a, auto &b){ return a.first < b.first; });
+		for(auto [seq, recordPtr] : pending)
+		{
+			line.clear();
+			formatRecord(line, recordPtr);
+			writeFormatted(LoggerSeverity(std::to_integer<uint8_t>(recordPtr[offsetof(RecordHeader, severity)])), line.c_str());
+		}
+		for(size_t i = 0; auto ring : rings)
+		{
+			ring->readPos.store(ringEnds[i++], std::memory_order_release);
+			if(auto dropped = ring->dropped.exchange(0, std::memory_order_relaxed); dropped)
+			{
+				totalDropped.fetch_add(dropped, std::memory_order_relaxed);
+				char str[64];
+				snprintf(str, sizeof(str), "Logger: dropped %u message(s)\n", dropped);
+				writeFormatted(LOGGER_WARNING, str);
+			}
+		}
+		std::erase_if(rings, [](ThreadRing *ring)
+		{
+			if(!ring->orphaned.load(std::memory_order_acquire) || ring->usedBytes())
+				return false;
+			delete ring;
+			return true;
+		});
+	}
+
+	void run()
+	{
+		using namespace std::chrono_literals;
+		while(running.load(std::memory_order_relaxed))
+		{
+			wakeSem.try_acquire_for(10ms);
+			wakePending.store(false, std::memory_order_relaxed);
+			flush();
+		}
+	}
+};
+
+static AsyncLogger &asyncLogger()
+{
+	static AsyncLogger logger;
+	return logger;
+}
+
+struct ThreadRingRef
+{
+	ThreadRing *ring{};
+
+	~ThreadRingRef()
+	{
+		if(ring)
+			ring->orphaned.store(true, std::memory_order_release);
+	}
+};
+
+static thread_local ThreadRingRef threadRing;
+
+bool pushAsync(LoggerSeverity severity, const char *msg, va_list args)
+{
+	if(asyncStopped.load(std::memory_order_relaxed)) [[unlikely]]
+		return false;
+	auto &logger = asyncLogger();
+	if(!threadRing.ring) [[unlikely]]
+		threadRing.ring = logger.registerThread();
+	auto &ring = *threadRing.ring;
+	alignas(recordAlign) std::byte record[maxRecordSize];
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	auto size = captureRecord(record, severity, msg, argsCopy);
+	va_end(argsCopy);
+	if(!size) [[unlikely]]
+	{
+		char str[4096];
+		vsnprintf(str, sizeof(str), msg, args);
+		logger.writeUnqueued(severity, str);
+		return true;
+	}
+	auto seq = logger.nextSeq();
+	memcpy(record + offsetof(RecordHeader, seq), &seq, sizeof(seq));
+	if(!ring.push(record, size))
+	{
+		ring.dropped.fetch_add(1, std::memory_order_relaxed);
+		logger.wake();
+		return true;
+	}
+	if(severity == LOGGER_ERROR || ring.usedBytes() > ThreadRing::capacity / 2)
+		logger.wake();
+	return true;
+}
+
+void flushAsync()
+{
+	if(asyncStopped.load(std::memory_order_relaxed))
+		return;
+	asyncLogger().flush();
+}
+
+void stopAsync()
+{
+	asyncLogger().stop();
+}
+
+uint32_t droppedAsyncMessages()
+{
+	return asyncLogger().droppedMessages();
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/logger/logger.h>
+#include <cstdarg>
+#include <cstdint>
+
+namespace IG::Log
+{
+
+// Each thread appends the format string & raw arguments of its messages to its own
+// single-producer ring, a background thread formats & writes them in order.
+// Messages too large for a record are formatted immediately & written after the queued ones.
+// Returns false if the logger was stopped and the message should be written synchronously.
+bool pushAsync(LoggerSeverity, const char *msg, va_list);
+// formats & writes all queued messages on the calling thread
+void flushAsync();
+void stopAsync();
+uint32_t droppedAsyncMessages();
+
+// writes an already formatted message to the log outputs, implemented by the logger backend
+void writeFormatted(LoggerSeverity, const char *str);
+
+}
@@ -1,7 +1,7 @@
 ifndef inc_logger_stdio
 inc_logger_stdio := 1
 
-SRC += logger/stdio/logger.cc
+SRC += logger/stdio/logger.cc logger/stdio/asyncLogger.cc
 
 ifeq ($(ENV), android)
  LDLIBS += -llog
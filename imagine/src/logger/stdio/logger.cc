@@ -16,6 +16,7 @@
 #define LOGTAG "LoggerStdio"
 #include <imagine/fs/FS.hh>
 #include <imagine/logger/logger.h>
+#include "asyncLogger.hh"
 #include <cstdio>
 #include <cstring>
 
@@ -35,6 +36,8 @@ static char logLineBuffer[512]{};
 uint8_t loggerVerbosity = loggerMaxVerbosity;
 static FILE *logExternalFile{};
 static bool logEnabled = Config::DEBUG_BUILD; // default logging off in release builds
+// release builds queue messages so logging doesn't stall the calling thread on output
+static bool logAsync = !Config::DEBUG_BUILD;
 
 static FS::PathString externalLogEnablePath(const char *dirStr)
 {
@@ -76,9 +79,33 @@ bool logger_isEnabled()
 	return logEnabled;
 }
 
-static void printToLogLineBuffer(const char* msg, va_list args)
+void logger_setAsync(bool async)
 {
-	vsnprintf(logLineBuffer + strlen(logLineBuffer), sizeof(logLineBuffer) - strlen(logLineBuffer), msg, args);
+	if(logAsync && !async)
+		IG::Log::flushAsync();
+	logAsync = async;
+}
+
+bool logger_isAsync()
+{
+	return logAsync;
+}
+
+void logger_flush()
+{
+	if(logAsync)
+		IG::Log::flushAsync();
+}
+
+uint32_t logger_droppedMessages()
+{
+	return IG::Log::droppedAsyncMessages();
+}
+
+static void printToLogLineBuffer(const char *str)
+{
+	auto len = strlen(logLineBuffer);
+	snprintf(logLineBuffer + len, sizeof(logLineBuffer) - len, "%s", str);
 }
 
 static int severityToLogLevel(LoggerSeverity severity)
@@ -118,51 +145,55 @@ static const char *severityToColorCode(LoggerSeverity severity)
 	}
 }
 
-void logger_vprintf(LoggerSeverity severity, const char* msg, va_list args)
+void IG::Log::writeFormatted(LoggerSeverity severity, const char *str)
 {
-	if(!logEnabled)
-		return;
-	if(severity > loggerVerbosity) return;
-
 	if(logExternalFile)
 	{
-		va_list args2;
-		va_copy(args2, args);
-		vfprintf(logExternalFile, msg, args2);
-		va_end(args2);
+		fputs(str, logExternalFile);
 		fflush(logExternalFile);
 	}
 
-	if(bufferLogLineOutput && !strchr(msg, '\n'))
+	if(bufferLogLineOutput && !strchr(str, '\n'))
 	{
-		printToLogLineBuffer(msg, args);
+		printToLogLineBuffer(str);
 		return;
 	}
 
 	#ifdef __ANDROID__
 	if(strlen(logLineBuffer))
 	{
-		printToLogLineBuffer(msg, args);
+		printToLogLineBuffer(str);
 		__android_log_write(severityToLogLevel(severity), "imagine", logLineBuffer);
 		logLineBuffer[0] = 0;
 	}
 	else
-		__android_log_vprint(severityToLogLevel(severity), "imagine", msg, args);
+		__android_log_write(severityToLogLevel(severity), "imagine", str);
 	#elif defined __APPLE__
 	if(strlen(logLineBuffer))
 	{
-		printToLogLineBuffer(msg, args);
+		printToLogLineBuffer(str);
 		asl_log(nullptr, nullptr, severityToLogLevel(severity), "%s", logLineBuffer);
 		logLineBuffer[0] = 0;
 	}
 	else
-		asl_vlog(nullptr, nullptr, severityToLogLevel(severity), msg, args);
+		asl_log(nullptr, nullptr, severityToLogLevel(severity), "%s", str);
 	#else
-	fprintf(stderr, "%s", severityToColorCode(severity));
-	vfprintf(stderr, msg, args);
+	fprintf(stderr, "%s%s", severityToColorCode(severity), str);
 	#endif
 }
 
+void logger_vprintf(LoggerSeverity severity, const char* msg, va_list args)
+{
+	if(!logEnabled)
+		return;
+	if(severity > loggerVerbosity) return;
+	if(logAsync && IG::Log::pushAsync(severity, msg, args))
+		return;
+	char str[4096];
+	vsnprintf(str, sizeof(str), msg, args);
+	IG::Log::writeFormatted(severity, str);
+}
+
 void logger_printf(LoggerSeverity severity, const char* msg, ...)
 {
 	if(!logEnabled)
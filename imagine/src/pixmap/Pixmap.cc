@@ -21,6 +21,14 @@
 #include <imagine/util/algorithm.h>
 #include <imagine/util/container/array.hh>
 #include <cstring>
+#include <type_traits>
+#if defined __SSE2__
+#include <emmintrin.h>
+#define IG_PIXMAP_CONVERT_SSE2
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define IG_PIXMAP_CONVERT_NEON
+#endif
 
 namespace IG
 {
@@ -78,27 +86,6 @@ static void convertRGB888ToBGRX8888(Pixmap dest, Pixmap src)
 	convertRGB888ToRGBX8888<true>(dest, src);
 }
 
-template <bool BGR_SWAP = false>
-static void convertRGB565ToRGBX8888(Pixmap dest, Pixmap src)
-{
-	dest.writeTransformed(
-		[](uint16_t p)
-		{
-			unsigned b = p       & 0x1F;
-			unsigned g = p >>  5 & 0x3F;
-			unsigned r = p >> 11 & 0x1F;
-			if constexpr(BGR_SWAP) { std::swap(r, b); }
-			return ((b * 255 + 15) / 31) << 16 |
-					((g * 255 + 31) / 63) << 8 |
-					((r * 255 + 15) / 31);
-		}, src);
-}
-
-static void convertRGB565ToBGRX8888(Pixmap dest, Pixmap src)
-{
-	return convertRGB565ToRGBX8888<true>(dest, src);
-}
-
 template <bool BGR_SWAP = false>
 static void convertRGBX8888ToRGB888(Pixmap dest, Pixmap src)
 {
@@ -154,34 +141,330 @@ static void convertRGB888ToRGB565(Pixmap dest, Pixmap src)
 		}, src);
 }
 
-template <bool BGR_SWAP = false>
-static void convertRGBX8888ToRGB565(Pixmap dest, Pixmap src)
+// RGB565, RGBX8888 & I8 conversions go through 8-bit red, green & blue channels,
+// with the SIMD paths giving the same results as the scalar ones
+template <PixelFormatID format>
+using PixelType = std::conditional_t<format == PIXEL_I8, uint8_t,
+	std::conditional_t<format == PIXEL_RGB565, uint16_t, uint32_t>>;
+
+struct RGBChannels
+{
+	unsigned r, g, b;
+};
+
+template <PixelFormatID format>
+static RGBChannels unpackPixel(PixelType<format> p)
+{
+	if constexpr(format == PIXEL_I8)
+	{
+		return {p, p, p};
+	}
+	else if constexpr(format == PIXEL_RGB565)
+	{
+		unsigned r = p >> 11 & 0x1F;
+		unsigned g = p >>  5 & 0x3F;
+		unsigned b = p       & 0x1F;
+		return {(r * 255 + 15) / 31, (g * 255 + 31) / 63, (b * 255 + 15) / 31};
+	}
+	else
+	{
+		unsigned r = p       & 0xFF;
+		unsigned g = p >>  8 & 0xFF;
+		unsigned b = p >> 16 & 0xFF;
+		if constexpr(format == PIXEL_BGRA8888) { std::swap(r, b); }
+		return {r, g, b};
+	}
+}
+
+template <PixelFormatID format>
+static PixelType<format> packPixel(RGBChannels c)
+{
+	if constexpr(format == PIXEL_I8)
+	{
+		return (c.r * 77 + c.g * 150 + c.b * 29 + 128) >> 8;
+	}
+	else if constexpr(format == PIXEL_RGB565)
+	{
+		return ((c.r * 31 + 127) / 255) << 11 |
+				((c.g * 63 + 127) / 255) << 5 |
+				((c.b * 31 + 127) / 255);
+	}
+	else
+	{
+		if constexpr(format == PIXEL_BGRA8888) { std::swap(c.r, c.b); }
+		return c.b << 16 | c.g << 8 | c.r;
+	}
+}
+
+#if defined IG_PIXMAP_CONVERT_SSE2
+
+static constexpr size_t convertVectorPixels = 8;
+static constexpr const char *convertSIMDName_ = "SSE2";
+
+// 8 pixels per vector of 16-bit channel values
+struct RGBVectors
+{
+	__m128i r, g, b;
+};
+
+// exact x / 255 for x < 65535
+static __m128i div255(__m128i x)
+{
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+template <PixelFormatID format>
+static RGBVectors loadPixels(const PixelType<format> *src)
 {
-	dest.writeTransformed(
-		[](uint32_t p)
+	if constexpr(format == PIXEL_I8)
+	{
+		auto i = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src), _mm_setzero_si128());
+		return {i, i, i};
+	}
+	else if constexpr(format == PIXEL_RGB565)
+	{
+		auto p = _mm_loadu_si128((const __m128i*)src);
+		auto r = _mm_srli_epi16(p, 11);
+		auto g = _mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3F));
+		auto b = _mm_and_si128(p, _mm_set1_epi16(0x1F));
+		// x / 31 as (x * 8457) >> 18 & x / 63 as (x * 16645) >> 20, exact for the ranges used
+		auto expand5 = [](__m128i x)
 		{
-			unsigned r = p       & 0xFF;
-			unsigned g = p >>  8 & 0xFF;
-			unsigned b = p >> 16 & 0xFF;
-			if constexpr(BGR_SWAP) { std::swap(r, b); }
-			return ((r * (31 * 2) + 255) / (255 * 2)) << 11 |
-					((g * 63 + 127) / 255) << 5 |
-					((b * 31 + 127) / 255);
-		}, src);
+			x = _mm_add_epi16(_mm_mullo_epi16(x, _mm_set1_epi16(255)), _mm_set1_epi16(15));
+			return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16(8457)), 2);
+		};
+		g = _mm_add_epi16(_mm_mullo_epi16(g, _mm_set1_epi16(255)), _mm_set1_epi16(31));
+		g = _mm_srli_epi16(_mm_mulhi_epu16(g, _mm_set1_epi16(16645)), 4);
+		return {expand5(r), g, expand5(b)};
+	}
+	else
+	{
+		auto p0 = _mm_loadu_si128((const __m128i*)src);
+		auto p1 = _mm_loadu_si128((const __m128i*)(src + 4));
+		auto mask = _mm_set1_epi32(0xFF);
+		auto channel = [&](int shift)
+		{
+			return _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, shift), mask),
+				_mm_and_si128(_mm_srli_epi32(p1, shift), mask));
+		};
+		auto r = channel(0);
+		auto g = channel(8);
+		auto b = channel(16);
+		if constexpr(format == PIXEL_BGRA8888) { std::swap(r, b); }
+		return {r, g, b};
+	}
 }
 
-static void convertRGBA8888ToBGRA8888(Pixmap dest, Pixmap src)
+template <PixelFormatID format>
+static void storePixels(PixelType<format> *dest, RGBVectors c)
 {
-	dest.writeTransformed(
-		[](uint32_t p)
+	if constexpr(format == PIXEL_I8)
+	{
+		auto y = _mm_add_epi16(_mm_mullo_epi16(c.r, _mm_set1_epi16(77)), _mm_mullo_epi16(c.g, _mm_set1_epi16(150)));
+		y = _mm_add_epi16(y, _mm_mullo_epi16(c.b, _mm_set1_epi16(29)));
+		y = _mm_srli_epi16(_mm_add_epi16(y, _mm_set1_epi16(128)), 8);
+		_mm_storel_epi64((__m128i*)dest, _mm_packus_epi16(y, y));
+	}
+	else if constexpr(format == PIXEL_RGB565)
+	{
+		auto r = div255(_mm_add_epi16(_mm_mullo_epi16(c.r, _mm_set1_epi16(31)), _mm_set1_epi16(127)));
+		auto g = div255(_mm_add_epi16(_mm_mullo_epi16(c.g, _mm_set1_epi16(63)), _mm_set1_epi16(127)));
+		auto b = div255(_mm_add_epi16(_mm_mullo_epi16(c.b, _mm_set1_epi16(31)), _mm_set1_epi16(127)));
+		auto p = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+		_mm_storeu_si128((__m128i*)dest, p);
+	}
+	else
+	{
+		if constexpr(format == PIXEL_BGRA8888) { std::swap(c.r, c.b); }
+		auto rg = _mm_or_si128(c.r, _mm_slli_epi16(c.g, 8));
+		_mm_storeu_si128((__m128i*)dest, _mm_unpacklo_epi16(rg, c.b));
+		_mm_storeu_si128((__m128i*)(dest + 4), _mm_unpackhi_epi16(rg, c.b));
+	}
+}
+
+static void swapRB(uint32_t * __restrict__ dest, const uint32_t * __restrict__ src, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 4 <= pixels; i += 4)
+	{
+		auto p = _mm_loadu_si128((const __m128i*)(src + i));
+		auto ag = _mm_and_si128(p, _mm_set1_epi32(0xFF00FF00));
+		auto rb = _mm_and_si128(p, _mm_set1_epi32(0x00FF00FF));
+		rb = _mm_shufflelo_epi16(_mm_shufflehi_epi16(rb, 0b10110001), 0b10110001);
+		_mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(ag, rb));
+	}
+	for(; i < pixels; i++)
+	{
+		auto p = src[i];
+		dest[i] = (p & 0xFF00FF00) | ((p & 0xFF0000) >> 16) | ((p & 0x0000FF) << 16);
+	}
+}
+
+#elif defined IG_PIXMAP_CONVERT_NEON
+
+static constexpr size_t convertVectorPixels = 8;
+static constexpr const char *convertSIMDName_ = "NEON";
+
+// 8 pixels per vector of 16-bit channel values
+struct RGBVectors
+{
+	uint16x8_t r, g, b;
+};
+
+// exact x / 255 for x < 65535
+static uint16x8_t div255(uint16x8_t x)
+{
+	return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+template <unsigned mul>
+static uint16x8_t mulHigh(uint16x8_t x)
+{
+	auto lo = vmull_n_u16(vget_low_u16(x), mul);
+	auto hi = vmull_n_u16(vget_high_u16(x), mul);
+	return vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16));
+}
+
+template <PixelFormatID format>
+static RGBVectors loadPixels(const PixelType<format> *src)
+{
+	if constexpr(format == PIXEL_I8)
+	{
+		auto i = vmovl_u8(vld1_u8(src));
+		return {i, i, i};
+	}
+	else if constexpr(format == PIXEL_RGB565)
+	{
+		auto p = vld1q_u16(src);
+		auto r = vshrq_n_u16(p, 11);
+		auto g = vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3F));
+		auto b = vandq_u16(p, vdupq_n_u16(0x1F));
+		// x / 31 as (x * 8457) >> 18 & x / 63 as (x * 16645) >> 20, exact for the ranges used
+		auto expand5 = [](uint16x8_t x)
 		{
-			return (p & 0xFF000000) | ((p & 0xFF0000) >> 16) | (p & 0x00FF00) | ((p & 0x0000FF) << 16);
-		}, src);
+			return vshrq_n_u16(mulHigh<8457>(vmlaq_n_u16(vdupq_n_u16(15), x, 255)), 2);
+		};
+		g = vshrq_n_u16(mulHigh<16645>(vmlaq_n_u16(vdupq_n_u16(31), g, 255)), 4);
+		return {expand5(r), g, expand5(b)};
+	}
+	else
+	{
+		auto p = vld4_u8((const uint8_t*)src);
+		auto r = vmovl_u8(p.val[0]);
+		auto g = vmovl_u8(p.val[1]);
+		auto b = vmovl_u8(p.val[2]);
+		if constexpr(format == PIXEL_BGRA8888) { std::swap(r, b); }
+		return {r, g, b};
+	}
 }
 
-static void convertBGRX8888ToRGB565(Pixmap dest, Pixmap src)
+template <PixelFormatID format>
+static void storePixels(PixelType<format> *dest, RGBVectors c)
 {
-	return convertRGBX8888ToRGB565<true>(dest, src);
+	if constexpr(format == PIXEL_I8)
+	{
+		auto y = vmlaq_n_u16(vmlaq_n_u16(vmulq_n_u16(c.r, 77), c.g, 150), c.b, 29);
+		vst1_u8(dest, vshrn_n_u16(vaddq_u16(y, vdupq_n_u16(128)), 8));
+	}
+	else if constexpr(format == PIXEL_RGB565)
+	{
+		auto r = div255(vmlaq_n_u16(vdupq_n_u16(127), c.r, 31));
+		auto g = div255(vmlaq_n_u16(vdupq_n_u16(127), c.g, 63));
+		auto b = div255(vmlaq_n_u16(vdupq_n_u16(127), c.b, 31));
+		vst1q_u16(dest, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b));
+	}
+	else
+	{
+		if constexpr(format == PIXEL_BGRA8888) { std::swap(c.r, c.b); }
+		uint8x8x4_t p{vmovn_u16(c.r), vmovn_u16(c.g), vmovn_u16(c.b), vdup_n_u8(0)};
+		vst4_u8((uint8_t*)dest, p);
+	}
+}
+
+static void swapRB(uint32_t * __restrict__ dest, const uint32_t * __restrict__ src, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto p = vld4q_u8((const uint8_t*)(src + i));
+		std::swap(p.val[0], p.val[2]);
+		vst4q_u8((uint8_t*)(dest + i), p);
+	}
+	for(; i < pixels; i++)
+	{
+		auto p = src[i];
+		dest[i] = (p & 0xFF00FF00) | ((p & 0xFF0000) >> 16) | ((p & 0x0000FF) << 16);
+	}
+}
+
+#else
+
+static constexpr size_t convertVectorPixels = 0;
+static constexpr const char *convertSIMDName_ = "Scalar";
+
+static void swapRB(uint32_t * __restrict__ dest, const uint32_t * __restrict__ src, size_t pixels)
+{
+	for(size_t i = 0; i < pixels; i++)
+	{
+		auto p = src[i];
+		dest[i] = (p & 0xFF00FF00) | ((p & 0xFF0000) >> 16) | ((p & 0x0000FF) << 16);
+	}
+}
+
+#endif
+
+template <PixelFormatID srcFormat, PixelFormatID destFormat>
+static void convertPixels(PixelType<destFormat> * __restrict__ dest, const PixelType<srcFormat> * __restrict__ src, size_t pixels)
+{
+	size_t i = 0;
+	if constexpr(convertVectorPixels)
+	{
+		for(; i + convertVectorPixels <= pixels; i += convertVectorPixels)
+		{
+			storePixels<destFormat>(dest + i, loadPixels<srcFormat>(src + i));
+		}
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = packPixel<destFormat>(unpackPixel<srcFormat>(src[i]));
+	}
+}
+
+// runs the kernel over the whole pixmap at once when neither side has row padding
+template <class Src, class Dest>
+static void convertRows(Pixmap dest, Pixmap src, auto &&convertFunc)
+{
+	if(dest.w() == src.w() && !dest.isPadded() && !src.isPadded())
+	{
+		convertFunc((Dest*)dest.data(), (const Src*)src.data(), size_t(src.w()) * src.h());
+	}
+	else
+	{
+		auto srcData = src.data();
+		auto destData = dest.data();
+		iterateTimes(src.h(), i)
+		{
+			convertFunc((Dest*)destData, (const Src*)srcData, src.w());
+			srcData += src.pitchBytes();
+			destData += dest.pitchBytes();
+		}
+	}
+}
+
+template <PixelFormatID srcFormat, PixelFormatID destFormat>
+static void convertPixmap(Pixmap dest, Pixmap src)
+{
+	convertRows<PixelType<srcFormat>, PixelType<destFormat>>(dest, src, convertPixels<srcFormat, destFormat>);
+}
+
+static void convertRGBA8888ToBGRA8888(Pixmap dest, Pixmap src)
+{
+	convertRows<uint32_t, uint32_t>(dest, src, swapRB);
+}
+
+const char *Pixmap::convertSIMDName()
+{
+	return convertSIMDName_;
 }
 
 void Pixmap::writeConverted(Pixmap pixmap)
@@ -198,7 +481,8 @@ void Pixmap::writeConverted(Pixmap pixmap)
 			switch(srcFormatID)
 			{
 				case PIXEL_BGRA8888: return convertRGBA8888ToBGRA8888(*this, pixmap);
-				case PIXEL_RGB565: return convertRGB565ToRGBX8888(*this, pixmap);
+				case PIXEL_RGB565: return convertPixmap<PIXEL_RGB565, PIXEL_RGBA8888>(*this, pixmap);
+				case PIXEL_I8: return convertPixmap<PIXEL_I8, PIXEL_RGBA8888>(*this, pixmap);
 				case PIXEL_RGB888: return convertRGB888ToRGBX8888(*this, pixmap);
 				default: return invalidFormatConversion(*this, pixmap);
 			}
@@ -206,7 +490,8 @@ void Pixmap::writeConverted(Pixmap pixmap)
 			switch(srcFormatID)
 			{
 				case PIXEL_RGBA8888: return convertRGBA8888ToBGRA8888(*this, pixmap);
-				case PIXEL_RGB565: return convertRGB565ToBGRX8888(*this, pixmap);
+				case PIXEL_RGB565: return convertPixmap<PIXEL_RGB565, PIXEL_BGRA8888>(*this, pixmap);
+				case PIXEL_I8: return convertPixmap<PIXEL_I8, PIXEL_BGRA8888>(*this, pixmap);
 				case PIXEL_RGB888: return convertRGB888ToBGRX8888(*this, pixmap);
 				default: return invalidFormatConversion(*this, pixmap);
 			}
@@ -221,11 +506,20 @@ void Pixmap::writeConverted(Pixmap pixmap)
 		case PIXEL_RGB565:
 			switch(srcFormatID)
 			{
-				case PIXEL_RGBA8888: return convertRGBX8888ToRGB565(*this, pixmap);
-				case PIXEL_BGRA8888: return convertBGRX8888ToRGB565(*this, pixmap);
+				case PIXEL_RGBA8888: return convertPixmap<PIXEL_RGBA8888, PIXEL_RGB565>(*this, pixmap);
+				case PIXEL_BGRA8888: return convertPixmap<PIXEL_BGRA8888, PIXEL_RGB565>(*this, pixmap);
+				case PIXEL_I8: return convertPixmap<PIXEL_I8, PIXEL_RGB565>(*this, pixmap);
 				case PIXEL_RGB888: return convertRGB888ToRGB565(*this, pixmap);
 				default: return invalidFormatConversion(*this, pixmap);
 			}
+		case PIXEL_I8:
+			switch(srcFormatID)
+			{
+				case PIXEL_RGBA8888: return convertPixmap<PIXEL_RGBA8888, PIXEL_I8>(*this, pixmap);
+				case PIXEL_BGRA8888: return convertPixmap<PIXEL_BGRA8888, PIXEL_I8>(*this, pixmap);
+				case PIXEL_RGB565: return convertPixmap<PIXEL_RGB565, PIXEL_I8>(*this, pixmap);
+				default: return invalidFormatConversion(*this, pixmap);
+			}
 		default:
 			return invalidFormatConversion(*this, pixmap);
 	}
@@ -0,0 +1,348 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/pixmap/Pixmap.hh>
+#include <imagine/util/utility.h>
+#include <imagine/util/algorithm.h>
+#if defined __SSE2__
+#include <immintrin.h>
+#define IG_PIXMAP_LOOKUP_X86
+#elif defined __ARM_NEON && defined __aarch64__
+#include <arm_neon.h>
+#define IG_PIXMAP_LOOKUP_NEON
+#endif
+
+namespace IG
+{
+
+// Palette plus any tables derived from it by the selected kernel,
+// built once per writeLookup() call and shared by every row
+template <class Dest>
+struct LookupTable
+{
+	std::span<const Dest> palette;
+	#if defined IG_PIXMAP_LOOKUP_X86
+	union
+	{
+		alignas(32) uint8_t planes[sizeof(Dest)][16]; // SSSE3 shuffle, one byte of each color per plane
+		alignas(32) int wide[256]; // AVX2 gather of 16-bit colors
+	};
+	#elif defined IG_PIXMAP_LOOKUP_NEON
+	alignas(16) uint8_t planes[sizeof(Dest)][256];
+	#endif
+
+	constexpr LookupTable(std::span<const Dest> palette): palette{palette} {}
+
+	#if defined IG_PIXMAP_LOOKUP_X86 || defined IG_PIXMAP_LOOKUP_NEON
+	void makePlanes()
+	{
+		constexpr size_t entries = std::extent_v<decltype(planes), 1>;
+		std::fill_n(&planes[0][0], sizeof(planes), 0);
+		for(size_t i = 0; i < std::min(palette.size(), entries); i++)
+		{
+			for(size_t b = 0; b < sizeof(Dest); b++)
+			{
+				planes[b][i] = palette[i] >> (b * 8);
+			}
+		}
+	}
+	#endif
+};
+
+// Each kernel converts a run of pixels, src & dest never overlap
+template <class Src, class Dest>
+using LookupFunc = void(*)(Dest * __restrict__ dest, const Src * __restrict__ src, size_t pixels, const LookupTable<Dest> &table);
+
+template <class Src, class Dest>
+static void lookupScalar(Dest * __restrict__ dest, const Src * __restrict__ src, size_t pixels, std::span<const Dest> palette)
+{
+	auto pal = palette.data();
+	for(size_t i = 0; i < pixels; i++)
+	{
+		dest[i] = pal[src[i]];
+	}
+}
+
+template <class Src, class Dest>
+static void lookupScalar(Dest * __restrict__ dest, const Src * __restrict__ src, size_t pixels, const LookupTable<Dest> &table)
+{
+	lookupScalar<Src, Dest>(dest, src, pixels, table.palette);
+}
+
+#if defined IG_PIXMAP_LOOKUP_X86
+
+// palettes with at most 16 entries fit in one register per byte of the color,
+// so pshufb looks up 16 pixels at once
+template <class Dest>
+[[gnu::target("ssse3")]]
+static void lookup8Shuffle(Dest * __restrict__ dest, const uint8_t * __restrict__ src, size_t pixels, const LookupTable<Dest> &table)
+{
+	auto &planes = table.planes;
+	size_t i = 0;
+	if constexpr(sizeof(Dest) == 2)
+	{
+		auto lo = _mm_load_si128((const __m128i*)planes[0]);
+		auto hi = _mm_load_si128((const __m128i*)planes[1]);
+		for(; i + 16 <= pixels; i += 16)
+		{
+			auto idx = _mm_loadu_si128((const __m128i*)(src + i));
+			auto l = _mm_shuffle_epi8(lo, idx);
+			auto h = _mm_shuffle_epi8(hi, idx);
+			_mm_storeu_si128((__m128i*)(dest + i), _mm_unpacklo_epi8(l, h));
+			_mm_storeu_si128((__m128i*)(dest + i + 8), _mm_unpackhi_epi8(l, h));
+		}
+	}
+	else
+	{
+		auto p0 = _mm_load_si128((const __m128i*)planes[0]);
+		auto p1 = _mm_load_si128((const __m128i*)planes[1]);
+		auto p2 = _mm_load_si128((const __m128i*)planes[2]);
+		auto p3 = _mm_load_si128((const __m128i*)planes[3]);
+		for(; i + 16 <= pixels; i += 16)
+		{
+			auto idx = _mm_loadu_si128((const __m128i*)(src + i));
+			auto b0 = _mm_shuffle_epi8(p0, idx);
+			auto b1 = _mm_shuffle_epi8(p1, idx);
+			auto b2 = _mm_shuffle_epi8(p2, idx);
+			auto b3 = _mm_shuffle_epi8(p3, idx);
+			auto lo01 = _mm_unpacklo_epi8(b0, b1);
+			auto hi01 = _mm_unpackhi_epi8(b0, b1);
+			auto lo23 = _mm_unpacklo_epi8(b2, b3);
+			auto hi23 = _mm_unpackhi_epi8(b2, b3);
+			_mm_storeu_si128((__m128i*)(dest + i), _mm_unpacklo_epi16(lo01, lo23));
+			_mm_storeu_si128((__m128i*)(dest + i + 4), _mm_unpackhi_epi16(lo01, lo23));
+			_mm_storeu_si128((__m128i*)(dest + i + 8), _mm_unpacklo_epi16(hi01, hi23));
+			_mm_storeu_si128((__m128i*)(dest + i + 12), _mm_unpackhi_epi16(hi01, hi23));
+		}
+	}
+	lookupScalar<uint8_t, Dest>(dest + i, src + i, pixels - i, table.palette);
+}
+
+template <class Src>
+[[gnu::target("avx2")]]
+static __m256i loadIndexesAVX2(const Src *src)
+{
+	if constexpr(sizeof(Src) == 1)
+		return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src));
+	else
+		return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src));
+}
+
+template <class Src>
+[[gnu::target("avx2")]]
+static void lookupGather32(uint32_t * __restrict__ dest, const Src * __restrict__ src, size_t pixels, const LookupTable<uint32_t> &table)
+{
+	auto pal = (const int*)table.palette.data();
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto c0 = _mm256_i32gather_epi32(pal, loadIndexesAVX2(src + i), 4);
+		auto c1 = _mm256_i32gather_epi32(pal, loadIndexesAVX2(src + i + 8), 4);
+		_mm256_storeu_si256((__m256i*)(dest + i), c0);
+		_mm256_storeu_si256((__m256i*)(dest + i + 8), c1);
+	}
+	lookupScalar<Src, uint32_t>(dest + i, src + i, pixels - i, table.palette);
+}
+
+// a 32-bit gather of a 16-bit palette would read past its last entry,
+// so gather from a copy widened to 32-bits, only practical with 8-bit indexes
+[[gnu::target("avx2")]]
+static void lookup8Gather16(uint16_t * __restrict__ dest, const uint8_t * __restrict__ src, size_t pixels, const LookupTable<uint16_t> &table)
+{
+	auto wide = table.wide;
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto c0 = _mm256_i32gather_epi32(wide, loadIndexesAVX2(src + i), 4);
+		auto c1 = _mm256_i32gather_epi32(wide, loadIndexesAVX2(src + i + 8), 4);
+		// packing works within 128-bit lanes, reorder the 64-bit blocks afterwards
+		auto c = _mm256_permute4x64_epi64(_mm256_packus_epi32(c0, c1), 0b11011000);
+		_mm256_storeu_si256((__m256i*)(dest + i), c);
+	}
+	lookupScalar<uint8_t, uint16_t>(dest + i, src + i, pixels - i, table.palette);
+}
+
+static bool cpuHasSSSE3()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3");
+}
+
+static bool cpuHasAVX2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+static const bool hasSSSE3 = cpuHasSSSE3();
+static const bool hasAVX2 = cpuHasAVX2();
+
+// selects the kernel for the palette & builds the tables it needs
+template <class Src, class Dest>
+static LookupFunc<Src, Dest> lookupFunc(LookupTable<Dest> &table)
+{
+	if constexpr(sizeof(Src) == 1)
+	{
+		if(table.palette.size() <= 16 && hasSSSE3)
+		{
+			table.makePlanes();
+			return lookup8Shuffle<Dest>;
+		}
+		if(hasAVX2)
+		{
+			if constexpr(sizeof(Dest) == 2)
+			{
+				std::fill_n(table.wide, 256, 0);
+				std::copy_n(table.palette.data(), std::min(table.palette.size(), size_t(256)), table.wide);
+				return lookup8Gather16;
+			}
+			else
+				return lookupGather32<Src>;
+		}
+	}
+	else if constexpr(sizeof(Dest) == 4)
+	{
+		if(hasAVX2)
+			return lookupGather32<Src>;
+	}
+	return lookupScalar<Src, Dest>;
+}
+
+const char *Pixmap::lookupSIMDName()
+{
+	if(hasAVX2)
+		return "AVX2";
+	if(hasSSSE3)
+		return "SSSE3";
+	return "Scalar";
+}
+
+#elif defined IG_PIXMAP_LOOKUP_NEON
+
+// Each byte of the colors is looked up separately from a table of up to 256 bytes,
+// 64 bytes at a time with tbx leaving out of range lanes unchanged, then
+// the bytes are interleaved back into pixels by the store
+template <size_t segments>
+static uint8x16_t lookupPlane(const uint8_t *plane, uint8x16_t idx)
+{
+	auto r = vqtbl4q_u8(vld1q_u8_x4(plane), idx);
+	if constexpr(segments > 1)
+		r = vqtbx4q_u8(r, vld1q_u8_x4(plane + 64), vsubq_u8(idx, vdupq_n_u8(64)));
+	if constexpr(segments > 2)
+		r = vqtbx4q_u8(r, vld1q_u8_x4(plane + 128), vsubq_u8(idx, vdupq_n_u8(128)));
+	if constexpr(segments > 3)
+		r = vqtbx4q_u8(r, vld1q_u8_x4(plane + 192), vsubq_u8(idx, vdupq_n_u8(192)));
+	return r;
+}
+
+template <class Dest, size_t segments>
+static void lookup8Table(Dest * __restrict__ dest, const uint8_t * __restrict__ src, size_t pixels, const LookupTable<Dest> &table)
+{
+	auto &planes = table.planes;
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto idx = vld1q_u8(src + i);
+		if constexpr(sizeof(Dest) == 2)
+		{
+			uint8x16x2_t c{lookupPlane<segments>(planes[0], idx), lookupPlane<segments>(planes[1], idx)};
+			vst2q_u8((uint8_t*)(dest + i), c);
+		}
+		else
+		{
+			uint8x16x4_t c{lookupPlane<segments>(planes[0], idx), lookupPlane<segments>(planes[1], idx),
+				lookupPlane<segments>(planes[2], idx), lookupPlane<segments>(planes[3], idx)};
+			vst4q_u8((uint8_t*)(dest + i), c);
+		}
+	}
+	lookupScalar<uint8_t, Dest>(dest + i, src + i, pixels - i, table.palette);
+}
+
+// selects the kernel for the palette & builds the tables it needs
+template <class Src, class Dest>
+static LookupFunc<Src, Dest> lookupFunc(LookupTable<Dest> &table)
+{
+	if constexpr(sizeof(Src) == 1)
+	{
+		table.makePlanes();
+		auto paletteSize = table.palette.size();
+		if(paletteSize <= 64)
+			return lookup8Table<Dest, 1>;
+		if(paletteSize <= 128)
+			return lookup8Table<Dest, 2>;
+		if(paletteSize <= 192)
+			return lookup8Table<Dest, 3>;
+		return lookup8Table<Dest, 4>;
+	}
+	return lookupScalar<Src, Dest>;
+}
+
+const char *Pixmap::lookupSIMDName() { return "NEON"; }
+
+#else
+
+template <class Src, class Dest>
+static LookupFunc<Src, Dest> lookupFunc(LookupTable<Dest> &) { return lookupScalar<Src, Dest>; }
+
+const char *Pixmap::lookupSIMDName() { return "Scalar"; }
+
+#endif
+
+template <class Src, class Dest>
+static void writeLookupRows(Pixmap dest, Pixmap src, std::span<const Dest> palette)
+{
+	LookupTable<Dest> table{palette};
+	auto func = lookupFunc<Src, Dest>(table);
+	auto srcData = (const Src*)src.data();
+	auto destData = (Dest*)dest.data();
+	if(dest.w() == src.w() && !dest.isPadded() && !src.isPadded())
+	{
+		func(destData, srcData, src.w() * src.h(), table);
+	}
+	else
+	{
+		auto destPitchPixels = dest.pitchPixels();
+		iterateTimes(src.h(), h)
+		{
+			func(destData, srcData, src.w(), table);
+			srcData += src.pitchPixels();
+			destData += destPitchPixels;
+		}
+	}
+}
+
+template <class Dest>
+static void writeLookupImpl(Pixmap dest, Pixmap src, std::span<const Dest> palette)
+{
+	assumeExpr(dest.format().bytesPerPixel() == sizeof(Dest));
+	switch(src.format().bytesPerPixel())
+	{
+		case 1: return writeLookupRows<uint8_t, Dest>(dest, src, palette);
+		case 2: return writeLookupRows<uint16_t, Dest>(dest, src, palette);
+		default: bug_unreachable("invalid source bytes per pixel:%d", src.format().bytesPerPixel());
+	}
+}
+
+void Pixmap::writeLookup(std::span<const uint16_t> palette, Pixmap pixmap)
+{
+	writeLookupImpl<uint16_t>(*this, pixmap, palette);
+}
+
+void Pixmap::writeLookup(std::span<const uint32_t> palette, Pixmap pixmap)
+{
+	writeLookupImpl<uint32_t>(*this, pixmap, palette);
+}
+
+}
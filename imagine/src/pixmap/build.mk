@@ -1,6 +1,8 @@
 ifndef inc_pixmap
 inc_pixmap := 1
 
-SRC += pixmap/Pixmap.cc
+SRC += \
+ pixmap/Pixmap.cc \
+ pixmap/PixmapLookup.cc
 
 endif
@@ -75,6 +75,13 @@ FrameRateTestApplication::FrameRateTestApplication(IG::ApplicationInitParams ini
 			auto &winData = win.makeAppData<WindowData>(IG::ViewAttachParams{viewManager, win, renderer.task()});
 			std::vector<TestDesc> testDesc;
 			testDesc.emplace_back(TEST_CLEAR, "Clear");
+			testDesc.emplace_back(TEST_DISPATCH, "Message Dispatch");
+			testDesc.emplace_back(TEST_RESAMPLE, "Audio Resample");
+			testDesc.emplace_back(TEST_ARCHIVE, "Archive Random Access");
+			testDesc.emplace_back(TEST_LOOKUP, "Palette Lookup");
+			testDesc.emplace_back(TEST_CONVERT, "Pixel Conversion");
+			testDesc.emplace_back(TEST_AUDIO_FORMAT, "Audio Format Conversion");
+			testDesc.emplace_back(TEST_THREAD_JITTER, "Thread Jitter");
 			IG::WP pixmapSize{256, 256};
 			for(auto desc: renderer.textureBufferModes())
 			{
@@ -309,6 +316,20 @@ TestFramework *FrameRateTestApplication::startTest(IG::Window &win, const TestPa
 			activeTest = std::make_unique<DrawTest>();
 		bcase TEST_WRITE:
 			activeTest = std::make_unique<WriteTest>();
+		bcase TEST_DISPATCH:
+			activeTest = std::make_unique<DispatchTest>();
+		bcase TEST_RESAMPLE:
+			activeTest = std::make_unique<ResampleTest>();
+		bcase TEST_ARCHIVE:
+			activeTest = std::make_unique<ArchiveTest>();
+		bcase TEST_LOOKUP:
+			activeTest = std::make_unique<LookupTest>();
+		bcase TEST_CONVERT:
+			activeTest = std::make_unique<ConvertTest>();
+		bcase TEST_AUDIO_FORMAT:
+			activeTest = std::make_unique<AudioFormatTest>();
+		bcase TEST_THREAD_JITTER:
+			activeTest = std::make_unique<ThreadJitterTest>();
 	}
 	activeTest->init(app, renderer, face, t.pixmapSize, t.bufferMode);
 	app.setIdleDisplayPowerSave(false);
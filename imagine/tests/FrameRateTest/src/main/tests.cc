@@ -22,9 +22,18 @@
 #include <imagine/util/format.hh>
 #include <imagine/base/Window.hh>
 #include <imagine/base/Screen.hh>
+#include <imagine/base/EventLoop.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/io/ArchiveIO.hh>
+#include <imagine/io/MapIO.hh>
+#include <imagine/fs/ArchiveFS.hh>
 #include <imagine/logger/logger.h>
 #include "tests.hh"
 #include "cpuUtils.hh"
+#include <archive.h>
+#include <archive_entry.h>
+#include <random>
+#include <cmath>
 
 namespace FrameRateTest
 {
@@ -36,6 +45,13 @@ const char *testIDToStr(TestID id)
 		case TEST_CLEAR: return "Clear";
 		case TEST_DRAW: return "Draw";
 		case TEST_WRITE: return "Write";
+		case TEST_DISPATCH: return "Dispatch";
+		case TEST_RESAMPLE: return "Resample";
+		case TEST_ARCHIVE: return "Archive";
+		case TEST_LOOKUP: return "Lookup";
+		case TEST_CONVERT: return "Convert";
+		case TEST_AUDIO_FORMAT: return "Audio Format";
+		case TEST_THREAD_JITTER: return "Thread Jitter";
 		default: return "Unknown";
 	}
 }
@@ -328,4 +344,773 @@ void WriteTest::drawTest(Gfx::RendererCommands &cmds, Gfx::ClipRect bounds)
 	sprite.draw(cmds);
 }
 
+void TextResultTest::initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP, Gfx::TextureBufferMode)
+{
+	resultText = {cpuStatsText.face()};
+}
+
+void TextResultTest::placeTest(const Gfx::GCRect &rect)
+{
+	resultRect = rect;
+}
+
+void TextResultTest::drawTest(Gfx::RendererCommands &cmds, Gfx::ClipRect bounds)
+{
+	using namespace IG::Gfx;
+	ClearTest::drawTest(cmds, bounds);
+	if(!resultText.isVisible())
+		return;
+	cmds.setCommonProgram(CommonProgram::TEX_ALPHA);
+	cmds.setBlendMode(BLEND_MODE_ALPHA);
+	cmds.setColor(1., 1., 1., 1.);
+	resultText.draw(cmds, projP.alignXToPixel(resultRect.xCenter()),
+		projP.alignYToPixel(resultRect.yCenter()), C2DO, projP);
+}
+
+DispatchTest::~DispatchTest()
+{
+	if(pipeThread.joinable())
+	{
+		pipePort.send({.exit = true});
+		pipeThread.join();
+	}
+	if(spscThread.joinable())
+	{
+		spscPort.send({.exit = true});
+		spscThread.join();
+	}
+}
+
+void DispatchTest::initTest(IG::ApplicationContext ctx, Gfx::Renderer &r, IG::WP pixmapSize, Gfx::TextureBufferMode bufferMode)
+{
+	TextResultTest::initTest(ctx, r, pixmapSize, bufferMode);
+	pipeThread = IG::makeThreadSync(
+		[this](auto &sem)
+		{
+			auto eventLoop = IG::EventLoop::makeForThread();
+			bool started = true;
+			pipePort.attach(eventLoop,
+				[&started](auto msgs)
+				{
+					for(auto msg : msgs)
+					{
+						if(msg.exit)
+						{
+							started = false;
+							IG::EventLoop::forThread().stop();
+							return false;
+						}
+						msg.semPtr->release();
+					}
+					return true;
+				});
+			sem.release();
+			eventLoop.run(started);
+			pipePort.detach();
+		});
+	spscThread = std::thread
+	{
+		[this]()
+		{
+			while(true)
+			{
+				auto msg = spscPort.receive();
+				if(msg.exit)
+					return;
+				msg.semPtr->release();
+			}
+		}
+	};
+}
+
+void DispatchTest::frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime)
+{
+	ClearTest::frameUpdateTest(rendererTask, screen, frameTime);
+	// the first message of each frame finds the receiver idle since the last frame,
+	// like a frame dispatch, the rest measure back-to-back messages
+	auto measure = [&](auto &port, IG::Time &idleTime, IG::Time &burstTime)
+	{
+		idleTime += IG::timeFunc([&](){ port.send(DispatchMessage{}, true); });
+		burstTime += IG::timeFunc(
+			[&]()
+			{
+				iterateTimes(burstMessages, i)
+				{
+					port.send(DispatchMessage{}, true);
+				}
+			});
+	};
+	measure(pipePort, pipeIdleTime, pipeBurstTime);
+	measure(spscPort, spscIdleTime, spscBurstTime);
+	if(++samples == 60)
+	{
+		auto usecs = [&](IG::Time t, unsigned msgs)
+		{
+			return std::chrono::duration<double, std::micro>{t}.count() / msgs;
+		};
+		resultText.setString(fmt::format("Pipe Round Trip: {:.2f}us ({:.2f}us burst)\nSPSC Round Trip: {:.2f}us ({:.2f}us burst)",
+			usecs(pipeIdleTime, samples), usecs(pipeBurstTime, samples * burstMessages),
+			usecs(spscIdleTime, samples), usecs(spscBurstTime, samples * burstMessages)));
+		resultText.compile(rendererTask.renderer(), projP);
+		pipeIdleTime = pipeBurstTime = spscIdleTime = spscBurstTime = {};
+		samples = 0;
+	}
+}
+
+// sizes that leave each SIMD kernel a partial vector to finish with its scalar loop
+static constexpr int verifyLengths[]{1, 7, 8, 15, 16, 17, 31, 33, 63, 65, 257};
+
+static std::string simdCheckResult(std::string mismatch)
+{
+	if(mismatch.empty())
+		return "SIMD check: OK";
+	logErr("SIMD check failed: %s", mismatch.c_str());
+	return fmt::format("SIMD check FAILED: {}", mismatch);
+}
+
+// compares int16 samples within 1 for rounding differences & float samples within floatTolerance
+static bool sampleMatches(const void *a, const void *b, IG::Audio::SampleFormat fmt, float floatTolerance)
+{
+	if(fmt.isFloat())
+		return std::abs(*(const float*)a - *(const float*)b) <= floatTolerance;
+	return std::abs(*(const int16_t*)a - *(const int16_t*)b) <= 1;
+}
+
+// runs two resamplers on the same random blocks, one with the SIMD kernels & one with the scalar ones
+static std::string verifyResampler()
+{
+	using namespace IG::Audio;
+	std::minstd_rand rng{2};
+	std::uniform_real_distribution<float> dist{-1.f, 1.f};
+	constexpr std::pair<uint32_t, uint32_t> blocks[]{{801, 400}, {333, 331}, {17, 5}, {803, 803}, {1601, 201}};
+	for(auto quality : {ResamplerQuality::MEDIUM, ResamplerQuality::HIGH})
+	{
+		for(auto sampleFmt : {SampleFormats::i16, SampleFormats::f32})
+		{
+			for(uint8_t channels : {1, 2})
+			{
+				const Format format{48000, sampleFmt, channels};
+				Resampler simd, scalar;
+				simd.setQuality(quality);
+				scalar.setQuality(quality);
+				for(auto [srcFrames, destFrames] : blocks)
+				{
+					std::vector<float> srcF32(srcFrames * channels);
+					std::vector<int16_t> srcI16(srcF32.size());
+					iterateTimes(srcF32.size(), i)
+					{
+						srcF32[i] = dist(rng);
+						srcI16[i] = srcF32[i] * 32767.f;
+					}
+					const void *src = sampleFmt.isFloat() ? (const void*)srcF32.data() : (const void*)srcI16.data();
+					std::vector<float> simdOut(destFrames * channels), scalarOut(simdOut.size());
+					simd.resample(simdOut.data(), destFrames, src, srcFrames, format);
+					Resampler::setUseSIMD(false);
+					scalar.resample(scalarOut.data(), destFrames, src, srcFrames, format);
+					Resampler::setUseSIMD(true);
+					iterateTimes(simdOut.size(), i)
+					{
+						auto offset = i * sampleFmt.bytes();
+						if(!sampleMatches((uint8_t*)simdOut.data() + offset, (uint8_t*)scalarOut.data() + offset, sampleFmt, 1e-4f))
+						{
+							return fmt::format("{} {}ch {}->{} frames, sample {}", (unsigned)quality,
+								channels, srcFrames, destFrames, i);
+						}
+					}
+				}
+			}
+		}
+	}
+	return {};
+}
+
+// runs op on random frames with padded rows for each width in verifyLengths & compares every pixel
+// to running op on that pixel alone, which always takes the scalar path, srcMax limits the source values
+template<class Op>
+static std::string verifyPixmapOp(const char *name, IG::PixelFormat srcFormat, IG::PixelFormat destFormat,
+	unsigned srcMax, Op op)
+{
+	std::minstd_rand rng{2};
+	constexpr int height = 3;
+	constexpr uint8_t padByte = 0xA5;
+	const int srcBpp = srcFormat.bytesPerPixel();
+	const int destBpp = destFormat.bytesPerPixel();
+	for(int width : verifyLengths)
+	{
+		const int srcPitch = width + 5, destPitch = width + 3;
+		std::vector<uint8_t> srcPixels(srcPitch * height * srcBpp);
+		if(srcBpp == 2)
+		{
+			std::span<uint16_t> pixels{(uint16_t*)srcPixels.data(), srcPixels.size() / 2};
+			for(auto &p : pixels) { p = rng() % srcMax; }
+		}
+		else
+		{
+			for(auto &p : srcPixels) { p = rng() % srcMax; }
+		}
+		std::vector<uint8_t> destPixels(destPitch * height * destBpp, padByte);
+		IG::Pixmap src{{{width, height}, srcFormat}, srcPixels.data(), {srcPitch, IG::Pixmap::Units::PIXEL}};
+		IG::Pixmap dest{{{width, height}, destFormat}, destPixels.data(), {destPitch, IG::Pixmap::Units::PIXEL}};
+		op(dest, src);
+		iterateTimes(height, y)
+		{
+			iterateTimes(destPitch, x)
+			{
+				auto destPixel = &destPixels[(y * destPitch + x) * destBpp];
+				std::array<uint8_t, 4> expected;
+				expected.fill(padByte);
+				if((int)x < width)
+				{
+					IG::Pixmap srcPix{{{1, 1}, srcFormat}, &srcPixels[(y * srcPitch + x) * srcBpp]};
+					op(IG::Pixmap{{{1, 1}, destFormat}, expected.data()}, srcPix);
+				}
+				if(!std::equal(destPixel, destPixel + destBpp, expected.data()))
+				{
+					return fmt::format("{} width {}, pixel {},{}", name, width, x, y);
+				}
+			}
+		}
+	}
+	return {};
+}
+
+// copies random mono samples in runs of each length in verifyLengths & compares every
+// sample to copying it alone, which always takes the scalar path
+static std::string verifyCopyFrames(const char *name, IG::Audio::SampleFormat srcFmt,
+	IG::Audio::SampleFormat destFmt, float volume)
+{
+	std::minstd_rand rng{2};
+	std::uniform_real_distribution<float> dist{-1.2f, 1.2f};
+	const IG::Audio::Format srcFormat{48000, srcFmt, 1};
+	const IG::Audio::Format destFormat{48000, destFmt, 1};
+	for(int frames : verifyLengths)
+	{
+		std::vector<float> srcF32(frames);
+		std::vector<int16_t> srcI16(frames);
+		for(auto &s : srcF32) { s = dist(rng); }
+		for(auto &s : srcI16) { s = rng(); }
+		const void *src = srcFmt.isFloat() ? (const void*)srcF32.data() : (const void*)srcI16.data();
+		std::vector<float> dest(frames);
+		destFormat.copyFrames(dest.data(), src, frames, srcFormat, volume);
+		iterateTimes(frames, i)
+		{
+			float expected{};
+			destFormat.copyFrames(&expected, (const uint8_t*)src + i * srcFmt.bytes(), 1, srcFormat, volume);
+			if(!sampleMatches((uint8_t*)dest.data() + i * destFmt.bytes(), &expected, destFmt, 1e-6f))
+			{
+				return fmt::format("{} length {}, sample {}", name, frames, i);
+			}
+		}
+	}
+	return {};
+}
+
+void ResampleTest::initTest(IG::ApplicationContext ctx, Gfx::Renderer &r, IG::WP pixmapSize, Gfx::TextureBufferMode bufferMode)
+{
+	TextResultTest::initTest(ctx, r, pixmapSize, bufferMode);
+	iterateTimes(qualities, i)
+	{
+		resamplers[i].setQuality((IG::Audio::ResamplerQuality)i);
+	}
+	// 1KHz tone plus a 15KHz tone that aliases without filtering
+	srcSamples.resize(srcFrames * 2);
+	iterateTimes(srcFrames, i)
+	{
+		float t = i / 48000.f;
+		int16_t s = 12000.f * std::sin(2.f * M_PI * 1000.f * t) + 4000.f * std::sin(2.f * M_PI * 15000.f * t);
+		srcSamples[i * 2] = srcSamples[i * 2 + 1] = s;
+	}
+	destSamples.resize(srcFrames);
+	verifyStr = simdCheckResult(verifyResampler());
+}
+
+void ResampleTest::frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime)
+{
+	ClearTest::frameUpdateTest(rendererTask, screen, frameTime);
+	const IG::Audio::Format format{48000, IG::Audio::SampleFormats::i16, 2};
+	iterateTimes(qualities, i)
+	{
+		times[i] += IG::timeFunc(
+			[&]()
+			{
+				iterateTimes(blocksPerFrame, b)
+				{
+					resamplers[i].resample(destSamples.data(), srcFrames / 2, srcSamples.data(), srcFrames, format);
+				}
+			});
+	}
+	if(++samples == 60)
+	{
+		auto mSamplesPerSec = [&](IG::Time t)
+		{
+			double totalSamples = samples * blocksPerFrame * srcFrames * 2;
+			return totalSamples / std::chrono::duration<double>{t}.count() / 1e6;
+		};
+		resultText.setString(fmt::format("Resampler ({})\n{}\nFast: {:.1f} MSamples/s\nMedium: {:.1f} MSamples/s\nHigh: {:.1f} MSamples/s",
+			IG::Audio::Resampler::simdName(), verifyStr, mSamplesPerSec(times[0]), mSamplesPerSec(times[1]), mSamplesPerSec(times[2])));
+		resultText.compile(rendererTask.renderer(), projP);
+		times = {};
+		samples = 0;
+	}
+}
+
+struct ArchiveFile
+{
+	const char *name;
+	size_t size;
+};
+
+// fills each file with low entropy data that compresses about as well as typical content
+static std::vector<uint8_t> makeTestArchive(bool sevenZip, std::span<const ArchiveFile> files)
+{
+	size_t totalSize{};
+	for(auto &f : files) { totalSize += f.size; }
+	std::vector<uint8_t> archiveData(totalSize + (1024 * 1024));
+	size_t archiveSize{};
+	auto arch = archive_write_new();
+	if(sevenZip)
+		archive_write_set_format_7zip(arch);
+	else
+		archive_write_set_format_zip(arch);
+	archive_write_open_memory(arch, archiveData.data(), archiveData.size(), &archiveSize);
+	std::minstd_rand rng{1};
+	std::vector<uint8_t> data;
+	for(auto &f : files)
+	{
+		data.resize(f.size);
+		for(auto &b : data) { b = rng() & 0x1F; }
+		auto entry = archive_entry_new();
+		archive_entry_set_pathname(entry, f.name);
+		archive_entry_set_size(entry, f.size);
+		archive_entry_set_filetype(entry, AE_IFREG);
+		archive_entry_set_perm(entry, 0644);
+		archive_write_header(arch, entry);
+		archive_write_data(arch, data.data(), data.size());
+		archive_entry_free(entry);
+	}
+	archive_write_close(arch);
+	archive_write_free(arch);
+	archiveData.resize(archiveSize);
+	return archiveData;
+}
+
+static ArchiveEntry openTestArchive(std::span<uint8_t> archiveData)
+{
+	return ArchiveEntry{MapIO{IG::ByteBuffer{archiveData}}};
+}
+
+static ArchiveIO openEntryIO(ArchiveEntry &arch, std::string_view name)
+{
+	do
+	{
+		if(arch.name() == name)
+			return arch.moveIO();
+	} while(arch.readNextEntry());
+	return {};
+}
+
+ArchiveTest::~ArchiveTest()
+{
+	if(benchThread.joinable())
+	{
+		cancelled = true;
+		benchThread.join();
+	}
+}
+
+void ArchiveTest::initTest(IG::ApplicationContext ctx, Gfx::Renderer &r, IG::WP pixmapSize, Gfx::TextureBufferMode bufferMode)
+{
+	TextResultTest::initTest(ctx, r, pixmapSize, bufferMode);
+	benchThread = std::thread{[this, spillDir = ctx.cachePath()](){ runBenchmark(spillDir); }};
+}
+
+void ArchiveTest::runBenchmark(FS::PathString spillDir)
+{
+	using namespace std::chrono;
+	auto msecs = [](IG::Time t){ return duration<double, std::milli>{t}.count(); };
+	std::vector<uint8_t> buff(4 * 1024 * 1024);
+	// CUE/BIN image, reads of single sectors in random order
+	{
+		constexpr size_t sectorSize = 2352;
+		constexpr size_t sectors = 8192;
+		constexpr ArchiveFile files[]{{"game.cue", 512}, {"game.bin", sectorSize * sectors}};
+		auto archiveData = makeTestArchive(false, files);
+		std::minstd_rand rng{2};
+		std::vector<size_t> sectorOrder(256);
+		for(auto &s : sectorOrder) { s = rng() % sectors; }
+		constexpr size_t streamReads = 16;
+		auto streamTime = IG::timeFunc([&]()
+		{
+			auto arch = openTestArchive(archiveData);
+			auto io = openEntryIO(arch, "game.bin");
+			size_t pos{};
+			for(auto s : std::span{sectorOrder.data(), streamReads})
+			{
+				if(cancelled)
+					return;
+				auto offset = s * sectorSize;
+				if(offset < pos)
+				{
+					// no way to seek back in a compressed stream without starting over
+					arch = io.releaseArchive();
+					arch.rewind();
+					io = openEntryIO(arch, "game.bin");
+					pos = 0;
+				}
+				while(pos < offset)
+				{
+					auto bytesRead = io.read(buff.data(), std::min(buff.size(), offset - pos));
+					if(bytesRead <= 0)
+						return;
+					pos += bytesRead;
+				}
+				pos += std::max(io.read(buff.data(), sectorSize), ssize_t{});
+			}
+		});
+		IG::Time firstPassTime{}, secondPassTime{};
+		{
+			auto arch = openTestArchive(archiveData);
+			auto io = openEntryIO(arch, "game.bin");
+			io.setRandomAccess(spillDir);
+			auto readSectors = [&]()
+			{
+				for(auto s : sectorOrder)
+				{
+					io.readAtPos(buff.data(), sectorSize, s * sectorSize);
+				}
+			};
+			firstPassTime = IG::timeFunc(readSectors);
+			secondPassTime = IG::timeFunc(readSectors);
+		}
+		if(cancelled)
+			return;
+		IG::formatTo(result, "CUE/BIN zip ({}MB), ms per random sector read:\n"
+			"Rewind: {:.3f}\nRandom access: {:.3f} first pass, {:.4f} after\n",
+			files[1].size / (1024 * 1024), msecs(streamTime) / streamReads,
+			msecs(firstPassTime) / sectorOrder.size(), msecs(secondPassTime) / sectorOrder.size());
+	}
+	// Neo Geo set stored in name order, loaded in program, fix, sound, sprite order
+	{
+		constexpr ArchiveFile files[]{{"201-c1.c1", 4 * 1024 * 1024}, {"201-c2.c2", 4 * 1024 * 1024},
+			{"201-m1.m1", 128 * 1024}, {"201-p1.p1", 1024 * 1024}, {"201-s1.s1", 128 * 1024},
+			{"201-v1.v1", 2 * 1024 * 1024}};
+		constexpr std::string_view loadOrder[]{"201-p1.p1", "201-s1.s1", "201-m1.m1", "201-v1.v1", "201-c1.c1", "201-c2.c2"};
+		auto archiveData = makeTestArchive(true, files);
+		auto loadSet = [&](bool continueFromLastEntry)
+		{
+			return IG::timeFunc([&]()
+			{
+				auto arch = openTestArchive(archiveData);
+				bool entryOpened{};
+				for(auto name : loadOrder)
+				{
+					if(cancelled)
+						return;
+					if(!continueFromLastEntry || (entryOpened && !arch.readNextEntry()))
+						arch.rewind();
+					auto io = openEntryIO(arch, name);
+					if(!io)
+					{
+						arch.rewind();
+						io = openEntryIO(arch, name);
+					}
+					while(io.read(buff.data(), buff.size()) > 0) {}
+					arch = io.releaseArchive();
+					entryOpened = true;
+				}
+			});
+		};
+		auto rewindTime = loadSet(false);
+		auto continueTime = loadSet(true);
+		if(cancelled)
+			return;
+		IG::formatTo(result, "Neo Geo 7z (11MB) set load, ms:\nRewind per file: {:.1f}\nContinue from last file: {:.1f}",
+			msecs(rewindTime), msecs(continueTime));
+	}
+	resultReady.store(true, std::memory_order_release);
+}
+
+void ArchiveTest::frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime)
+{
+	ClearTest::frameUpdateTest(rendererTask, screen, frameTime);
+	if(resultShown)
+		return;
+	if(!resultReady.load(std::memory_order_acquire))
+	{
+		if(!resultText.isVisible())
+		{
+			resultText.setString("Running archive benchmark...");
+			resultText.compile(rendererTask.renderer(), projP);
+		}
+		return;
+	}
+	resultText.setString(result);
+	resultText.compile(rendererTask.renderer(), projP);
+	resultShown = true;
+}
+
+void LookupTest::initTest(IG::ApplicationContext ctx, Gfx::Renderer &r, IG::WP pixmapSize, Gfx::TextureBufferMode bufferMode)
+{
+	TextResultTest::initTest(ctx, r, pixmapSize, bufferMode);
+	std::minstd_rand rng{1};
+	palette16.resize(0x8000);
+	palette32.resize(0x8000);
+	for(auto &c : palette16) { c = rng(); }
+	for(auto &c : palette32) { c = rng(); }
+	// sized for 16-bit source & 32-bit destination pixels, filled with indexes valid for 16 entry palettes
+	srcPixels.resize(frameSize.x * frameSize.y * 2);
+	for(auto &p : srcPixels) { p = rng() % 16; }
+	destPixels.resize(frameSize.x * frameSize.y * 4);
+	std::string mismatch;
+	for(const auto &c : cases)
+	{
+		auto lookup = [&](IG::Pixmap dest, IG::Pixmap src)
+		{
+			if(c.destFormat.bytesPerPixel() == 2)
+				dest.writeLookup(std::span<const uint16_t>{palette16.data(), c.paletteSize}, src);
+			else
+				dest.writeLookup(std::span<const uint32_t>{palette32.data(), c.paletteSize}, src);
+		};
+		mismatch = verifyPixmapOp(c.name, c.srcFormat, c.destFormat, c.paletteSize, lookup);
+		if(mismatch.size())
+			break;
+	}
+	verifyStr = simdCheckResult(std::move(mismatch));
+}
+
+IG::Pixmap LookupTest::srcPixmap(const LookupCase &c)
+{
+	return {{frameSize, c.srcFormat}, srcPixels.data()};
+}
+
+IG::Pixmap LookupTest::destPixmap(const LookupCase &c)
+{
+	return {{frameSize, c.destFormat}, destPixels.data()};
+}
+
+void LookupTest::frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime)
+{
+	ClearTest::frameUpdateTest(rendererTask, screen, frameTime);
+	for(auto &c : cases)
+	{
+		auto src = srcPixmap(c);
+		auto dest = destPixmap(c);
+		if(c.destFormat.bytesPerPixel() == 2)
+		{
+			std::span<const uint16_t> pal{palette16.data(), c.paletteSize};
+			c.lookupTime += IG::timeFunc([&](){ dest.writeLookup(pal, src); });
+			c.transformTime += IG::timeFunc([&](){ dest.writeTransformed([&](auto p){ return pal[p]; }, src); });
+		}
+		else
+		{
+			std::span<const uint32_t> pal{palette32.data(), c.paletteSize};
+			c.lookupTime += IG::timeFunc([&](){ dest.writeLookup(pal, src); });
+			c.transformTime += IG::timeFunc([&](){ dest.writeTransformed([&](auto p){ return pal[p]; }, src); });
+		}
+	}
+	if(++samples == 60)
+	{
+		auto mPixelsPerSec = [&](IG::Time t)
+		{
+			double totalPixels = samples * frameSize.x * frameSize.y;
+			return totalPixels / std::chrono::duration<double>{t}.count() / 1e6;
+		};
+		std::string str{fmt::format("Palette lookup ({}), MPixels/s\n{}\n", IG::Pixmap::lookupSIMDName(), verifyStr)};
+		for(auto &c : cases)
+		{
+			IG::formatTo(str, "{}: {:.0f} (transform: {:.0f})\n", c.name,
+				mPixelsPerSec(c.lookupTime), mPixelsPerSec(c.transformTime));
+			c.lookupTime = c.transformTime = {};
+		}
+		str.pop_back();
+		resultText.setString(str);
+		resultText.compile(rendererTask.renderer(), projP);
+		samples = 0;
+	}
+}
+
+void ConvertTest::initTest(IG::ApplicationContext ctx, Gfx::Renderer &r, IG::WP pixmapSize, Gfx::TextureBufferMode bufferMode)
+{
+	TextResultTest::initTest(ctx, r, pixmapSize, bufferMode);
+	std::minstd_rand rng{1};
+	srcPixels.resize(frameSize.x * frameSize.y * 4);
+	for(auto &p : srcPixels) { p = rng(); }
+	destPixels.resize(512 * frameSize.y * 4);
+	std::string mismatch;
+	for(const auto &c : cases)
+	{
+		mismatch = verifyPixmapOp(c.name, c.srcFormat, c.destFormat, 256,
+			[](IG::Pixmap dest, IG::Pixmap src){ dest.writeConverted(src); });
+		if(mismatch.size())
+			break;
+	}
+	verifyStr = simdCheckResult(std::move(mismatch));
+}
+
+void ConvertTest::frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime)
+{
+	ClearTest::frameUpdateTest(rendererTask, screen, frameTime);
+	for(auto &c : cases)
+	{
+		IG::Pixmap src{{frameSize, c.srcFormat}, srcPixels.data()};
+		IG::Pixmap dest{{frameSize, c.destFormat}, destPixels.data(), {c.destPitchPixels, IG::Pixmap::Units::PIXEL}};
+		c.time += IG::timeFunc([&](){ dest.writeConverted(src); });
+	}
+	if(++samples == 60)
+	{
+		std::string str{fmt::format("Pixel conversion ({}), MPixels/s\n{}\n", IG::Pixmap::convertSIMDName(), verifyStr)};
+		for(auto &c : cases)
+		{
+			double totalPixels = samples * frameSize.x * frameSize.y;
+			IG::formatTo(str, "{}: {:.0f}\n", c.name, totalPixels / std::chrono::duration<double>{c.time}.count() / 1e6);
+			c.time = {};
+		}
+		str.pop_back();
+		resultText.setString(str);
+		resultText.compile(rendererTask.renderer(), projP);
+		samples = 0;
+	}
+}
+
+void AudioFormatTest::initTest(IG::ApplicationContext ctx, Gfx::Renderer &r, IG::WP pixmapSize, Gfx::TextureBufferMode bufferMode)
+{
+	TextResultTest::initTest(ctx, r, pixmapSize, bufferMode);
+	srcI16.resize(frames * 2);
+	srcF32.resize(frames * 2);
+	iterateTimes(frames, i)
+	{
+		float s = .9f * std::sin(2.f * M_PI * 1000.f * (i / 48000.f));
+		srcF32[i * 2] = srcF32[i * 2 + 1] = s;
+		srcI16[i * 2] = srcI16[i * 2 + 1] = s * 32767.f;
+	}
+	destSamples.resize(frames * 2);
+	std::string mismatch;
+	for(const auto &c : cases)
+	{
+		mismatch = verifyCopyFrames(c.name, c.srcFormat, c.destFormat, c.volume);
+		if(mismatch.size())
+			break;
+	}
+	verifyStr = simdCheckResult(std::move(mismatch));
+}
+
+void AudioFormatTest::frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime)
+{
+	ClearTest::frameUpdateTest(rendererTask, screen, frameTime);
+	for(auto &c : cases)
+	{
+		const IG::Audio::Format srcFormat{48000, c.srcFormat, 2};
+		const IG::Audio::Format destFormat{48000, c.destFormat, 2};
+		const void *src = c.srcFormat.isFloat() ? (const void*)srcF32.data() : (const void*)srcI16.data();
+		c.time += IG::timeFunc(
+			[&]()
+			{
+				iterateTimes(blocksPerFrame, b)
+				{
+					destFormat.copyFrames(destSamples.data(), src, frames, srcFormat, c.volume);
+				}
+			});
+	}
+	if(++samples == 60)
+	{
+		std::string str{fmt::format("Audio sample copy ({}), MSamples/s\n{}\n", IG::Audio::Format::simdName(), verifyStr)};
+		for(auto &c : cases)
+		{
+			double totalSamples = samples * blocksPerFrame * frames * 2;
+			IG::formatTo(str, "{}: {:.0f}\n", c.name, totalSamples / std::chrono::duration<double>{c.time}.count() / 1e6);
+			c.time = {};
+		}
+		str.pop_back();
+		resultText.setString(str);
+		resultText.compile(rendererTask.renderer(), projP);
+		samples = 0;
+	}
+}
+
+ThreadJitterTest::~ThreadJitterTest()
+{
+	if(workThread.joinable())
+	{
+		workPort.send({.exit = true});
+		workThread.join();
+	}
+}
+
+void ThreadJitterTest::initTest(IG::ApplicationContext ctx, Gfx::Renderer &r, IG::WP pixmapSize, Gfx::TextureBufferMode bufferMode)
+{
+	TextResultTest::initTest(ctx, r, pixmapSize, bufferMode);
+	auto perfMask = IG::performanceCPUMask();
+	cases.push_back({"Any CPU", {}});
+	cases.push_back({"Performance CPUs", {.cpuMask = perfMask}});
+	cases.push_back({"Performance CPUs, nice -4", {.cpuMask = perfMask, .nice = -4}});
+	cases.push_back({"Performance CPUs, FIFO", {.cpuMask = perfMask, .nice = -4, .policy = IG::ThreadPolicy::FIFO}});
+	workThread = IG::makeThreadSync(
+		[this](auto &sem)
+		{
+			workThreadId = IG::thisThreadId();
+			sem.release();
+			while(true)
+			{
+				auto msg = workPort.receive();
+				if(msg.exit)
+					return;
+				// fixed amount of dependent integer work, roughly an emulated frame
+				uint32_t x = 1;
+				iterateTimes(workIterations, i)
+				{
+					x = x * 1664525u + 1013904223u;
+				}
+				[[maybe_unused]] volatile uint32_t result = x;
+				msg.semPtr->release();
+			}
+		});
+	setCase(0);
+}
+
+void ThreadJitterTest::setCase(size_t idx)
+{
+	caseIdx = idx;
+	IG::setThreadAttributes(workThreadId, cases[idx].attrs);
+}
+
+void ThreadJitterTest::frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime)
+{
+	ClearTest::frameUpdateTest(rendererTask, screen, frameTime);
+	auto time = IG::timeFunc([&](){ workPort.send(WorkMessage{}, true); });
+	frameTimes[samples] = std::chrono::duration<double, std::milli>{time}.count();
+	if(++samples == frameTimes.size())
+	{
+		auto &result = cases[caseIdx];
+		double total{}, maxTime{};
+		for(auto t : frameTimes)
+		{
+			total += t;
+			maxTime = std::max(maxTime, t);
+		}
+		double avg = total / frameTimes.size();
+		double variance{};
+		for(auto t : frameTimes)
+		{
+			variance += (t - avg) * (t - avg);
+		}
+		result.avgTime = avg;
+		result.stdDev = std::sqrt(variance / frameTimes.size());
+		result.maxTime = maxTime;
+		result.hasResult = true;
+		std::string str{fmt::format("Worker frame time, ms avg/std dev/max ({} CPUs)\n", IG::cpuCount())};
+		for(const auto &c : cases)
+		{
+			if(c.hasResult)
+				IG::formatTo(str, "{}: {:.2f}/{:.3f}/{:.2f}\n", c.name, c.avgTime, c.stdDev, c.maxTime);
+			else
+				IG::formatTo(str, "{}: -\n", c.name);
+		}
+		str.pop_back();
+		resultText.setString(str);
+		resultText.compile(rendererTask.renderer(), projP);
+		samples = 0;
+		setCase((caseIdx + 1) % cases.size());
+	}
+}
+
 }
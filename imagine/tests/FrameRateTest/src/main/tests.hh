@@ -22,6 +22,10 @@
 #include <imagine/gfx/SyncFence.hh>
 #include <imagine/time/Time.hh>
 #include <imagine/thread/Semaphore.hh>
+#include <imagine/thread/SPSCMessagePort.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/audio/Resampler.hh>
+#include <imagine/base/MessagePort.hh>
 #include <imagine/base/ApplicationContext.hh>
 
 namespace IG
@@ -39,6 +43,13 @@ enum TestID
 	TEST_CLEAR,
 	TEST_DRAW,
 	TEST_WRITE,
+	TEST_DISPATCH,
+	TEST_RESAMPLE,
+	TEST_ARCHIVE,
+	TEST_LOOKUP,
+	TEST_CONVERT,
+	TEST_AUDIO_FORMAT,
+	TEST_THREAD_JITTER,
 };
 
 struct FramePresentTime
@@ -150,6 +161,239 @@ public:
 	void drawTest(Gfx::RendererCommands &cmds, Gfx::ClipRect bounds) override;
 };
 
+// Clear test that also shows the results of a benchmark run each frame
+class TextResultTest : public ClearTest
+{
+public:
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void placeTest(const Gfx::GCRect &rect) override;
+	void drawTest(Gfx::RendererCommands &cmds, Gfx::ClipRect bounds) override;
+
+protected:
+	Gfx::Text resultText;
+	Gfx::GCRect resultRect{};
+	std::string verifyStr{}; // outcome of checking SIMD kernels against their scalar paths, shown with the results
+};
+
+// Measures the round trip time of a message with a reply, as used when
+// running emulation frames on another thread, using the pipe-based
+// MessagePort & SPSCMessagePort.
+class DispatchTest : public TextResultTest
+{
+public:
+	~DispatchTest() override;
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime) override;
+
+protected:
+	struct DispatchMessage
+	{
+		std::binary_semaphore *semPtr{};
+		bool exit{};
+
+		explicit operator bool() const { return semPtr || exit; }
+		void setReplySemaphore(std::binary_semaphore *semPtr_) { semPtr = semPtr_; }
+	};
+
+	static constexpr unsigned burstMessages = 16;
+	IG::PipeMessagePort<DispatchMessage> pipePort{"DispatchTest Pipe"};
+	IG::SPSCMessagePort<DispatchMessage> spscPort;
+	std::thread pipeThread;
+	std::thread spscThread;
+	IG::Time pipeIdleTime{}, pipeBurstTime{};
+	IG::Time spscIdleTime{}, spscBurstTime{};
+	unsigned samples{};
+};
+
+// Measures the throughput of each Audio::Resampler quality on a frame's worth
+// of 48KHz stereo audio decimated for 2x fast-forward, after checking the SIMD
+// kernels against the scalar ones on random input.
+class ResampleTest : public TextResultTest
+{
+public:
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime) override;
+
+protected:
+	static constexpr unsigned qualities = 3;
+	static constexpr unsigned srcFrames = 800;
+	static constexpr unsigned blocksPerFrame = 8;
+	std::array<IG::Audio::Resampler, qualities> resamplers;
+	std::array<IG::Time, qualities> times{};
+	std::vector<int16_t> srcSamples;
+	std::vector<int16_t> destSamples;
+	unsigned samples{};
+};
+
+// Compares reading archive entries out of order using ArchiveIO::setRandomAccess()
+// against rewinding the archive & decompressing again, with a CUE/BIN image in a zip
+// read at random sectors & a Neo Geo set in a solid 7z opened in driver order.
+// Runs once on a worker thread since each case takes up to a few seconds.
+class ArchiveTest : public TextResultTest
+{
+public:
+	~ArchiveTest() override;
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime) override;
+
+protected:
+	std::thread benchThread;
+	std::string result;
+	std::atomic_bool resultReady{};
+	std::atomic_bool cancelled{};
+	bool resultShown{};
+
+	void runBenchmark(FS::PathString spillDir);
+};
+
+// Measures Pixmap::writeLookup() against a per-pixel writeTransformed() on a
+// 256x240 frame for each source & destination format pair, with the palette sizes
+// of typical 8-bit consoles & the 15-bit colors of the GBA, after checking the
+// SIMD kernels against the scalar path on random input.
+class LookupTest : public TextResultTest
+{
+public:
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime) override;
+
+protected:
+	struct LookupCase
+	{
+		const char *name;
+		IG::PixelFormat srcFormat;
+		IG::PixelFormat destFormat;
+		unsigned paletteSize;
+		IG::Time lookupTime{};
+		IG::Time transformTime{};
+	};
+	static constexpr IG::WP frameSize{256, 240};
+	std::array<LookupCase, 6> cases
+	{{
+		{"I8 16 -> RGB565", IG::PIXEL_FMT_I8, IG::PIXEL_FMT_RGB565, 16},
+		{"I8 16 -> RGBA8888", IG::PIXEL_FMT_I8, IG::PIXEL_FMT_RGBA8888, 16},
+		{"I8 256 -> RGB565", IG::PIXEL_FMT_I8, IG::PIXEL_FMT_RGB565, 256},
+		{"I8 256 -> RGBA8888", IG::PIXEL_FMT_I8, IG::PIXEL_FMT_RGBA8888, 256},
+		{"I16 32K -> RGB565", IG::PIXEL_FMT_RGB565, IG::PIXEL_FMT_RGB565, 0x8000},
+		{"I16 32K -> RGBA8888", IG::PIXEL_FMT_RGB565, IG::PIXEL_FMT_RGBA8888, 0x8000},
+	}};
+	std::vector<uint16_t> palette16;
+	std::vector<uint32_t> palette32;
+	std::vector<uint8_t> srcPixels;
+	std::vector<uint8_t> destPixels;
+	unsigned samples{};
+
+	IG::Pixmap srcPixmap(const LookupCase &);
+	IG::Pixmap destPixmap(const LookupCase &);
+};
+
+// Measures Pixmap::writeConverted() on a 320x240 frame for the formats used by EmuVideo,
+// including a destination with row padding as when writing into a larger texture,
+// after checking the SIMD kernels against the scalar path on random input
+class ConvertTest : public TextResultTest
+{
+public:
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime) override;
+
+protected:
+	struct ConvertCase
+	{
+		const char *name;
+		IG::PixelFormat srcFormat;
+		IG::PixelFormat destFormat;
+		int destPitchPixels;
+		IG::Time time{};
+	};
+	static constexpr IG::WP frameSize{320, 240};
+	std::array<ConvertCase, 7> cases
+	{{
+		{"RGBA8888 -> RGB565", IG::PIXEL_FMT_RGBA8888, IG::PIXEL_FMT_RGB565, frameSize.x},
+		{"RGBA8888 -> RGB565 (padded)", IG::PIXEL_FMT_RGBA8888, IG::PIXEL_FMT_RGB565, 512},
+		{"BGRA8888 -> RGB565", IG::PIXEL_FMT_BGRA8888, IG::PIXEL_FMT_RGB565, frameSize.x},
+		{"RGB565 -> RGBA8888", IG::PIXEL_FMT_RGB565, IG::PIXEL_FMT_RGBA8888, frameSize.x},
+		{"RGBA8888 -> BGRA8888", IG::PIXEL_FMT_RGBA8888, IG::PIXEL_FMT_BGRA8888, frameSize.x},
+		{"RGBA8888 -> I8", IG::PIXEL_FMT_RGBA8888, IG::PIXEL_FMT_I8, frameSize.x},
+		{"I8 -> RGB565", IG::PIXEL_FMT_I8, IG::PIXEL_FMT_RGB565, frameSize.x},
+	}};
+	std::vector<uint8_t> srcPixels;
+	std::vector<uint8_t> destPixels;
+	unsigned samples{};
+};
+
+// Measures Audio::Format::copyFrames() on a 10ms stereo block for each sample
+// conversion at full volume & with volume scaling, as done in audio callbacks,
+// after checking the SIMD kernels against the scalar path on random input
+class AudioFormatTest : public TextResultTest
+{
+public:
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime) override;
+
+protected:
+	struct CopyCase
+	{
+		const char *name;
+		IG::Audio::SampleFormat srcFormat;
+		IG::Audio::SampleFormat destFormat;
+		float volume;
+		IG::Time time{};
+	};
+	static constexpr unsigned frames = 480;
+	static constexpr unsigned blocksPerFrame = 32;
+	std::array<CopyCase, 6> cases
+	{{
+		{"i16 -> i16 (volume)", IG::Audio::SampleFormats::i16, IG::Audio::SampleFormats::i16, .5f},
+		{"f32 -> f32 (volume)", IG::Audio::SampleFormats::f32, IG::Audio::SampleFormats::f32, .5f},
+		{"i16 -> f32", IG::Audio::SampleFormats::i16, IG::Audio::SampleFormats::f32, 1.f},
+		{"i16 -> f32 (volume)", IG::Audio::SampleFormats::i16, IG::Audio::SampleFormats::f32, .5f},
+		{"f32 -> i16", IG::Audio::SampleFormats::f32, IG::Audio::SampleFormats::i16, 1.f},
+		{"f32 -> i16 (volume)", IG::Audio::SampleFormats::f32, IG::Audio::SampleFormats::i16, 1.5f},
+	}};
+	std::vector<int16_t> srcI16;
+	std::vector<float> srcF32;
+	std::vector<float> destSamples;
+	unsigned samples{};
+};
+
+// Runs a fixed workload on another thread each frame, like an emulation thread, and
+// compares how much its completion time varies with different thread attributes
+class ThreadJitterTest : public TextResultTest
+{
+public:
+	~ThreadJitterTest() override;
+	void initTest(IG::ApplicationContext, Gfx::Renderer &, IG::WP pixmapSize, Gfx::TextureBufferMode) override;
+	void frameUpdateTest(Gfx::RendererTask &rendererTask, IG::Screen &screen, IG::FrameTime frameTime) override;
+
+protected:
+	struct WorkMessage
+	{
+		std::binary_semaphore *semPtr{};
+		bool exit{};
+
+		explicit operator bool() const { return semPtr || exit; }
+		void setReplySemaphore(std::binary_semaphore *semPtr_) { semPtr = semPtr_; }
+	};
+
+	struct AttributeCase
+	{
+		const char *name;
+		IG::ThreadAttributes attrs;
+		double avgTime{}, stdDev{}, maxTime{};
+		bool hasResult{};
+	};
+
+	static constexpr unsigned workIterations = 2'000'000;
+	IG::SPSCMessagePort<WorkMessage> workPort;
+	std::thread workThread;
+	IG::ThreadId workThreadId{};
+	std::vector<AttributeCase> cases;
+	std::array<double, 60> frameTimes{};
+	size_t caseIdx{};
+	unsigned samples{};
+
+	void setCase(size_t idx);
+};
+
 const char *testIDToStr(TestID id);
 
 }